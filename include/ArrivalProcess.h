@@ -0,0 +1,165 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llmquant {
+
+/// Source of inter-arrival gaps for TokenStreamSimulator.
+///
+/// The simulator asks for one gap per emitted token and schedules the token
+/// that far after the previous deadline.  Implementations own a seeded
+/// generator, so the same seed always yields the same gap sequence; reset()
+/// rewinds to the start of it.
+///
+/// Thread safety: none; each simulator calls its process from its worker only.
+class ArrivalProcess {
+public:
+    virtual ~ArrivalProcess() = default;
+
+    /// Return the gap between the previous arrival and the next one.
+    virtual std::chrono::nanoseconds next_gap() = 0;
+
+    /// Restart the gap sequence from the seed.
+    virtual void reset() = 0;
+};
+
+/// Small deterministic generator shared by the arrival processes.
+///
+/// SplitMix64 is used instead of the <random> engines and distributions
+/// because their output is not specified identically across standard
+/// libraries; a seed here reproduces the same load on every platform.
+class ArrivalRng {
+public:
+    explicit ArrivalRng(uint64_t seed) : state_(seed) {}
+
+    /// Return the next 64 random bits.
+    uint64_t next() noexcept {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /// Return a uniform double in [0, 1).
+    double uniform() noexcept { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    /// Return an exponential variate with the given mean.
+    double exponential(double mean) noexcept;
+
+private:
+    uint64_t state_;
+};
+
+/// Metronome: every gap is the same.  Equivalent to `Config::token_interval`.
+class FixedArrivals final : public ArrivalProcess {
+public:
+    explicit FixedArrivals(std::chrono::nanoseconds interval) : interval_(interval) {}
+
+    std::chrono::nanoseconds next_gap() override { return interval_; }
+    void reset() override {}
+
+private:
+    std::chrono::nanoseconds interval_;
+};
+
+/// Poisson process: exponentially distributed gaps at a mean rate.
+class PoissonArrivals final : public ArrivalProcess {
+public:
+    /// # Arguments
+    /// * `rate_tps` — Mean arrivals per second; must be > 0.
+    /// * `seed`     — Generator seed.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `rate_tps` is not positive.
+    PoissonArrivals(double rate_tps, uint64_t seed);
+
+    std::chrono::nanoseconds next_gap() override;
+    void reset() override { rng_ = ArrivalRng(seed_); }
+
+private:
+    double     mean_gap_ns_;
+    uint64_t   seed_;
+    ArrivalRng rng_;
+};
+
+/// On/off process shaped like an LLM session: a burst of tokens (one
+/// response) at a Poisson rate, then an idle period before the next request.
+///
+/// Burst lengths are geometric with mean `mean_burst_tokens`, so responses
+/// vary in size; the idle period is fixed, like `LLMStreamClient`'s
+/// `loop_interval`.
+class BurstyArrivals final : public ArrivalProcess {
+public:
+    /// Parameters for one on/off cycle.
+    struct Params {
+        /// Token rate while a response is streaming.
+        double burst_rate_tps{30.0};
+        /// Mean tokens per response.
+        double mean_burst_tokens{200.0};
+        /// Silence between responses.
+        std::chrono::nanoseconds idle_period{std::chrono::seconds(5)};
+    };
+
+    /// # Throws
+    /// `std::invalid_argument` if the rate or mean burst length is not positive.
+    BurstyArrivals(const Params& params, uint64_t seed);
+
+    std::chrono::nanoseconds next_gap() override;
+    void reset() override;
+
+private:
+    /// Draw the length of the next burst.
+    uint64_t draw_burst();
+
+    Params     params_;
+    uint64_t   seed_;
+    ArrivalRng rng_;
+    uint64_t   remaining_{0};   ///< Tokens left in the current burst.
+};
+
+/// Replays an empirical inter-arrival distribution.
+///
+/// Gaps are drawn from a histogram: a bin is picked with probability
+/// proportional to its weight, then the gap is uniform within the bin.
+class EmpiricalArrivals final : public ArrivalProcess {
+public:
+    /// One histogram bin covering gaps in [previous bin's upper, upper).
+    struct Bin {
+        std::chrono::nanoseconds upper{0};
+        double weight{0.0};
+    };
+
+    /// # Arguments
+    /// * `bins` — Bins in ascending `upper` order; the first starts at 0.
+    /// * `seed` — Generator seed.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `bins` is empty, unsorted, or has no
+    /// positive weight.
+    EmpiricalArrivals(std::vector<Bin> bins, uint64_t seed);
+
+    /// Build a histogram of the inter-arrival gaps in a token journal.
+    ///
+    /// Gaps are taken between consecutive records of the same stream and
+    /// bucketed into power-of-two bins, so a session recorded with
+    /// `--record` can drive synthetic load of any length.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the journal cannot be read or holds fewer
+    /// than two records of any stream.
+    static std::vector<Bin> histogram_from_journal(const std::string& path);
+
+    std::chrono::nanoseconds next_gap() override;
+    void reset() override { rng_ = ArrivalRng(seed_); }
+
+private:
+    std::vector<Bin>    bins_;
+    std::vector<double> cumulative_;   ///< Running weight sum per bin.
+    uint64_t   seed_;
+    ArrivalRng rng_;
+};
+
+} // namespace llmquant
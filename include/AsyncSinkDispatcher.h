@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "OutputSink.h"
+#include "TradeSignalEngine.h"
+
+namespace llmquant {
+
+/// Moves OutputSink work off the signal path onto a dedicated I/O thread.
+///
+/// The dispatcher is itself an OutputSink: register it with an engine in
+/// place of the real sinks.  emit() copies the TradeSignal into one
+/// single-producer / single-consumer ring per wrapped sink, which costs a
+/// few stores and no formatting, virtual sink call or file I/O.  The I/O
+/// thread drains each ring in batches of up to `batch_size`, calls the
+/// wrapped sink's emit() for every signal, and flushes the sinks whenever it
+/// catches up.
+///
+/// When a sink falls behind and its ring fills, Overflow::Drop discards the
+/// new signal for that sink only (counted in SinkStats::dropped), while
+/// Overflow::Block makes emit() wait for room.  Use Block when every signal
+/// must be written, for example in backtests.
+///
+/// Thread safety: emit(), flush() and close() are the producer side and must
+/// be called from one thread at a time, typically the engine's writer thread
+/// (or after it has stopped).  stats() is safe from any thread.  The wrapped
+/// sinks are only touched by the I/O thread until close() returns.
+class AsyncSinkDispatcher : public OutputSink {
+public:
+    /// What emit() does when a sink's ring is full.
+    enum class Overflow {
+        Drop,    ///< Discard the signal for that sink; emit() never waits.
+        Block,   ///< Wait until the I/O thread makes room; lossless.
+    };
+
+    /// Construction-time parameters.
+    struct Config {
+        /// Signals buffered per sink (rounded up to a power of two).
+        size_t ring_capacity{4096};
+        /// Most signals handed to one sink per drain pass.
+        size_t batch_size{256};
+        Overflow overflow{Overflow::Drop};
+        /// I/O thread sleep once it has been idle for a while.
+        std::chrono::microseconds idle_sleep{std::chrono::microseconds{200}};
+    };
+
+    /// Per-sink counters.
+    struct SinkStats {
+        /// Signals accepted into the ring.
+        uint64_t enqueued{0};
+        /// Signals handed to the wrapped sink.
+        uint64_t written{0};
+        /// Signals discarded because the ring was full (Overflow::Drop) or
+        /// the dispatcher was closed.
+        uint64_t dropped{0};
+        /// Signals accepted but not yet written.
+        uint64_t lag{0};
+        /// Highest lag observed by the producer.
+        uint64_t max_lag{0};
+    };
+
+    /// Wrap `sinks` and start the I/O thread.
+    ///
+    /// # Arguments
+    /// * `sinks`  — Sinks to drive from the I/O thread; none may be null.
+    /// * `config` — Ring size, batching and overflow policy.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if a sink is null or `ring_capacity` or
+    /// `batch_size` is 0.
+    explicit AsyncSinkDispatcher(std::vector<std::shared_ptr<OutputSink>> sinks, Config config);
+    explicit AsyncSinkDispatcher(std::vector<std::shared_ptr<OutputSink>> sinks)
+        : AsyncSinkDispatcher(std::move(sinks), Config{}) {}
+
+    /// Drain every ring, flush the sinks and join the I/O thread.
+    ~AsyncSinkDispatcher() override;
+
+    AsyncSinkDispatcher(const AsyncSinkDispatcher&) = delete;
+    AsyncSinkDispatcher& operator=(const AsyncSinkDispatcher&) = delete;
+
+    /// Queue `sig` for every wrapped sink.
+    void emit(const TradeSignal& sig) override;
+
+    /// Wait until every signal emitted so far has been written and the
+    /// wrapped sinks have been flushed.  Returns immediately once closed.
+    void flush() override;
+
+    /// Stop accepting signals, write everything already queued, flush the
+    /// sinks and join the I/O thread.  Idempotent.
+    void close();
+
+    /// Return the number of wrapped sinks.
+    size_t sink_count() const noexcept { return lanes_.size(); }
+
+    /// Return the counters of sink `index` (in construction order).
+    ///
+    /// # Throws
+    /// `std::out_of_range` if `index >= sink_count()`.
+    SinkStats stats(size_t index) const;
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    /// One wrapped sink with its ring.  Positions and counters are split by
+    /// writer so the producer and the I/O thread never share a cache line.
+    struct Lane {
+        std::shared_ptr<OutputSink> sink;
+        std::vector<TradeSignal> slots;
+        size_t mask{0};
+        // Producer side.
+        alignas(kCacheLineSize) std::atomic<uint64_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> max_lag{0};
+        // I/O thread side.
+        alignas(kCacheLineSize) std::atomic<uint64_t> head{0};
+    };
+
+    void run();
+    /// Drain one pass over every lane; returns the number of signals written.
+    size_t drain_pass();
+
+    Config config_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::atomic<bool> closed_{false};
+    alignas(kCacheLineSize) std::atomic<uint64_t> flush_requested_{0};
+    alignas(kCacheLineSize) std::atomic<uint64_t> flush_completed_{0};
+    std::thread io_thread_;
+};
+
+/// Parse "drop" or "block".
+///
+/// # Throws
+/// `std::invalid_argument` for any other name.
+inline AsyncSinkDispatcher::Overflow parse_sink_overflow(std::string_view name) {
+    if (name == "drop")  return AsyncSinkDispatcher::Overflow::Drop;
+    if (name == "block") return AsyncSinkDispatcher::Overflow::Block;
+    throw std::invalid_argument("Unknown sink overflow policy: " + std::string(name));
+}
+
+} // namespace llmquant
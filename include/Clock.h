@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace llmquant {
+
+/// Source of "now" for components whose decisions depend on elapsed time
+/// (signal cooldown, risk rate and drawdown windows, dedup TTLs).
+///
+/// Production code uses SystemClock.  Backtests inject a ManualClock driven
+/// by recorded timestamps, so a replay makes the same decisions however fast
+/// it runs and produces identical results on every run.
+///
+/// Thread safety: now() is safe from any thread for both implementations.
+class Clock {
+public:
+    using time_point = std::chrono::high_resolution_clock::time_point;
+    using duration   = time_point::duration;
+
+    virtual ~Clock() = default;
+
+    /// Return the current time on this clock's timeline.
+    virtual time_point now() const noexcept = 0;
+};
+
+/// Wall time from std::chrono::high_resolution_clock.
+class SystemClock final : public Clock {
+public:
+    time_point now() const noexcept override { return std::chrono::high_resolution_clock::now(); }
+
+    /// Shared instance used by components constructed without a clock.
+    static const std::shared_ptr<Clock>& instance() {
+        static const std::shared_ptr<Clock> clock = std::make_shared<SystemClock>();
+        return clock;
+    }
+};
+
+/// A clock that only moves when told to.
+///
+/// Time is held as nanoseconds since the epoch of Clock::time_point; the
+/// epoch itself is arbitrary (journal timestamps are steady_clock based), so
+/// only differences between ManualClock readings are meaningful.
+class ManualClock final : public Clock {
+public:
+    explicit ManualClock(time_point start = time_point{}) noexcept : ns_(to_ns(start)) {}
+
+    time_point now() const noexcept override {
+        return time_point(std::chrono::duration_cast<duration>(
+            std::chrono::nanoseconds(ns_.load(std::memory_order_acquire))));
+    }
+
+    /// Jump to `t`, forwards or backwards.
+    void set(time_point t) noexcept { ns_.store(to_ns(t), std::memory_order_release); }
+
+    /// Jump to `ns` nanoseconds past the epoch, e.g. a journal receive time.
+    void set_ns(uint64_t ns) noexcept { ns_.store(static_cast<int64_t>(ns), std::memory_order_release); }
+
+    /// Move forward to `ns` past the epoch; earlier times are ignored, so
+    /// slightly out-of-order inputs never run the clock backwards.
+    void advance_to_ns(uint64_t ns) noexcept {
+        const auto target = static_cast<int64_t>(ns);
+        int64_t cur = ns_.load(std::memory_order_relaxed);
+        while (target > cur && !ns_.compare_exchange_weak(cur, target, std::memory_order_acq_rel)) {
+        }
+    }
+
+    /// Move forward by `d`.
+    void advance(std::chrono::nanoseconds d) noexcept { ns_.fetch_add(d.count(), std::memory_order_acq_rel); }
+
+private:
+    static int64_t to_ns(time_point t) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    std::atomic<int64_t> ns_;
+};
+
+} // namespace llmquant
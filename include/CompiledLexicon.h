@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "SemanticWeight.h"
+
+namespace llmquant {
+
+/// Transparent string hash so token maps can be probed with a
+/// std::string_view without materialising a std::string key.
+struct TransparentStringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const noexcept {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+/// Mutable token -> weight dictionary supporting heterogeneous lookup.
+using TokenWeightMap =
+    std::unordered_map<std::string, SemanticWeight, TransparentStringHash, std::equal_to<>>;
+
+/// Immutable token -> SemanticWeight table backed by a minimal perfect hash.
+///
+/// Built once from a dictionary (see LLMAdapter::freeze()).  Every key maps to
+/// exactly one of `size()` slots, so a lookup is one hash of the key, one
+/// bucket-seed load, and one compare against the slot's key — no probing, no
+/// chaining and no allocation.
+///
+/// Construction uses hash-and-displace: keys are grouped into buckets of ~4,
+/// each multi-key bucket searches for a seed that scatters its keys into free
+/// slots, and single-key buckets store their slot index directly so the table
+/// can always be filled to 100%.
+///
+/// Keys up to kInlineKeyBytes long are stored inline in the slot; longer keys
+/// live in a shared string pool.  Each slot (key + weight) occupies exactly
+/// one 64-byte cache line.
+///
+/// The table is read through raw section pointers, so it can live either in
+/// memory it built itself or directly inside a mapped binary lexicon file
+/// (see adopt() and LexiconFile.h).  Copies share the same immutable storage.
+///
+/// Thread safety: immutable after construction; find() is safe to call from
+/// any number of threads concurrently.
+class CompiledLexicon {
+public:
+    /// Maximum key length stored inline in a slot.
+    static constexpr size_t kInlineKeyBytes = 24;
+
+    /// Size of one slot (key + weight) in bytes.
+    static constexpr size_t kSlotBytes = 64;
+
+    /// The raw sections of a table, as written to a binary lexicon file.
+    struct Image {
+        uint64_t        hash_seed{0};
+        const uint32_t* bucket_seeds{nullptr};
+        size_t          bucket_count{0};
+        const void*     slots{nullptr};    ///< slot_count * kSlotBytes, 64-byte aligned.
+        size_t          slot_count{0};
+        const char*     key_pool{nullptr};
+        size_t          key_pool_bytes{0};
+    };
+
+    /// Construct an empty lexicon; every find() returns nullptr.
+    CompiledLexicon() = default;
+
+    /// Compile a lexicon from an existing token dictionary.
+    ///
+    /// # Arguments
+    /// * `entries` — Token -> weight mappings; keys are stored verbatim.
+    ///
+    /// # Throws
+    /// `std::length_error` if the dictionary has 2^31 or more entries.
+    explicit CompiledLexicon(const TokenWeightMap& entries);
+
+    CompiledLexicon(const CompiledLexicon&) = default;
+    CompiledLexicon& operator=(const CompiledLexicon&) = default;
+
+    /// Wrap an existing image in place, without copying it.
+    ///
+    /// The image is checked for internal consistency (every direct slot
+    /// index and pool reference in range) so that find() can never read
+    /// outside it; that check is a single pass and does no hashing.
+    ///
+    /// # Arguments
+    /// * `image` — Sections previously obtained from image().
+    /// * `owner` — Keeps the memory behind `image` alive for as long as
+    ///             this lexicon or any copy of it exists.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the image is inconsistent.
+    static CompiledLexicon adopt(const Image& image, std::shared_ptr<const void> owner);
+
+    /// Look up the weight registered for `key`.
+    ///
+    /// # Arguments
+    /// * `key` — Exact (already normalised) token text.
+    ///
+    /// # Returns
+    /// Pointer to the stored weight, or nullptr if `key` is not present.
+    /// The pointer remains valid for the lifetime of this lexicon.
+    const SemanticWeight* find(std::string_view key) const noexcept {
+        if (slot_count_ == 0) return nullptr;
+        const uint64_t h    = hash(key, hash_seed_);
+        const uint32_t seed = bucket_seeds_[bucket_of(h)];
+        const Slot& slot    = slots_[(seed & kDirectSlot) ? (seed & ~kDirectSlot)
+                                                           : slot_of(h, seed)];
+        if (slot.length != key.size()) return nullptr;
+        const char* stored = slot.length <= kInlineKeyBytes
+                                 ? slot.inline_key
+                                 : key_pool_ + slot.pool_offset;
+        return std::memcmp(stored, key.data(), key.size()) == 0 ? &slot.weight : nullptr;
+    }
+
+    /// Return the number of keys in the lexicon.
+    size_t size() const { return slot_count_; }
+
+    /// Return true if the lexicon holds no keys.
+    bool empty() const { return slot_count_ == 0; }
+
+    /// Return the approximate footprint of the table in bytes.
+    size_t memory_bytes() const;
+
+    /// Return the raw sections of the table; valid while this lexicon lives.
+    Image image() const noexcept;
+
+    /// Seeded 64-bit hash used for bucket and slot selection.
+    ///
+    /// # Arguments
+    /// * `key`  — Bytes to hash.
+    /// * `seed` — Per-table seed chosen at build time.
+    static uint64_t hash(std::string_view key, uint64_t seed) noexcept {
+        constexpr uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+        uint64_t h = seed ^ (static_cast<uint64_t>(key.size()) * kMul);
+        const char* p = key.data();
+        size_t n = key.size();
+        while (n >= 8) {
+            uint64_t w;
+            std::memcpy(&w, p, 8);
+            h = (h ^ w) * kMul;
+            h ^= h >> 29;
+            p += 8;
+            n -= 8;
+        }
+        if (n > 0) {
+            uint64_t w = 0;
+            std::memcpy(&w, p, n);
+            h = (h ^ w) * kMul;
+            h ^= h >> 29;
+        }
+        return mix64(h);
+    }
+
+private:
+    /// Flag bit in a bucket seed: the low 31 bits are a slot index, not a seed.
+    static constexpr uint32_t kDirectSlot = 0x80000000u;
+
+    struct alignas(64) Slot {
+        uint32_t length{0};
+        uint32_t pool_offset{0};
+        char     inline_key[kInlineKeyBytes]{};
+        SemanticWeight weight{};
+    };
+    static_assert(sizeof(Slot) == kSlotBytes, "CompiledLexicon::Slot must fill one cache line");
+
+    /// Backing store for a table built in memory.
+    struct Storage {
+        std::vector<uint32_t> bucket_seeds;
+        std::vector<Slot>     slots;
+        std::vector<char>     key_pool;
+    };
+
+    static uint64_t mix64(uint64_t x) noexcept {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /// Map the high 32 hash bits onto [0, bucket count) without a division.
+    uint32_t bucket_of(uint64_t h) const noexcept {
+        return static_cast<uint32_t>(((h >> 32) * bucket_count_) >> 32);
+    }
+
+    /// Map a (hash, seed) pair onto [0, slot count) without a division.
+    uint32_t slot_of(uint64_t h, uint32_t seed) const noexcept {
+        const uint64_t x = mix64(h ^ (static_cast<uint64_t>(seed) * 0xD6E8FEB86659FD93ULL));
+        return static_cast<uint32_t>(((x >> 32) * slot_count_) >> 32);
+    }
+
+    /// Attempt a full build with the given hash seed; false if it must be retried.
+    bool try_build(const std::vector<std::pair<std::string_view, const SemanticWeight*>>& keys,
+                   uint64_t seed, Storage& storage);
+
+    uint64_t        hash_seed_{0};
+    const uint32_t* bucket_seeds_{nullptr};
+    size_t          bucket_count_{0};
+    const Slot*     slots_{nullptr};
+    size_t          slot_count_{0};
+    const char*     key_pool_{nullptr};
+    size_t          key_pool_bytes_{0};
+    /// Owns whatever the pointers above refer to (Storage or a mapped file).
+    std::shared_ptr<const void> owner_;
+};
+
+} // namespace llmquant
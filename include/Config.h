@@ -1,9 +1,12 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <string>
 #include <thread>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace llmquant {
@@ -14,10 +17,31 @@ struct TokenStreamConfig {
     std::string data_file_path{"tokens.txt"};
     /// Interval between token emissions, in milliseconds.
     int token_interval_ms{10};
+    /// Interval between token emissions, in microseconds.  When > 0 this
+    /// overrides token_interval_ms, for rates above 1k tokens/s.
+    int token_interval_us{0};
+    /// Simulator wait strategy: "sleep", "spin", or "hybrid".
+    std::string pacing{"sleep"};
+    /// Inter-arrival model: "fixed" (or empty), "poisson", "bursty", or
+    /// "empirical".  Any other name is rejected at startup.
+    /// Poisson and bursty use the token interval as their mean in-burst gap.
+    std::string arrival_process{"fixed"};
+    /// Seed for the arrival process; equal seeds replay identical load.
+    uint64_t arrival_seed{42};
+    /// Bursty: mean tokens per simulated response.
+    double burst_tokens{200.0};
+    /// Bursty: idle time between simulated responses, in milliseconds.
+    int burst_idle_ms{5000};
+    /// Empirical: token journal whose inter-arrival histogram is sampled.
+    std::string arrival_journal_path;
     /// Maximum number of tokens held in the in-memory ring buffer.
     size_t buffer_size{1024};
     /// When true the simulator reads from an in-memory vector instead of disk.
     bool use_memory_stream{false};
+    /// Capacity of the queue merging token sources into the pipeline thread.
+    size_t ingest_queue_capacity{4096};
+    /// What a source does when that queue is full: "block", "drop_oldest" or "drop_newest".
+    std::string ingest_overflow{"block"};
 };
 
 /// Configuration for the trade signal generation subsystem.
@@ -30,6 +54,13 @@ struct TradingConfig {
     double signal_decay_rate{0.95};
     /// Minimum time that must elapse between consecutive signal emissions, in microseconds.
     int signal_cooldown_us{1000};
+    /// Time constant of elapsed-time accumulator decay, in microseconds; the
+    /// accumulators scale by exp(-dt/τ) between tokens.  0 uses signal_decay_rate.
+    int64_t decay_time_constant_us{0};
+    /// Time constants of the fast / medium / slow bias EWMAs, in milliseconds.
+    int ewma_fast_ms{100};
+    int ewma_medium_ms{1000};
+    int ewma_slow_ms{10000};
 };
 
 /// Configuration for the latency measurement and profiling subsystem.
@@ -52,6 +83,41 @@ struct LoggingConfig {
     bool enable_console{true};
     /// How often the logger should flush buffered entries to disk, in milliseconds.
     int flush_interval_ms{100};
+    /// Optional file receiving every emitted TradeSignal (NDJSON if it ends
+    /// in ".json", CSV otherwise).  Empty means none.
+    std::string signal_file_path{};
+    /// Signals buffered per sink between the engine and the sink I/O thread.
+    size_t sink_ring_capacity{4096};
+    /// What happens when a sink falls behind: "drop" or "block".
+    std::string sink_overflow{"drop"};
+};
+
+/// Configuration for the semantic dictionary used by LLMAdapter.
+struct SemanticWeightsConfig {
+    /// Optional dictionary file layered over the built-in token weights
+    /// (see LLMAdapter::reload_sentiment_dictionary).  Empty means none.
+    std::string dictionary_path{};
+    /// Scale on tokens with positive directional bias.
+    double bullish_multiplier{1.0};
+    /// Scale on tokens with negative directional bias.
+    double bearish_multiplier{1.0};
+    /// Scale on the volatility of sentiment-bearing tokens.
+    double volatility_multiplier{1.0};
+    /// Words that flip the polarity of the next sentiment-bearing token.
+    std::vector<std::string> negators{};
+    /// Word -> scale applied to the next sentiment-bearing token.
+    std::map<std::string, double> intensifiers{};
+    /// Number of tokens a negator or intensifier reaches forward.
+    int context_window{3};
+};
+
+/// Instruments the ticker extractor recognises (see TickerExtractor).
+struct SymbolsConfig {
+    /// Ticker -> extra aliases.  The ticker and its cashtag are always
+    /// recognised.  Empty routes all sentiment to one market-wide engine.
+    std::map<std::string, std::vector<std::string>> tickers{};
+    /// Number of tokens after a ticker mention attributed to that ticker.
+    int attribution_window{16};
 };
 
 /// Top-level configuration object that aggregates all subsystem configs.
@@ -60,6 +126,8 @@ struct SystemConfig {
     TradingConfig     trading;
     LatencyConfig     latency;
     LoggingConfig     logging;
+    SemanticWeightsConfig semantic_weights;
+    SymbolsConfig     symbols;
 };
 
 /// Loads, validates and exposes a SystemConfig for the entire engine.
@@ -107,11 +175,25 @@ public:
     const SystemConfig& get_config() const { return config_; }
     SystemConfig&       get_mutable_config()  { return config_; }
 
+    /// Register a callback for changes to the semantic dictionary file.
+    ///
+    /// While watching, the file named by `semantic_weights.dictionary_path`
+    /// is polled alongside the config file.  The callback runs on the
+    /// watcher thread when that file's mtime changes, or when a config
+    /// reload points `dictionary_path` at a different file or clears it.
+    /// Must be called before start_watching().
+    ///
+    /// # Arguments
+    /// * `callback` — Receives the dictionary path to (re)load; empty when
+    ///   the config no longer names a dictionary.
+    void set_dictionary_callback(std::function<void(const std::string&)> callback);
+
     /// Start watching the config file for changes and reload automatically.
     ///
     /// Spawns a background thread that polls the file's mtime every
     /// `poll_interval_ms` milliseconds. On change, reloads and invokes
-    /// `on_reload` with the new SystemConfig.
+    /// `on_reload` with the new SystemConfig.  The dictionary file is
+    /// watched too if a dictionary callback is registered.
     ///
     /// # Arguments
     /// * `filepath`         — Path to watch (same file passed to load_from_file).
@@ -128,6 +210,7 @@ private:
     SystemConfig config_;
     std::thread watcher_thread_;
     std::atomic<bool> watching_{false};
+    std::function<void(const std::string&)> on_dictionary_change_;
 };
 
 } // namespace llmquant
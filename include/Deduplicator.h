@@ -7,7 +7,12 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+
+#include "Clock.h"
+#include "TokenVocabulary.h"
 
 namespace llmquant {
 
@@ -77,6 +82,29 @@ public:
     /// * `key` — The key to remove from the live set.
     virtual void evict(const DedupKey& key) = 0;
 
+    /// Check and register an interned token.
+    ///
+    /// The default builds a DedupKey from `text` and forwards to
+    /// check_and_register(), so backends shared between processes keep
+    /// keying on content (TokenIds are process-local).  In-process backends
+    /// override this to key on `id` alone.
+    ///
+    /// # Arguments
+    /// * `id`   — TokenId from the ingestion vocabulary.
+    /// * `text` — The token's text, used only by the default implementation.
+    /// * `ttl`  — How long the token should be considered live.
+    virtual DedupResult check_and_register_id(TokenId id, std::string_view text,
+                                              std::chrono::milliseconds ttl) {
+        (void)id;
+        return check_and_register(DedupKey::from_token(std::string(text)), ttl);
+    }
+
+    /// Remove an interned token from the live set; pairs with check_and_register_id().
+    virtual void evict_id(TokenId id, std::string_view text) {
+        (void)id;
+        evict(DedupKey::from_token(std::string(text)));
+    }
+
     /// Return the number of entries currently tracked (including expired ones
     /// that have not yet been purged).
     virtual size_t size() const = 0;
@@ -87,14 +115,27 @@ public:
 
 /// In-process deduplicator backed by an unordered_map with TTL entries.
 ///
+/// Interned tokens (check_and_register_id) are tracked separately in a
+/// chunked expiry array indexed by TokenId (a TokenIdTable), so the ID path
+/// never hashes.  IDs beyond TokenIdTable's capacity, kInvalidTokenId
+/// included, fall back to the string path.  The two key spaces do not
+/// overlap: a token checked by string and later by ID counts as novel both
+/// times.
+///
 /// Memory usage is bounded by the number of unique keys seen within the
-/// configured TTL window.  purge_expired() should be called periodically
-/// (e.g. once per second) to reclaim memory.
+/// configured TTL window, plus one time point per TokenId in each 4096-ID
+/// chunk touched.  purge_expired() should be called periodically (e.g.
+/// once per second); it frees expired string keys but only clears expired
+/// IDs, since the ID array never shrinks.
 ///
 /// Thread safety: all public methods are safe to call concurrently.
 class InProcessDeduplicator : public DeduplicatorBackend {
 public:
-    explicit InProcessDeduplicator() = default;
+    /// # Arguments
+    /// * `clock` — Time source for TTL expiry; null uses steady_clock.  A
+    ///   backtest passes its ManualClock so the dedup window follows
+    ///   recorded time.
+    explicit InProcessDeduplicator(std::shared_ptr<Clock> clock = nullptr);
 
     /// Check and register a key; see DeduplicatorBackend::check_and_register.
     DedupResult check_and_register(const DedupKey& key,
@@ -103,6 +144,15 @@ public:
     /// Remove a key from the live set; see DeduplicatorBackend::evict.
     void evict(const DedupKey& key) override;
 
+    /// Check and register an interned token by ID; `text` is used only for IDs
+    /// beyond TokenIdTable capacity.
+    DedupResult check_and_register_id(TokenId id, std::string_view text,
+                                      std::chrono::milliseconds ttl) override;
+
+    /// Remove an interned token from the live set; `text` as for
+    /// check_and_register_id().
+    void evict_id(TokenId id, std::string_view text) override;
+
     /// Return the number of tracked entries (including not-yet-purged expired ones).
     size_t size() const override;
 
@@ -120,8 +170,17 @@ private:
         std::chrono::steady_clock::time_point expires_at;
     };
 
+    /// Current time on the TTL timeline (the injected clock, if any).
+    std::chrono::steady_clock::time_point now() const noexcept;
+
+    std::shared_ptr<Clock> clock_;
     mutable std::mutex mutex_;
     std::unordered_map<DedupKey, Entry> table_;
+    /// Expiry per TokenId; a default-constructed time point means "not tracked".
+    using IdExpiry = TokenIdTable<std::chrono::steady_clock::time_point>;
+    IdExpiry id_expiry_;
+    size_t id_limit_{0};     // one past the largest ID registered
+    size_t id_entries_{0};
     std::atomic<uint64_t> total_duplicates_{0};
     std::atomic<uint64_t> total_novel_{0};
 };
@@ -223,6 +282,16 @@ public:
     DedupResult check(const std::string& token,
                       const std::string& context = "");
 
+    /// Check and register an interned token using the default TTL.
+    ///
+    /// # Arguments
+    /// * `id`   — TokenId from the ingestion vocabulary.
+    /// * `text` — The token's text (see DeduplicatorBackend::check_and_register_id).
+    ///
+    /// # Returns
+    /// DedupResult::Novel or DedupResult::Duplicate.
+    DedupResult check(TokenId id, std::string_view text);
+
     /// Check and register a pre-built key with a custom TTL.
     ///
     /// # Arguments
@@ -237,6 +306,9 @@ public:
     /// * `context` — Optional context string (default: "").
     void evict(const std::string& token, const std::string& context = "");
 
+    /// Evict an interned token.
+    void evict(TokenId id, std::string_view text);
+
     /// Trigger expired-entry purge on the backend.
     void purge_expired();
 
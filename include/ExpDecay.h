@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace llmquant {
+
+/// Elapsed-time decay factor exp(-dt / τ) evaluated from a precomputed table.
+///
+/// exp(-x) is tabulated once per process at kStepsPerUnit points per unit of
+/// x over [0, kMaxExponent].  factor() splits x into a table point and a
+/// remainder r < 1/kStepsPerUnit and returns table[i] * exp(-r), with exp(-r)
+/// from a cubic Taylor polynomial: one table load and a handful of
+/// multiplies, no libm call on the hot path.  Relative error is below 3e-9,
+/// small enough that many short steps compose to the same result as one
+/// long step (a 10,000 tok/s stream decays like a 30 tok/s one).  Beyond
+/// kMaxExponent time constants the factor is 0 (exp(-16) ~ 1e-7).
+///
+/// Decaying by elapsed time rather than per token makes accumulators fade at
+/// the same real-time rate whether tokens arrive at 30/s or 10,000/s.
+///
+/// Thread safety: immutable after construction; factor() is safe from any thread.
+class ExpDecay {
+public:
+    /// Exponent beyond which the factor is treated as zero.
+    static constexpr size_t kMaxExponent  = 16;
+    /// Table points per unit of exponent.
+    static constexpr size_t kStepsPerUnit = 64;
+
+    /// Construct a disabled decay; factor() always returns 1.0.
+    ExpDecay() noexcept : table_(table().data()) {}
+
+    /// Construct a decay with time constant `tau` (the 1/e time; the
+    /// half-life is tau * ln 2).  A non-positive `tau` disables decay.
+    explicit ExpDecay(std::chrono::nanoseconds tau) noexcept
+        : table_(table().data())
+        , inv_tau_ns_(tau.count() > 0 ? static_cast<double>(kStepsPerUnit) / static_cast<double>(tau.count())
+                                      : 0.0) {}
+
+    /// Returns true if this decay has a positive time constant.
+    bool enabled() const noexcept { return inv_tau_ns_ > 0.0; }
+
+    /// Return exp(-dt / τ); 1.0 for `dt_ns <= 0` or a disabled decay.
+    double factor(int64_t dt_ns) const noexcept {
+        if (dt_ns <= 0) return 1.0;
+        const double pos = static_cast<double>(dt_ns) * inv_tau_ns_;   // x * kStepsPerUnit
+        if (pos >= static_cast<double>(kMaxExponent * kStepsPerUnit)) return 0.0;
+        const auto   i = static_cast<size_t>(pos);
+        const double r = (pos - static_cast<double>(i)) * (1.0 / kStepsPerUnit);
+        return table_[i] * (1.0 - r * (1.0 - r * (0.5 - r * (1.0 / 6.0))));
+    }
+
+    /// Convenience overload taking a chrono duration.
+    double factor(std::chrono::nanoseconds dt) const noexcept { return factor(dt.count()); }
+
+private:
+    static constexpr size_t kTableSize = kMaxExponent * kStepsPerUnit;
+
+    static const std::array<double, kTableSize>& table() {
+        static const std::array<double, kTableSize> t = [] {
+            std::array<double, kTableSize> out{};
+            for (size_t i = 0; i < kTableSize; ++i) {
+                out[i] = std::exp(-static_cast<double>(i) / static_cast<double>(kStepsPerUnit));
+            }
+            return out;
+        }();
+        return t;
+    }
+
+    const double* table_;
+    /// kStepsPerUnit / τ, so dt * inv_tau_ns_ is the table position.  Zero when disabled.
+    double inv_tau_ns_{0.0};
+};
+
+} // namespace llmquant
@@ -1,29 +1,27 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
-#include <immintrin.h>  // SSE2/AVX2 intrinsics
 
-namespace llmquant {
+#include "CompiledLexicon.h"
+#include "LexiconFile.h"
+#include "PhraseMatcher.h"
+#include "QuantizedWeight.h"
+#include "Rcu.h"
+#include "SentimentContext.h"
+#include "SemanticWeight.h"
+#include "ShardedCounters.h"
+#include "TokenVocabulary.h"
+#include "WeightKernels.h"
 
-/// Normalised semantic weight extracted from a single token or token sequence.
-///
-/// All fields are in the range [-1.0, 1.0] except confidence_score which is
-/// in [0.0, 1.0].  A fully neutral token has all fields at 0.0 except
-/// confidence_score which defaults to 0.5.
-struct SemanticWeight {
-    /// Overall sentiment polarity: negative = bearish/fearful, positive = bullish.
-    double sentiment_score{0.0};
-    /// How strongly the model believes this mapping is accurate (0 = none, 1 = certain).
-    double confidence_score{0.5};
-    /// Implied market volatility contribution (0 = calm, 1 = high volatility).
-    double volatility_score{0.0};
-    /// Directional market bias: negative = sell pressure, positive = buy pressure.
-    double directional_bias{0.0};
-};
+namespace llmquant {
 
 /// Maps raw LLM tokens to their quantitative SemanticWeight representations.
 ///
@@ -31,25 +29,150 @@ struct SemanticWeight {
 /// Additional mappings can be injected at runtime via add_token_mapping() or
 /// loaded in bulk from a tab-separated dictionary file.
 ///
-/// Thread safety: map_token_to_weight() and map_sequence_to_weight() are
-/// safe to call from multiple threads concurrently (atomic stat counters,
-/// read-only map access after initialisation).  Mutation methods
-/// (add_token_mapping, load_sentiment_dictionary) must not be called
+/// Lookups are served from a CompiledLexicon (minimal perfect hash) built by
+/// freeze().  Any mutation discards the compiled table and lookups fall back
+/// to the std::unordered_map until freeze() is called again.
+///
+/// Tokens interned in a TokenVocabulary can be scored by ID through
+/// map_token_id(), which reads a flat per-ID weight table instead of hashing
+/// the token text.  Each ID is resolved against the dictionary once, on first
+/// use.  With WeightStorage::Int16 that table holds 8-byte fixed-point
+/// QuantizedWeights instead of full SemanticWeights, so a vocabulary several
+/// times larger stays cache resident; map_id_sequence() then reduces the
+/// packed weights directly with accumulate_quantized().
+///
+/// Multi-token phrases ("short squeeze", "sell off") are matched
+/// incrementally over the ID stream by a PhraseMatcher; each stream keeps its
+/// own StreamState.  When a phrase completes, its weight replaces the weight
+/// of the completing token.
+///
+/// The same per-stream path also runs a SentimentContext: negators ("not")
+/// and intensifiers ("extremely") configured through set_context_rules()
+/// adjust the weight of the sentiment-bearing token that follows them.
+///
+/// All lookup state lives in one Lexicon object published through an
+/// RcuPtr.  reload_sentiment_dictionary() builds a complete replacement off
+/// to the side and swaps it in atomically, so the dictionary can be updated
+/// while streams are being scored.  A reload can also point at a binary
+/// lexicon compiled offline (see LexiconFile.h and tools/lexicon_compiler);
+/// that file is mapped and probed in place rather than parsed.
+///
+/// Thread safety: the read methods (map_token_to_weight, map_token_id,
+/// map_sequence_to_weight, map_sequence_simd) are safe to call from multiple
+/// threads concurrently and take no locks on the steady-state path.
+/// reload_sentiment_dictionary() and clear_sentiment_dictionary() are safe to
+/// call concurrently with readers and with each other.  The in-place mutation methods (add_token_mapping,
+/// add_phrase_mapping, load_sentiment_dictionary, freeze, bind_vocabulary,
+/// set_context_rules) are for start-up configuration and must not be called
 /// concurrently with read methods.
+///
+/// Lookup statistics are kept in per-thread, cache-line-padded shards and
+/// merged by get_stats().  Building with LLMQUANT_DISABLE_ADAPTER_STATS
+/// removes the counters from the lookup path entirely.
 class LLMAdapter {
 public:
+    /// Point-in-time totals of the lookup counters.
+    ///
+    /// Each field is summed independently, so fields may disagree by a few
+    /// in-flight lookups while other threads are scoring.
+    struct Stats {
+        uint64_t tokens_processed{0};
+        uint64_t cache_hits{0};       ///< Lookups that found a dictionary entry.
+        uint64_t cache_misses{0};     ///< Lookups that fell back to the neutral weight.
+        uint64_t phrase_matches{0};   ///< Tokens that completed a multi-token phrase.
+    };
+
+    /// Per-stream matching context for map_token_id(TokenId, StreamState&).
+    ///
+    /// Default-constructed state is the start of a stream.  A StreamState
+    /// must not be shared between concurrently processed streams.
+    struct StreamState {
+        PhraseMatcher::State phrase_state{PhraseMatcher::kRoot};
+        /// Lexicon the phrase state belongs to; a mismatch restarts matching.
+        uint64_t lexicon_generation{0};
+        /// Pending negators/intensifiers; see set_context_rules().
+        SentimentContext::State context;
+    };
+
+    /// Representation of the per-token-ID weight table.
+    enum class WeightStorage {
+        Full,    ///< SemanticWeight per ID (four doubles).
+        Int16,   ///< QuantizedWeight per ID (four Q1.15 fixed-point values).
+    };
+
     /// Construct an adapter pre-loaded with the built-in default token dictionary.
-    LLMAdapter();
+    ///
+    /// The default dictionary is frozen on construction.
+    ///
+    /// # Arguments
+    /// * `storage` — Per-ID weight representation.  Int16 trades up to
+    ///               ~1.5e-5 absolute error per field for a 4x smaller table;
+    ///               it only affects map_token_id() and map_id_sequence().
+    explicit LLMAdapter(WeightStorage storage = WeightStorage::Full);
+
+    /// Return the per-ID weight representation chosen at construction.
+    WeightStorage weight_storage() const { return storage_; }
+
+    /// Return the lookup counters merged across all threads.
+    ///
+    /// Always zero when built with LLMQUANT_DISABLE_ADAPTER_STATS.
+    Stats get_stats() const;
 
     /// Look up the SemanticWeight for a single token.
     ///
+    /// The token is trimmed and lowercased into a stack buffer (see
+    /// normalize_token()) and the resulting view is used as the lookup key
+    /// directly, so no std::string is allocated on this path.
+    ///
     /// # Arguments
-    /// * `token` — Raw token string (case-sensitive).
+    /// * `token` — Raw token text; surrounding whitespace and case are ignored.
     ///
     /// # Returns
     /// The registered SemanticWeight, or a neutral weight
     /// `{0.0, 0.5, 0.1, 0.0}` if the token is not in the dictionary.
-    SemanticWeight map_token_to_weight(const std::string& token) const;
+    SemanticWeight map_token_to_weight(std::string_view token) const;
+
+    /// Look up the SemanticWeight for an interned token.
+    ///
+    /// Steady state is one acquire load and one indexed read; the first call
+    /// for a given ID (and the first after any dictionary mutation) resolves
+    /// it through the dictionary under a lock.
+    ///
+    /// # Arguments
+    /// * `id` — An ID issued by the vocabulary passed to bind_vocabulary().
+    ///
+    /// # Returns
+    /// Same result as map_token_to_weight() on the token's text.
+    ///
+    /// # Throws
+    /// `std::logic_error` if no vocabulary is bound.
+    SemanticWeight map_token_id(TokenId id) const;
+
+    /// Look up an interned token as the next token of a stream.
+    ///
+    /// Like map_token_id(TokenId), but also advances the stream's phrase
+    /// matcher and sentiment context.  O(1) per token regardless of phrase
+    /// count or length, and allocation-free.
+    ///
+    /// # Arguments
+    /// * `id`     — Next token of the stream.
+    /// * `stream` — The stream's matching state; updated in place.
+    ///
+    /// # Returns
+    /// The weight of the longest phrase completed by this token, or the
+    /// token's own weight if none, adjusted by any negators and
+    /// intensifiers that precede it in the stream.
+    SemanticWeight map_token_id(TokenId id, StreamState& stream) const;
+
+    /// Set the vocabulary whose IDs map_token_id() accepts.
+    ///
+    /// Discards any previously resolved per-ID weights and recompiles the
+    /// phrase matcher and context rules, interning their words into
+    /// `vocabulary`.
+    ///
+    /// # Arguments
+    /// * `vocabulary` — Shared vocabulary used at ingestion.
+    void bind_vocabulary(std::shared_ptr<TokenVocabulary> vocabulary);
 
     /// Compute a confidence-weighted aggregate SemanticWeight for a token sequence.
     ///
@@ -66,6 +189,9 @@ public:
     /// Load additional token-to-weight mappings from a whitespace-delimited file.
     ///
     /// Each line must contain: `<token> <sentiment> <confidence> <volatility> <bias>`
+    /// A multi-token phrase is written double-quoted in place of `<token>`,
+    /// e.g. `"short squeeze" 0.8 0.9 0.7 0.9`, and is added as by
+    /// add_phrase_mapping().
     ///
     /// # Arguments
     /// * `filepath` — Path to the dictionary file.
@@ -81,11 +207,82 @@ public:
     /// * `weight` — SemanticWeight to associate with the token.
     void add_token_mapping(const std::string& token, const SemanticWeight& weight);
 
+    /// Insert or overwrite a multi-token phrase mapping.
+    ///
+    /// The phrase is split on whitespace; each word is matched as one token
+    /// (normalised as by map_token_to_weight()).  A single-word phrase is
+    /// equivalent to add_token_mapping().
+    ///
+    /// # Arguments
+    /// * `phrase` — Space-separated words, e.g. `"short squeeze"`.
+    /// * `weight` — SemanticWeight reported when the phrase completes.
+    void add_phrase_mapping(const std::string& phrase, const SemanticWeight& weight);
+
+    /// Install negation and intensifier rules for map_token_id(TokenId, StreamState&).
+    ///
+    /// Modifier words are interned into the bound vocabulary; if none is
+    /// bound yet they are compiled by bind_vocabulary().  Replaces any
+    /// previous rules.
+    ///
+    /// # Arguments
+    /// * `rules` — Modifier words, window and multipliers.
+    void set_context_rules(const ContextRules& rules);
+
+    /// Return the number of compiled multi-token phrases.
+    size_t phrase_count() const;
+
+    /// Atomically replace the file-backed part of the dictionary.
+    ///
+    /// Builds a new frozen lexicon from the base dictionary (defaults plus
+    /// everything added through add_token_mapping(), add_phrase_mapping()
+    /// and load_sentiment_dictionary()) overlaid with the entries in
+    /// `filepath`, then publishes it.  Entries from a previous reload that
+    /// are no longer in the file disappear.  Readers switch to the new
+    /// lexicon on their next lookup without blocking; the old one is freed
+    /// after a grace period.  Streams restart phrase matching.
+    ///
+    /// If `filepath` is a binary lexicon (detected by its magic bytes), it
+    /// is memory-mapped and its token table is used in place as the overlay:
+    /// load time is a checksum pass over the file instead of a parse and a
+    /// perfect-hash build.  Later in-place mutations change the base
+    /// dictionary only; the mapped entries keep precedence.
+    ///
+    /// Must not be called from inside a read method (e.g. a token callback
+    /// that is itself nested in a lookup).
+    ///
+    /// # Arguments
+    /// * `filepath` — Text dictionary (same format as
+    ///                load_sentiment_dictionary()) or binary lexicon.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the file cannot be opened, or if a binary
+    /// lexicon is stale or corrupt (see open_binary_lexicon()); the current
+    /// dictionary is left in place.
+    void reload_sentiment_dictionary(const std::string& filepath);
+
+    /// Atomically drop the file-backed part of the dictionary, leaving the
+    /// base dictionary; the reverse of reload_sentiment_dictionary().
+    /// Readers switch over as for a reload.
+    void clear_sentiment_dictionary();
+
+    /// Compile the current dictionary into a minimal perfect hash table.
+    ///
+    /// After this call map_token_to_weight() resolves each token with one
+    /// hash and one key compare.  Call again after any add_token_mapping()
+    /// or load_sentiment_dictionary(), both of which discard the compiled
+    /// table.
+    void freeze();
+
+    /// Returns true if lookups are currently served by the compiled table.
+    bool is_frozen() const;
+
     /// Batch-score a sequence of tokens using SIMD-accelerated aggregation.
     ///
-    /// Equivalent to map_sequence_to_weight() but the confidence-weighted
-    /// dot-product is computed using SSE2 intrinsics when four or more tokens
-    /// are present, falling back to scalar for the remainder.
+    /// Equivalent to map_sequence_to_weight() (to within floating-point
+    /// reassociation error), but tokens are resolved in chunks into
+    /// structure-of-arrays columns on the stack and reduced by
+    /// accumulate_weights(): AVX2+FMA when the CPU supports it, SSE2
+    /// otherwise.  Allocates nothing.
     ///
     /// # Arguments
     /// * `tokens` — Tokens to score; may be empty (returns zero weight).
@@ -94,21 +291,154 @@ public:
     /// Confidence-weighted aggregate SemanticWeight.
     SemanticWeight map_sequence_simd(const std::vector<std::string>& tokens) const;
 
+    /// Batch-score a sequence of interned tokens.
+    ///
+    /// The ID counterpart of map_sequence_simd(): weights come from the
+    /// per-ID table and are reduced a chunk at a time on the stack.  With
+    /// WeightStorage::Int16 the packed weights are gathered as-is and
+    /// dequantized inside the kernel.  Allocates nothing.
+    ///
+    /// # Arguments
+    /// * `ids` — Tokens to score; may be empty (returns zero weight).
+    ///
+    /// # Returns
+    /// Confidence-weighted aggregate SemanticWeight.
+    ///
+    /// # Throws
+    /// `std::logic_error` if no vocabulary is bound.
+    SemanticWeight map_id_sequence(const std::vector<TokenId>& ids) const;
+
 private:
+    /// Tokens resolved per SoA chunk in map_sequence_simd().
+    static constexpr size_t kSimdChunk = 64;
+
+    /// Weight returned for tokens not present in the dictionary.
+    static constexpr SemanticWeight kUnknownTokenWeight{0.0, 0.5, 0.1, 0.0};
+
+    /// Per-ID cache entry; `state` is published after `weight` is written.
+    struct IdWeight {
+        static constexpr uint8_t kUnresolved = 0;
+        static constexpr uint8_t kKnown      = 1;
+        static constexpr uint8_t kUnknown    = 2;
+
+        std::atomic<uint8_t> state{kUnresolved};
+        SemanticWeight weight{};
+    };
+
+    /// IdWeight for WeightStorage::Int16 (10 bytes instead of 40).
+    struct CompactIdWeight {
+        QuantizedWeight weight{};
+        std::atomic<uint8_t> state{IdWeight::kUnresolved};
+    };
+
+    /// Everything a lookup reads, published as one unit through lexicon_.
+    struct Lexicon {
+        TokenWeightMap weights;
+        /// Present only between freeze() and the next in-place mutation.
+        std::optional<CompiledLexicon> compiled;
+        /// Mapped binary lexicon overlaid on the base; probed first.
+        std::optional<CompiledLexicon> file_layer;
+        PhraseList     phrase_list;
+        PhraseMatcher  phrases;
+        /// Changes whenever `phrases` is rebuilt; see StreamState.
+        uint64_t       generation{0};
+        /// Flat TokenId -> weight tables, filled lazily; only the one
+        /// matching the adapter's WeightStorage is used.
+        mutable TokenIdTable<IdWeight>        id_weights;
+        mutable TokenIdTable<CompactIdWeight> compact_id_weights;
+        mutable std::mutex id_resolve_mutex;
+
+        /// Probe the file layer, then the compiled table (or the map), with a
+        /// normalised key.
+        const SemanticWeight* find(std::string_view normalized) const;
+
+        /// Drop every resolved per-ID weight.
+        void clear_id_weights() const;
+    };
+
     void initialize_default_mappings();
 
-    /// Scalar fallback for confidence-weighted aggregation over [begin, end).
+    /// Publish a new lexicon: the base dictionary overlaid with `file` and,
+    /// for a binary lexicon, its mapped token table.
+    void publish_overlay(DictionaryEntries file, std::optional<CompiledLexicon> file_layer);
+
+    /// Compile a phrase list against vocabulary_ (empty matcher if unbound).
+    PhraseMatcher compile_phrases(const PhraseList& phrases) const;
+
+    /// Slow path of map_token_id(): fill the slot for `id` from the dictionary.
+    const IdWeight& resolve_id(const Lexicon& lex, TokenId id) const;
+
+    /// resolve_id() for WeightStorage::Int16.
+    const CompactIdWeight& resolve_compact_id(const Lexicon& lex, TokenId id) const;
+
+    /// Return the slot for `id`, resolving it first if needed.
+    const IdWeight& id_slot(const Lexicon& lex, TokenId id) const {
+        const IdWeight* slot = lex.id_weights.find(id);
+        if (slot && slot->state.load(std::memory_order_acquire) != IdWeight::kUnresolved) {
+            return *slot;
+        }
+        return resolve_id(lex, id);
+    }
+
+    /// id_slot() for WeightStorage::Int16.
+    const CompactIdWeight& compact_id_slot(const Lexicon& lex, TokenId id) const {
+        const CompactIdWeight* slot = lex.compact_id_weights.find(id);
+        if (slot && slot->state.load(std::memory_order_acquire) != IdWeight::kUnresolved) {
+            return *slot;
+        }
+        return resolve_compact_id(lex, id);
+    }
+
+    /// Look up the dictionary weight for an ID's text (nullptr if unknown).
+    const SemanticWeight* find_id(const Lexicon& lex, TokenId id) const;
+
+    /// map_token_id() body for callers already inside an EpochGuard.
+    SemanticWeight map_token_id_in(const Lexicon& lex, TokenId id) const;
+
+    /// Turn kernel partial sums over `count` tokens into an aggregate weight.
+    static SemanticWeight finish_sums(const WeightSums& sums, size_t count);
+
+    /// Scalar reference for confidence-weighted aggregation over [begin, end).
     static SemanticWeight aggregate_scalar(const std::vector<SemanticWeight>& weights,
                                            size_t begin, size_t end);
 
-    std::unordered_map<std::string, SemanticWeight> token_weights_;
+    const WeightStorage storage_;
+
+    RcuPtr<Lexicon> lexicon_{std::make_unique<Lexicon>()};
+
+    /// Serialises all writers.  Readers never take it.
+    std::mutex writer_mutex_;
+    /// Base dictionary that reloads are layered on (writer side only).
+    TokenWeightMap base_weights_;
+    PhraseList     base_phrases_;
+    uint64_t       generation_{0};
+
+    std::shared_ptr<TokenVocabulary> vocabulary_;
+
+    /// Rules as configured, and compiled against vocabulary_.
+    ContextRules     context_rules_;
+    SentimentContext context_;
+
+    /// Indices into stats_.
+    enum StatField : size_t {
+        kTokensProcessed,
+        kCacheHits,
+        kCacheMisses,
+        kPhraseMatches,
+        kStatFieldCount,
+    };
+
+    /// Add `n` to a lookup counter; compiles to nothing when stats are disabled.
+    void count([[maybe_unused]] StatField field, [[maybe_unused]] uint64_t n = 1) const noexcept {
+#ifndef LLMQUANT_DISABLE_ADAPTER_STATS
+        stats_.add(field, n);
+#endif
+    }
 
+#ifndef LLMQUANT_DISABLE_ADAPTER_STATS
     /// Internal statistics; mutable so const query methods can update them.
-    mutable struct {
-        std::atomic<uint64_t> tokens_processed{0};
-        std::atomic<uint64_t> cache_hits{0};
-        std::atomic<uint64_t> cache_misses{0};
-    } stats_;
+    mutable ShardedCounters<kStatFieldCount> stats_;
+#endif
 };
 
 } // namespace llmquant
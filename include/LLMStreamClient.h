@@ -3,8 +3,12 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #  include <BaseTsd.h>
@@ -13,6 +17,8 @@
 
 namespace llmquant {
 
+class TokenJournalWriter;
+
 /// Streams tokens from an OpenAI-compatible chat completions endpoint.
 ///
 /// Connects over TCP to `host:port`, sends an HTTP/1.1 POST with
@@ -31,6 +37,17 @@ public:
     /// Called once per decoded token delta.
     using TokenCallback = std::function<void(const std::string& token)>;
 
+    /// One decoded token delivered to a TokenBatchCallback.
+    struct ReceivedToken {
+        /// Decoded delta text; valid only during the callback.
+        std::string_view text;
+        /// Monotonic ns (see monotonic_ns()) when the bytes carrying it were read.
+        uint64_t receive_ns{0};
+    };
+
+    /// Called once per network read with every token decoded from it.
+    using TokenBatchCallback = std::function<void(std::span<const ReceivedToken> tokens)>;
+
     /// Called when the stream ends (EOF or error).
     /// `error` is empty on clean EOF, non-empty on error.
     using DoneCallback = std::function<void(const std::string& error)>;
@@ -71,6 +88,16 @@ public:
     /// * `cb` — Callable invoked once per decoded content delta token.
     void set_token_callback(TokenCallback cb);
 
+    /// Register a batch callback, used instead of the token callback.
+    ///
+    /// All deltas decoded from one socket read are handed over in a single
+    /// call, so dispatch cost is paid per read rather than per token.  Each
+    /// token carries its own receive timestamp.  Must be set before connect().
+    ///
+    /// # Arguments
+    /// * `cb` — Callable invoked once per read that yields at least one token.
+    void set_batch_callback(TokenBatchCallback cb);
+
     /// Register the done callback.
     ///
     /// # Arguments
@@ -78,6 +105,17 @@ public:
     ///          clean EOF, non-empty on socket or protocol error.
     void set_done_callback(DoneCallback cb);
 
+    /// Record every received token to `journal` (must be set before connect()).
+    ///
+    /// Each token is journaled with the monotonic time its bytes came off the
+    /// socket, before the token callback runs, so the journal captures the
+    /// network arrival pattern rather than downstream processing time.
+    ///
+    /// # Arguments
+    /// * `journal`   — Shared writer; pass nullptr to stop recording.
+    /// * `stream_id` — ID stored with this client's records.
+    void set_journal(std::shared_ptr<TokenJournalWriter> journal, uint32_t stream_id = 0);
+
     /// Open the TCP connection and start the background reader thread.
     ///
     /// Returns false immediately if already connected or if the socket
@@ -146,7 +184,10 @@ private:
 
     Config          config_;
     TokenCallback   token_cb_;
+    TokenBatchCallback batch_cb_;
     DoneCallback    done_cb_;
+    std::shared_ptr<TokenJournalWriter> journal_;
+    uint32_t        journal_stream_id_{0};
     std::atomic<bool> running_{false};
     std::thread     thread_;
     int             sockfd_{-1};
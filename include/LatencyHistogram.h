@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace llmquant {
+
+/// Fixed-bucket, log-linear histogram of nanosecond durations.
+///
+/// Each power-of-two range [2^e, 2^(e+1)) is split into kSubBuckets linear
+/// buckets, so any recorded value is reported to within 1/kSubBuckets
+/// (~3%) of its true value, from 1 ns up to 2^64 ns, in a fixed ~15 KB
+/// array.  Values below kSubBuckets are exact.
+///
+/// record() is a handful of integer ops and one relaxed fetch_add (a CAS
+/// only when a new maximum is set); it never allocates or locks.
+/// Percentile queries scan the buckets and belong on the reporting path.
+///
+/// Thread safety: record() is safe from any number of threads; queries may
+/// run concurrently with recording and see some prefix of the samples.
+class LatencyHistogram {
+public:
+    /// Log2 of the linear buckets per power of two.
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets    = uint64_t{1} << kSubBucketBits;
+    static constexpr size_t   kBucketCount   = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    /// Point-in-time summary; all durations in nanoseconds.
+    struct Summary {
+        uint64_t count{0};
+        uint64_t p50_ns{0};
+        uint64_t p99_ns{0};
+        uint64_t p999_ns{0};
+        uint64_t max_ns{0};
+    };
+
+    /// Record `n` samples of `value_ns`.
+    void record(uint64_t value_ns, uint64_t n = 1) noexcept {
+        counts_[bucket_of(value_ns)].fetch_add(n, std::memory_order_relaxed);
+        uint64_t seen = max_ns_.load(std::memory_order_relaxed);
+        while (value_ns > seen &&
+               !max_ns_.compare_exchange_weak(seen, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// Record a std::chrono duration; negative durations count as 0.
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> d, uint64_t n = 1) noexcept {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(ns > 0 ? static_cast<uint64_t>(ns) : 0, n);
+    }
+
+    /// Return the number of recorded samples.
+    uint64_t count() const noexcept;
+
+    /// Return the largest recorded value exactly (not bucketed).
+    uint64_t max() const noexcept { return max_ns_.load(std::memory_order_relaxed); }
+
+    /// Return the value at quantile `q` in [0, 1]: the upper edge of the
+    /// bucket holding the q-th sample, capped at max().  0 if empty.
+    uint64_t percentile(double q) const noexcept;
+
+    /// Return count, p50, p99, p99.9 and max in one pass over the buckets.
+    Summary summary() const noexcept;
+
+    /// Drop every sample.  Not atomic with respect to concurrent record().
+    void reset() noexcept;
+
+    /// Map a value to its bucket index.
+    static constexpr size_t bucket_of(uint64_t v) noexcept {
+        if (v < kSubBuckets) return static_cast<size_t>(v);
+        const unsigned exp = static_cast<unsigned>(std::bit_width(v)) - 1;   // >= kSubBucketBits
+        const unsigned shift = exp - kSubBucketBits;
+        return static_cast<size_t>((uint64_t{shift + 1} << kSubBucketBits) + ((v >> shift) - kSubBuckets));
+    }
+
+    /// Return the largest value that maps to bucket `i`.
+    static constexpr uint64_t bucket_upper(size_t i) noexcept {
+        if (i < kSubBuckets) return i;
+        const unsigned shift = static_cast<unsigned>(i >> kSubBucketBits) - 1;
+        const uint64_t sub   = kSubBuckets + (i & (kSubBuckets - 1));
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+/// Event rate over sliding windows of up to one minute.
+///
+/// Time is cut into 100 ms slots kept in a ring; add() bumps the current
+/// slot and rate() averages the most recent completed slots, so a query
+/// never sees a half-filled slot.
+///
+/// Thread safety: one writer (add) with any number of concurrent readers.
+/// A reader racing a slot rollover may miss that slot's count.
+class WindowedRate {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds kSlotWidth{100};
+    /// Longest supported window.
+    static constexpr std::chrono::seconds kMaxWindow{60};
+
+    /// Count `n` events at time `now`.
+    void add(uint64_t n, clock::time_point now = clock::now()) noexcept {
+        const int64_t epoch = epoch_of(now);
+        Slot& s = slots_[static_cast<size_t>(epoch) % kSlots];
+        if (s.epoch.load(std::memory_order_relaxed) != epoch) {
+            s.count.store(0, std::memory_order_relaxed);
+            s.epoch.store(epoch, std::memory_order_release);
+        }
+        s.count.store(s.count.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /// Return events per second over the `window` before the current slot.
+    ///
+    /// `window` is rounded down to whole slots and clamped to [100 ms, 60 s].
+    double rate(std::chrono::milliseconds window, clock::time_point now = clock::now()) const noexcept;
+
+private:
+    static constexpr size_t kSlots = static_cast<size_t>(kMaxWindow / kSlotWidth) + 1;
+
+    struct Slot {
+        std::atomic<int64_t>  epoch{-1};
+        std::atomic<uint64_t> count{0};
+    };
+
+    static int64_t epoch_of(clock::time_point t) noexcept {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()) / kSlotWidth;
+    }
+
+    std::array<Slot, kSlots> slots_{};
+};
+
+} // namespace llmquant
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CompiledLexicon.h"
+#include "SemanticWeight.h"
+
+namespace llmquant {
+
+/// Multi-token phrases as lists of words, with their weights.
+using PhraseList = std::vector<std::pair<std::vector<std::string>, SemanticWeight>>;
+
+/// The entries of one sentiment dictionary.
+struct DictionaryEntries {
+    TokenWeightMap tokens;    ///< Single-token entries, keyed verbatim.
+    PhraseList     phrases;   ///< Entries of two or more words.
+};
+
+/// A binary lexicon opened by open_binary_lexicon().
+struct BinaryLexicon {
+    CompiledLexicon tokens;   ///< Served directly from the mapped file.
+    PhraseList      phrases;
+};
+
+/// Current binary lexicon format version.  Files written with any other
+/// version are rejected by open_binary_lexicon().
+inline constexpr uint32_t kBinaryLexiconVersion = 1;
+
+/// Split `phrase` on whitespace and add it to `entries`.
+///
+/// A single word becomes a token entry, several words a phrase entry, and
+/// an all-blank phrase is ignored.  A later entry for the same key wins.
+///
+/// # Arguments
+/// * `phrase`  — Space-separated words.
+/// * `weight`  — Weight for the entry.
+/// * `entries` — Dictionary to add to.
+void add_dictionary_entry(const std::string& phrase, const SemanticWeight& weight,
+                          DictionaryEntries& entries);
+
+/// Parse a text dictionary file.
+///
+/// Each line is `<token> <sentiment> <confidence> <volatility> <bias>`; a
+/// multi-token phrase is written double-quoted in place of `<token>`.
+/// Malformed lines are skipped.
+///
+/// # Arguments
+/// * `path` — Text dictionary file.
+///
+/// # Throws
+/// `std::runtime_error` if the file cannot be opened.
+DictionaryEntries read_text_dictionary(const std::string& path);
+
+/// Compile `entries` into a binary lexicon file.
+///
+/// The file holds a 64-byte header (magic, format version, byte order,
+/// section sizes and a checksum of everything after the header), followed
+/// by the CompiledLexicon slot table, its bucket seeds, the phrase records
+/// and the string pool.  Sections are laid out so they can be used in place
+/// once mapped.  The file is written next to `path` and renamed over it, so
+/// a concurrent reader sees either the old or the new file.
+///
+/// # Arguments
+/// * `path`    — Output file.
+/// * `entries` — Dictionary to compile.
+///
+/// # Throws
+/// `std::runtime_error` if the file cannot be written.
+void write_binary_lexicon(const std::string& path, const DictionaryEntries& entries);
+
+/// Map a binary lexicon file and validate it.
+///
+/// Token lookups are served from the mapping itself; only the (small)
+/// phrase list is decoded.  The checksum pass is the only full read of the
+/// file.
+///
+/// # Arguments
+/// * `path` — File written by write_binary_lexicon().
+///
+/// # Throws
+/// `std::runtime_error` if the file cannot be mapped, is not a binary
+/// lexicon, was written with a different format version or byte order, is
+/// truncated, or fails its checksum.
+BinaryLexicon open_binary_lexicon(const std::string& path);
+
+/// Return true if `path` starts with the binary lexicon magic.
+///
+/// Only the first bytes are read; the file is not validated.  Returns false
+/// if the file cannot be opened.
+bool is_binary_lexicon(const std::string& path);
+
+} // namespace llmquant
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace llmquant {
+
+/// Read-only memory mapping of a whole file.
+///
+/// The file's pages are mapped into the address space and faulted in on
+/// first touch, so opening even a very large file costs one system call and
+/// nothing is copied.  The mapping is private and read-only; later writes to
+/// the file by other processes are not guaranteed to be visible.
+///
+/// Thread safety: immutable after construction; data() may be read from any
+/// number of threads concurrently.
+class MappedFile {
+public:
+    /// Map `path` into memory.
+    ///
+    /// # Arguments
+    /// * `path` — File to map.  An empty file yields an empty mapping.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the file cannot be opened, sized or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Return a pointer to the first byte (page aligned), or nullptr if empty.
+    const char* data() const noexcept { return data_; }
+
+    /// Return the file size in bytes.
+    size_t size() const noexcept { return size_; }
+
+    /// Return the whole file as a view.
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+    /// Hint that the mapping will be read front to back (read-ahead, early
+    /// eviction).  No-op where unsupported.
+    void advise_sequential() const noexcept;
+
+    /// Release the resident pages wholly inside [offset, offset + length).
+    ///
+    /// The bytes stay readable: touching them again faults them back in from
+    /// the file.  Used to keep resident memory bounded while streaming a
+    /// file larger than RAM.  No-op where unsupported.
+    void discard(size_t offset, size_t length) const noexcept;
+
+private:
+    const char* data_{nullptr};
+    size_t      size_{0};
+#ifdef _WIN32
+    void*       mapping_{nullptr};
+#endif
+};
+
+} // namespace llmquant
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 #include <spdlog/spdlog.h>
@@ -53,7 +54,7 @@ public:
     /// # Arguments
     /// * `token`       — The raw token string that arrived from the simulator.
     /// * `sequence_id` — Monotonically increasing sequence number of the token.
-    void log_token_received(const std::string& token, uint64_t sequence_id);
+    void log_token_received(std::string_view token, uint64_t sequence_id);
 
     /// Record a trade-signal emission event.
     ///
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include "Pacing.h"
+
+namespace llmquant {
+
+/// What MpmcQueue::push() does when the queue is full.
+enum class OverflowPolicy {
+    /// Discard the value being pushed.  Producers never wait.
+    DropNewest,
+    /// Discard the oldest queued value to make room.  Producers never wait
+    /// and the consumer always sees the most recent data.
+    DropOldest,
+    /// Wait (spin, then yield) until the consumer makes room or the queue
+    /// is closed.  Lossless; a slow consumer stalls its producers.
+    Block,
+};
+
+/// Parse "drop_newest", "drop_oldest" or "block".
+///
+/// # Throws
+/// `std::invalid_argument` for any other name.
+inline OverflowPolicy parse_overflow_policy(std::string_view name) {
+    if (name == "drop_newest") return OverflowPolicy::DropNewest;
+    if (name == "drop_oldest") return OverflowPolicy::DropOldest;
+    if (name == "block")       return OverflowPolicy::Block;
+    throw std::invalid_argument("Unknown overflow policy: " + std::string(name));
+}
+
+/// Bounded lock-free multi-producer / multi-consumer queue.
+///
+/// Every cell carries a sequence stamp that tells producers and consumers
+/// whose turn it is, so a push or pop is one CAS on the shared position plus
+/// a release store on the cell; no operation ever waits on another thread
+/// that was preempted mid-operation on a different cell.  Cells occupy a
+/// cache line each and the two positions live on their own lines, so
+/// producers, the consumer and neighbouring cells never false-share.
+///
+/// Designed as the fan-in point between several token sources (stream
+/// clients, simulators) and one pipeline thread, but any number of threads
+/// may pop.  DropOldest producers pop to make room, which is why the queue
+/// is multi-consumer.
+///
+/// Thread safety: all members are safe from any thread.
+///
+/// # Template parameters
+/// * `T` — Element type; default-constructible and copy-assignable.  Kept in
+///   place in the cell, so small trivially copyable types (e.g. Token) suit best.
+template <typename T>
+class MpmcQueue {
+    static_assert(std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>,
+                  "MpmcQueue elements must be default-constructible and copy-assignable");
+
+public:
+    static constexpr size_t kCacheLineSize = 64;
+
+    /// Create a queue holding at least `capacity` elements (rounded up to a
+    /// power of two).
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `capacity` is 0.
+    explicit MpmcQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::DropNewest)
+        : policy_(policy) {
+        if (capacity == 0) throw std::invalid_argument("MpmcQueue: capacity must be positive");
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_  = cap - 1;
+        cells_ = std::make_unique<Cell[]>(cap);
+        for (size_t i = 0; i < cap; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /// Enqueue `value` if there is room.  Never drops, waits or counts.
+    ///
+    /// # Returns
+    /// `true` if enqueued, `false` if the queue was full.
+    bool try_push(const T& value) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                                       // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);   // lost a race; retry
+            }
+        }
+    }
+
+    /// Enqueue `value`, applying the overflow policy when full.
+    ///
+    /// # Returns
+    /// `true` if `value` was enqueued; `false` if it was dropped
+    /// (DropNewest) or the queue was closed.
+    bool push(const T& value) {
+        if (closed_.load(std::memory_order_relaxed)) return false;
+        if (try_push(value)) return true;
+
+        switch (policy_) {
+        case OverflowPolicy::DropNewest:
+            dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        case OverflowPolicy::DropOldest:
+            for (;;) {
+                T victim;
+                if (try_pop(victim)) dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+                if (try_push(value)) return true;
+            }
+        case OverflowPolicy::Block:
+            for (uint32_t spins = 0;; ++spins) {
+                if (closed_.load(std::memory_order_relaxed)) return false;
+                if (spins < 64) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+                if (try_push(value)) return true;
+            }
+        }
+        return false;
+    }
+
+    /// Dequeue the oldest element into `out`.
+    ///
+    /// # Returns
+    /// `true` if an element was dequeued, `false` if the queue was empty.
+    bool try_pop(T& out) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.value;
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                                       // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Dequeue up to `out.size()` elements, oldest first.
+    ///
+    /// # Returns
+    /// Number of elements written to the front of `out`.
+    size_t pop_batch(std::span<T> out) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+        size_t n = 0;
+        while (n < out.size() && try_pop(out[n])) ++n;
+        return n;
+    }
+
+    /// Reject further pushes and release producers blocked in push().
+    /// Queued elements can still be popped.
+    void close() noexcept { closed_.store(true, std::memory_order_relaxed); }
+
+    /// Return whether close() has been called.
+    bool closed() const noexcept { return closed_.load(std::memory_order_relaxed); }
+
+    /// Return the number of elements the queue holds when full.
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    /// Return the number of queued elements; approximate under concurrency.
+    size_t size_approx() const noexcept {
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    OverflowPolicy policy() const noexcept { return policy_; }
+
+    /// Values rejected by DropNewest.
+    uint64_t dropped_newest() const noexcept { return dropped_newest_.load(std::memory_order_relaxed); }
+
+    /// Queued values evicted by DropOldest.
+    uint64_t dropped_oldest() const noexcept { return dropped_oldest_.load(std::memory_order_relaxed); }
+
+    /// Total values lost to overflow under either drop policy.
+    uint64_t dropped() const noexcept { return dropped_newest() + dropped_oldest(); }
+
+private:
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_pos_{0};
+    // Read on every operation, written only at construction and close().
+    alignas(kCacheLineSize) std::atomic<bool> closed_{false};
+    OverflowPolicy policy_;
+    size_t mask_{0};
+    std::unique_ptr<Cell[]> cells_;
+    // Bumped on every drop, i.e. under overload; kept off the line above.
+    alignas(kCacheLineSize) std::atomic<uint64_t> dropped_newest_{0};
+    std::atomic<uint64_t> dropped_oldest_{0};
+};
+
+} // namespace llmquant
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ArrivalProcess.h"
+#include "Pacing.h"
+#include "TokenArena.h"
+#include "TokenStreamSimulator.h"
+#include "TokenVocabulary.h"
+
+namespace llmquant {
+
+/// Drives many concurrent synthetic LLM sessions over one shared corpus.
+///
+/// Each of `stream_count` streams walks the corpus from its own offset
+/// (stream i starts at token i * N / stream_count) with its own sequence
+/// numbers and emission schedule.  Streams are partitioned across a pool of
+/// worker threads; a worker always emits its stream with the earliest
+/// deadline next.  Emitted Tokens carry `stream_id`, so downstream stages can
+/// be tested for cross-stream scaling.
+///
+/// The corpus is immutable while running and shared read-only by every
+/// worker; per-stream state is owned by exactly one worker and padded to its
+/// own cache line, so the emit path takes no lock and shares no writable
+/// line.  With `token_interval` 0 and no arrival factory, workers emit flat
+/// out, round-robin over their streams, without reading the clock.
+///
+/// Thread safety: the token callback is invoked concurrently from every
+/// worker and must be thread-safe.  Configure and load before start();
+/// get_stats() is safe at any time.
+class MultiStreamSimulator {
+public:
+    /// Construction-time parameters.
+    struct Config {
+        /// Number of streams; stream IDs are 0..stream_count-1.
+        uint32_t stream_count{8};
+        /// Worker threads; 0 uses std::thread::hardware_concurrency().
+        /// Never more than stream_count.
+        uint32_t worker_count{0};
+        /// Gap between consecutive tokens of one stream; 0 emits as fast as
+        /// possible.  Ignored for streams given an arrival process.
+        std::chrono::nanoseconds token_interval{std::chrono::microseconds{100}};
+        /// Wait strategy for paced streams.
+        Pacing pacing{Pacing::Hybrid};
+        /// Hybrid mode: how far ahead of each deadline to stop sleeping and spin.
+        std::chrono::nanoseconds spin_window{std::chrono::microseconds{50}};
+    };
+
+    /// Snapshot of emission counters.
+    struct Stats {
+        /// Tokens emitted across all streams since start().
+        uint64_t tokens_emitted{0};
+        /// tokens_emitted divided by time since start() (or until stop()).
+        double achieved_rate_tps{0.0};
+        /// Tokens emitted per stream, indexed by stream ID.
+        std::vector<uint64_t> per_stream;
+    };
+
+    /// Creates the arrival process for one stream (e.g. seeded by stream ID).
+    using ArrivalFactory = std::function<std::unique_ptr<ArrivalProcess>(uint32_t stream_id)>;
+
+    /// Construct a simulator with the given configuration.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `stream_count` is 0.
+    explicit MultiStreamSimulator(const Config& config);
+
+    /// Stop and join the workers.
+    ~MultiStreamSimulator();
+
+    MultiStreamSimulator(const MultiStreamSimulator&) = delete;
+    MultiStreamSimulator& operator=(const MultiStreamSimulator&) = delete;
+
+    /// Register the callback invoked for each emitted token, from any worker.
+    void set_token_callback(TokenCallback callback);
+
+    /// Give every stream its own arrival process instead of the fixed interval.
+    ///
+    /// The factory is called once per stream at start().
+    void set_arrival_factory(ArrivalFactory factory);
+
+    /// Replace the vocabulary used to intern loaded tokens.
+    void set_vocabulary(std::shared_ptr<TokenVocabulary> vocabulary);
+
+    /// Return the vocabulary emitted token IDs refer to.
+    const std::shared_ptr<TokenVocabulary>& vocabulary() const { return vocabulary_; }
+
+    /// Replace the corpus with `tokens` (copied into the arena).
+    ///
+    /// # Throws
+    /// `std::runtime_error` if called while running.
+    void load_tokens_from_memory(const std::vector<std::string>& tokens);
+
+    /// Replace the corpus with the whitespace-separated tokens of a file.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if called while running or the file cannot be read.
+    void load_tokens_from_file(const std::string& filepath);
+
+    /// Reset counters, place each stream at its corpus offset, and start the
+    /// worker pool.  No-op if already running.
+    void start();
+
+    /// Signal the workers to stop and join them.  Safe to call repeatedly.
+    void stop();
+
+    /// Return a snapshot of the emission counters.
+    Stats get_stats() const;
+
+    /// Return the number of worker threads start() launches.
+    uint32_t worker_count() const noexcept { return worker_count_; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    /// State of one stream, written only by its owning worker.
+    struct alignas(64) StreamState {
+        uint32_t id{0};
+        size_t   next{0};                 ///< Next corpus index.
+        uint64_t sequence{0};             ///< Next sequence number.
+        clock::time_point deadline;       ///< When the next token is due.
+        std::unique_ptr<ArrivalProcess> arrival;
+        std::atomic<uint64_t> emitted{0};
+    };
+
+    /// Emit streams `index`, `index + worker_count_`, ... until stopped.
+    void worker(uint32_t index);
+
+    /// Emit the next token of `s` and advance its corpus position.
+    void emit(StreamState& s);
+
+    /// Install a loaded arena as the corpus.
+    void install_corpus(TokenArena arena);
+
+    Config config_;
+    uint32_t worker_count_{1};
+    TokenCallback callback_;
+    ArrivalFactory arrival_factory_;
+    std::shared_ptr<TokenVocabulary> vocabulary_;
+    TokenArena arena_;                 // shared corpus, read-only while running
+    std::vector<TokenId> ids_;         // arena_ tokens interned into vocabulary_
+    std::vector<std::unique_ptr<StreamState>> streams_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> running_{false};
+    clock::time_point started_;
+    std::atomic<clock::rep> stopped_at_{0};   // 0 while running
+};
+
+} // namespace llmquant
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "Clock.h"
+#include "SymbolTable.h"
+#include "TradeSignalEngine.h"
+
+namespace llmquant {
+
+/// Allocator handing out cache-line-aligned storage, so a column's first
+/// element never shares a line with another allocation.
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr size_t kCacheLineSize = 64;
+
+    CacheAlignedAllocator() noexcept = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{kCacheLineSize}));
+    }
+    void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t{kCacheLineSize}); }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const noexcept { return true; }
+};
+
+/// TradeSignalEngine for many instruments at once.
+///
+/// Per-symbol accumulator state lives in a flat structure-of-arrays table
+/// indexed by SymbolId rather than in one engine object per symbol.  The
+/// table is split into shards: symbol `s` belongs to shard `s % shard_count`,
+/// and each shard owns its own cache-aligned columns and counters, so shards
+/// driven by different threads never write to the same cache line.
+///
+/// Each weight gathers the symbol's fields into a
+/// TradeSignalEngine::SignalState, runs the same SignalStep as the
+/// single-instrument engine, and scatters the result back, so the signal
+/// math cannot drift between the two engines.  Emitted signals carry their
+/// symbol.
+///
+/// Thread safety: process_semantic_weight() is single-writer per shard; calls
+/// for symbols of one shard must come from one thread at a time, while
+/// different shards may run on different threads concurrently.  The signal
+/// callback and output sinks are invoked on the calling thread, so with more
+/// than one shard thread they must be thread-safe.  get_stats() is safe from
+/// any thread.  Configuration setters, bias() and volatility() must not race
+/// with process_semantic_weight() on the shard concerned.
+class MultiSymbolSignalEngine {
+public:
+    /// Construction-time parameters.
+    struct Config {
+        /// Per-symbol sensitivities, decay and cooldown.
+        TradeSignalEngine::Config engine{};
+        /// Number of independently writable shards; typically one per worker thread.
+        size_t shard_count{1};
+    };
+
+    /// Point-in-time totals across all shards.
+    struct Stats {
+        uint64_t weights_processed{0};
+        uint64_t signals_generated{0};
+        uint64_t signals_suppressed{0};
+    };
+
+    /// Construct an engine for symbol IDs in [0, symbol_capacity).
+    ///
+    /// # Arguments
+    /// * `config`          — Engine parameters and shard count.
+    /// * `symbol_capacity` — One past the largest SymbolId that will be
+    ///   processed; usually SymbolTable::size().
+    /// * `clock`           — Time source for cooldowns and timestamps; null
+    ///   uses SystemClock.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `shard_count` or `symbol_capacity` is zero.
+    MultiSymbolSignalEngine(const Config& config, size_t symbol_capacity,
+                            std::shared_ptr<Clock> clock = nullptr);
+
+    /// Fold `weight` into `symbol`'s accumulators and emit a signal for that
+    /// symbol if its cooldown has elapsed.
+    ///
+    /// # Arguments
+    /// * `symbol` — Instrument the weight is attributed to.
+    /// * `weight` — Normalised SemanticWeight from LLMAdapter.
+    ///
+    /// # Throws
+    /// `std::out_of_range` if `symbol >= symbol_capacity()`.
+    void process_semantic_weight(SymbolId symbol, const SemanticWeight& weight);
+
+    /// Return the shard that owns `symbol`.
+    size_t shard_of(SymbolId symbol) const noexcept { return symbol % shard_count_; }
+
+    size_t shard_count() const noexcept { return shard_count_; }
+    size_t symbol_capacity() const noexcept { return symbol_capacity_; }
+
+    /// Return `symbol`'s accumulated bias (0.0 for an out-of-range ID).
+    double bias(SymbolId symbol) const noexcept;
+
+    /// Return `symbol`'s accumulated volatility (0.0 for an out-of-range ID).
+    double volatility(SymbolId symbol) const noexcept;
+
+    /// Sum the per-shard counters.
+    Stats get_stats() const noexcept;
+
+    /// Register the callback invoked when any symbol emits a signal.
+    void set_signal_callback(TradeSignalCallback callback);
+
+    /// Enable or disable realtime (cooldown-limited) mode.
+    void set_realtime_mode(bool enabled);
+
+    /// Convenience wrapper: set_backtest_mode(true) == set_realtime_mode(false).
+    void set_backtest_mode(bool enabled);
+
+    /// Register an OutputSink to receive every emitted signal.
+    void add_output_sink(std::shared_ptr<OutputSink> sink);
+
+    /// Remove all registered output sinks.
+    void clear_output_sinks();
+
+private:
+    template <typename T>
+    using Column = std::vector<T, CacheAlignedAllocator<T>>;
+
+    /// State for the symbols of one shard, indexed by `symbol / shard_count`.
+    struct alignas(64) Shard {
+        Column<double>  bias;
+        Column<double>  volatility;
+        Column<double>  confidence;
+        Column<double>  ewma_fast;
+        Column<double>  ewma_medium;
+        Column<double>  ewma_slow;
+        Column<int64_t> last_update_ns;
+        Column<int64_t> last_signal_ns;
+        // Single writer (the shard's thread); relaxed atomics so get_stats()
+        // can read them from anywhere.
+        std::atomic<uint64_t> weights_processed{0};
+        std::atomic<uint64_t> signals_generated{0};
+        std::atomic<uint64_t> signals_suppressed{0};
+    };
+
+    /// Copy slot `slot` of `shard` into a SignalState, and back.
+    static TradeSignalEngine::SignalState load(const Shard& shard, size_t slot) noexcept;
+    static void store(Shard& shard, size_t slot, const TradeSignalEngine::SignalState& state) noexcept;
+
+    void emit_signal(Shard& shard, size_t slot, const TradeSignal& signal);
+
+    TradeSignalEngine::SignalStep step_;
+    size_t shard_count_;
+    size_t symbol_capacity_;
+    std::shared_ptr<Clock> clock_;
+    std::unique_ptr<Shard[]> shards_;
+    TradeSignalCallback callback_;
+    std::atomic<bool> realtime_mode_{true};
+    std::vector<std::shared_ptr<OutputSink>> output_sinks_;
+};
+
+} // namespace llmquant
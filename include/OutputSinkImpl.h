@@ -40,7 +40,8 @@ public:
         }
         out_ << "timestamp_ns,delta_bias_shift,volatility_adjustment,"
                 "spread_modifier,confidence,latency_us,"
-                "strategy_toggle,strategy_weight\n";
+                "strategy_toggle,strategy_weight,symbol,"
+                "bias_ewma_fast,bias_ewma_medium,bias_ewma_slow\n";
         out_.flush();
     }
 
@@ -52,7 +53,11 @@ public:
              << sig.confidence << ","
              << sig.latency_us << ","
              << sig.strategy_toggle << ","
-             << sig.strategy_weight << "\n";
+             << sig.strategy_weight << ","
+             << sig.symbol << ","
+             << sig.bias_ewma_fast << ","
+             << sig.bias_ewma_medium << ","
+             << sig.bias_ewma_slow << "\n";
     }
 
     void flush() override { out_.flush(); }
@@ -85,7 +90,11 @@ public:
              << "\"confidence\":"             << sig.confidence             << ","
              << "\"latency_us\":"             << sig.latency_us             << ","
              << "\"strategy_toggle\":"        << sig.strategy_toggle        << ","
-             << "\"strategy_weight\":"        << sig.strategy_weight
+             << "\"strategy_weight\":"        << sig.strategy_weight        << ","
+             << "\"symbol\":"                 << sig.symbol                 << ","
+             << "\"bias_ewma_fast\":"         << sig.bias_ewma_fast         << ","
+             << "\"bias_ewma_medium\":"       << sig.bias_ewma_medium       << ","
+             << "\"bias_ewma_slow\":"         << sig.bias_ewma_slow
              << "}\n";
     }
 
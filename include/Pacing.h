@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  include <immintrin.h>
+#endif
+
+namespace llmquant {
+
+/// How a simulator worker waits for a token's emission deadline.
+enum class Pacing {
+    /// Sleep until the deadline.  Cheapest; each wakeup overshoots by the
+    /// scheduler's latency (~50-100 us on Linux), so short intervals are
+    /// unreachable.
+    Sleep,
+    /// Busy-wait on steady_clock.  Sub-microsecond accuracy; occupies a core.
+    Spin,
+    /// Sleep until `spin_window` before the deadline, then spin.  Near-spin
+    /// accuracy at a fraction of the CPU cost for long intervals.
+    Hybrid,
+};
+
+/// Parse "sleep", "spin" or "hybrid".
+///
+/// # Throws
+/// `std::invalid_argument` for any other name.
+inline Pacing parse_pacing(std::string_view name) {
+    if (name == "sleep")  return Pacing::Sleep;
+    if (name == "spin")   return Pacing::Spin;
+    if (name == "hybrid") return Pacing::Hybrid;
+    throw std::invalid_argument("Unknown pacing mode: " + std::string(name));
+}
+
+/// Hint to the core that the caller is in a spin-wait loop.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#endif
+}
+
+/// Wait until `deadline` using `mode`.
+///
+/// Sleeps are sliced (10 ms at most) and the wait returns early once
+/// `running` is false, so a long gap never holds up shutdown.
+///
+/// # Arguments
+/// * `deadline`    — Absolute steady_clock time to wait for.
+/// * `mode`        — Wait strategy.
+/// * `spin_window` — Hybrid only: how long before `deadline` to start spinning.
+/// * `running`     — Owner's run flag.
+void pace_until(std::chrono::steady_clock::time_point deadline, Pacing mode,
+                std::chrono::nanoseconds spin_window, const std::atomic<bool>& running);
+
+} // namespace llmquant
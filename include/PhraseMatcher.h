@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "SemanticWeight.h"
+#include "TokenVocabulary.h"
+
+namespace llmquant {
+
+/// Incremental multi-token phrase matcher (Aho-Corasick over TokenIds).
+///
+/// Phrases are sequences of interned tokens, e.g. `{"short", "squeeze"}`.
+/// The automaton is compiled at construction.  The root has a dense
+/// transition row over the tokens that occur in any phrase; every other
+/// state stores only its trie edges, sorted, plus a failure link, so memory
+/// grows with the total phrase length rather than states × alphabet.
+/// advance() follows failure links until an edge matches or the root's row
+/// answers — amortised O(1) per token, with no backtracking and no
+/// rescanning of recent tokens.  A token outside every phrase sends the
+/// matcher straight back to the root.
+///
+/// Overlapping phrases are handled: when several phrases end on the same
+/// token (`"squeeze"` and `"short squeeze"`), the longest one is reported.
+///
+/// Matching state lives with the caller (one State per token stream), so a
+/// single matcher can serve many streams concurrently.
+///
+/// Thread safety: immutable after construction; advance() is safe to call
+/// from any number of threads, each with its own State.
+class PhraseMatcher {
+public:
+    /// Position of one stream in the automaton.
+    using State = uint32_t;
+
+    /// State of a stream that has not matched any phrase prefix.
+    static constexpr State kRoot = 0;
+
+    /// A phrase to compile.
+    struct Phrase {
+        std::vector<TokenId> tokens;   ///< Token sequence; must be non-empty.
+        SemanticWeight weight;         ///< Weight reported when the phrase completes.
+    };
+
+    /// A completed phrase reported by advance().
+    struct Match {
+        SemanticWeight weight;
+        uint32_t length{0};   ///< Number of tokens in the phrase.
+    };
+
+    /// Construct an empty matcher; advance() never reports a match.
+    PhraseMatcher() = default;
+
+    /// Compile a set of phrases.
+    ///
+    /// Phrases with empty token lists are ignored.  If the same token
+    /// sequence appears twice, the later weight wins.
+    ///
+    /// # Arguments
+    /// * `phrases` — Phrases to match.
+    explicit PhraseMatcher(const std::vector<Phrase>& phrases);
+
+    /// Feed one token to a stream.
+    ///
+    /// # Arguments
+    /// * `state` — The stream's current state; updated in place.
+    /// * `id`    — The next token in the stream.
+    ///
+    /// # Returns
+    /// The longest phrase that ends at this token, or nullptr.
+    const Match* advance(State& state, TokenId id) const noexcept {
+        if (root_next_.empty()) return nullptr;
+        const uint32_t sym = id < symbol_of_.size() ? symbol_of_[id] : 0;
+        state = sym == 0 ? kRoot : step(state, sym);
+        const int32_t out = output_[state];
+        return out >= 0 ? &matches_[static_cast<size_t>(out)] : nullptr;
+    }
+
+    /// Return the number of distinct phrases compiled.
+    size_t phrase_count() const { return matches_.size(); }
+
+    /// Return the number of automaton states (including the root).
+    size_t state_count() const { return output_.size(); }
+
+private:
+    /// Goto-with-failure: the state reached from `s` on symbol `sym`.
+    State step(State s, uint32_t sym) const noexcept {
+        while (s != kRoot) {
+            const uint32_t* first = edge_symbol_.data() + edge_begin_[s];
+            const uint32_t* last  = edge_symbol_.data() + edge_begin_[s + 1];
+            const uint32_t* it    = std::lower_bound(first, last, sym);
+            if (it != last && *it == sym) return edge_target_[static_cast<size_t>(it - edge_symbol_.data())];
+            s = fail_[s];
+        }
+        return root_next_[sym];
+    }
+
+    /// TokenId -> symbol; 0 is "token not in any phrase".
+    std::vector<uint32_t> symbol_of_;
+    uint32_t alphabet_size_{0};
+    /// Root transitions, indexed by symbol.
+    std::vector<State> root_next_;
+    /// Non-root trie edges in CSR form: state s owns edges
+    /// [edge_begin_[s], edge_begin_[s + 1]), sorted by symbol.
+    std::vector<uint32_t> edge_begin_;
+    std::vector<uint32_t> edge_symbol_;
+    std::vector<State> edge_target_;
+    /// Per state: longest proper suffix that is also a trie state.
+    std::vector<State> fail_;
+    /// Per state: index into matches_ of the longest phrase ending here, or -1.
+    std::vector<int32_t> output_;
+    std::vector<Match> matches_;
+};
+
+} // namespace llmquant
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "SemanticWeight.h"
+
+namespace llmquant {
+
+/// SemanticWeight packed into four signed Q1.15 fixed-point fields (8 bytes).
+///
+/// Each field holds round(x * kQuantScale) for x clamped to [-1.0, 1.0], so
+/// the representation error is at most 0.5 / kQuantScale (~1.5e-5) per
+/// field — far below the resolution of any dictionary weight.  Four of these
+/// fit in the space of one SemanticWeight, which keeps large per-token
+/// weight tables inside the cache.
+///
+/// The aggregation kernels (accumulate_quantized()) consume this layout
+/// directly and dequantize in registers.
+struct alignas(8) QuantizedWeight {
+    int16_t sentiment{0};
+    int16_t confidence{0};
+    int16_t volatility{0};
+    int16_t bias{0};
+};
+static_assert(sizeof(QuantizedWeight) == 8, "QuantizedWeight must pack into 8 bytes");
+
+/// Fixed-point scale: the stored integer for 1.0.
+inline constexpr double kQuantScale = 32767.0;
+
+/// Convert one field to fixed point, clamping to [-1.0, 1.0].
+inline int16_t quantize_field(double x) {
+    return static_cast<int16_t>(std::lround(std::clamp(x, -1.0, 1.0) * kQuantScale));
+}
+
+/// Pack a SemanticWeight into fixed point.
+inline QuantizedWeight quantize_weight(const SemanticWeight& w) {
+    return QuantizedWeight{quantize_field(w.sentiment_score), quantize_field(w.confidence_score),
+                           quantize_field(w.volatility_score), quantize_field(w.directional_bias)};
+}
+
+/// Expand a fixed-point weight back into a SemanticWeight.
+inline SemanticWeight dequantize_weight(const QuantizedWeight& q) {
+    constexpr double kInv = 1.0 / kQuantScale;
+    return SemanticWeight{q.sentiment * kInv, q.confidence * kInv,
+                          q.volatility * kInv, q.bias * kInv};
+}
+
+} // namespace llmquant
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace llmquant {
+
+/// Read-side critical section for epoch-based reclamation.
+///
+/// While an EpochGuard is alive on a thread, no object retired through
+/// rcu_synchronize() after the guard was entered will be freed.  Entering
+/// and leaving a guard is wait-free: a load of the global epoch and a store
+/// to this thread's reader slot.  Guards nest; only the outermost one
+/// touches the slot.
+///
+/// Readers must not block on a writer while holding a guard, and must not
+/// hold a guard indefinitely (writers wait for it in rcu_synchronize()).
+class EpochGuard {
+public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+/// Block until every EpochGuard entered before this call has been left.
+///
+/// Called by writers after unpublishing an object and before freeing it.
+/// Guards entered after the call starts do not delay it.
+void rcu_synchronize();
+
+/// Pointer to an immutable object that can be swapped while readers use it.
+///
+/// Readers call load() inside an EpochGuard and may use the returned object
+/// until the guard ends, without taking any lock.  Writers publish a
+/// replacement with store(), which waits out a grace period before deleting
+/// the previous object.
+///
+/// Thread safety: load() is safe from any thread inside a guard.  store()
+/// calls must be serialised by the caller.
+template <typename T>
+class RcuPtr {
+public:
+    explicit RcuPtr(std::unique_ptr<T> initial) : ptr_(initial.release()) {}
+    ~RcuPtr() { delete ptr_.load(std::memory_order_relaxed); }
+
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    /// Return the current object.  Only valid while an EpochGuard is held
+    /// (or from the single writer).
+    T* load() const noexcept { return ptr_.load(std::memory_order_seq_cst); }
+
+    /// Publish `next` and free the previous object once no reader can see it.
+    ///
+    /// Blocks for one grace period; never call while holding an EpochGuard.
+    void store(std::unique_ptr<T> next) {
+        T* old = ptr_.exchange(next.release(), std::memory_order_seq_cst);
+        rcu_synchronize();
+        delete old;
+    }
+
+private:
+    std::atomic<T*> ptr_;
+};
+
+} // namespace llmquant
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <string>
 #include <vector>
+#include "Clock.h"
 #include "TradeSignalEngine.h"
 
 namespace llmquant {
@@ -37,13 +38,19 @@ public:
         /// Maximum number of signals allowed per second (rate limit).
         size_t max_signals_per_second{100};
 
-        /// Cumulative bias drawdown limit: if |sum of bias shifts| exceeds
-        /// this value within the drawdown window, signals are halted.
+        /// Cumulative bias drawdown limit: if |sum of bias shifts| for one
+        /// symbol exceeds this value within the drawdown window, that
+        /// symbol's signals are halted.
         double max_drawdown{5.0};
 
         /// Duration over which drawdown is measured before resetting.
         std::chrono::seconds drawdown_window{60};
 
+        /// One past the largest SymbolId accepted, usually SymbolTable::size();
+        /// signals for other symbols are blocked.  Drawdown state is sized
+        /// from it once, at construction.
+        size_t symbol_capacity{1};
+
         /// Fraction of position_limit at which a limit-approach warning is fired
         /// (e.g. 0.8 = fire callback when |projected_position| > 80% of limit).
         double position_warn_fraction{0.8};
@@ -70,13 +77,19 @@ public:
         std::atomic<uint64_t> signals_blocked_rate{0};
         std::atomic<uint64_t> signals_blocked_drawdown{0};
         std::atomic<uint64_t> signals_blocked_position{0};
+        std::atomic<uint64_t> signals_blocked_symbol{0};
     };
 
     /// Alert callback type: invoked synchronously when a signal is blocked.
     using AlertCallback = std::function<void(const std::string& reason, const TradeSignal&)>;
 
     /// Construct a RiskManager with the given parameters.
-    explicit RiskManager(const Config& config);
+    ///
+    /// # Arguments
+    /// * `config` — Risk limits.
+    /// * `clock`  — Time source for the rate and drawdown windows; null uses
+    ///   SystemClock.  Share the engine's clock in backtests.
+    explicit RiskManager(const Config& config, std::shared_ptr<Clock> clock = nullptr);
 
     /// Evaluate a signal against all risk rules.
     ///
@@ -129,18 +142,19 @@ private:
     bool check_and_notify_position(const TradeSignal& signal);
 
     Config        config_;
+    std::shared_ptr<Clock> clock_;
     AlertCallback alert_cb_;
     OmsCallback   oms_cb_;
     PositionState position_;
     mutable std::mutex mutex_;
 
     // Rate limiting.
-    std::chrono::high_resolution_clock::time_point rate_window_start_;
+    Clock::time_point rate_window_start_;
     size_t signals_in_window_{0};
 
-    // Drawdown tracking.
-    std::chrono::high_resolution_clock::time_point drawdown_window_start_;
-    double cumulative_bias_{0.0};
+    // Drawdown tracking, per symbol (indexed by SymbolId, symbol_capacity entries).
+    Clock::time_point drawdown_window_start_;
+    std::vector<double> cumulative_bias_;
 
     Stats stats_;
 };
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace llmquant {
+
+/// Normalised semantic weight extracted from a single token or token sequence.
+///
+/// All fields are in the range [-1.0, 1.0] except confidence_score which is
+/// in [0.0, 1.0].  A fully neutral token has all fields at 0.0 except
+/// confidence_score which defaults to 0.5.
+struct SemanticWeight {
+    /// Overall sentiment polarity: negative = bearish/fearful, positive = bullish.
+    double sentiment_score{0.0};
+    /// How strongly the model believes this mapping is accurate (0 = none, 1 = certain).
+    double confidence_score{0.5};
+    /// Implied market volatility contribution (0 = calm, 1 = high volatility).
+    double volatility_score{0.0};
+    /// Directional market bias: negative = sell pressure, positive = buy pressure.
+    double directional_bias{0.0};
+};
+
+} // namespace llmquant
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SemanticWeight.h"
+#include "TokenVocabulary.h"
+
+namespace llmquant {
+
+/// Modifier words and scaling applied by SentimentContext.
+///
+/// Mirrors the modifier keys of the `semantic_weights` config section.
+struct ContextRules {
+    /// Words that flip the polarity of the next sentiment-bearing token
+    /// ("not bullish" scores as bearish).  Two negators cancel.
+    std::vector<std::string> negators;
+    /// Words that scale the next sentiment-bearing token, with their factor
+    /// ("extremely" 1.6, "slightly" 0.5).  Several intensifiers multiply.
+    std::vector<std::pair<std::string, double>> intensifiers;
+    /// How many tokens back a modifier still reaches the sentiment token;
+    /// clamped to [1, SentimentContext::kMaxWindow].
+    size_t window{3};
+    /// Scale on sentiment and bias of tokens with positive directional bias.
+    double bullish_multiplier{1.0};
+    /// Scale on sentiment and bias of tokens with negative directional bias.
+    double bearish_multiplier{1.0};
+    /// Scale on the volatility of every sentiment-bearing token.
+    double volatility_multiplier{1.0};
+};
+
+/// Streaming negation/intensifier state machine over token IDs.
+///
+/// Each stream keeps a State holding the modifiers seen among its last
+/// `window` tokens in a fixed ring.  Modifier tokens and neutral tokens are
+/// pushed into the ring; the next sentiment-bearing token (non-zero
+/// sentiment or directional bias) consumes every modifier still in the ring,
+/// has its weight adjusted, and clears the ring.  Cost per token is one
+/// table load plus at most kMaxWindow ring reads, and nothing is allocated.
+///
+/// Thread safety: apply() is safe to call concurrently with distinct States.
+/// compile() must not run concurrently with apply().
+class SentimentContext {
+public:
+    /// Largest supported modifier window.
+    static constexpr size_t kMaxWindow = 8;
+
+    /// What a token does to the sentiment token that follows it.
+    struct Modifier {
+        static constexpr uint8_t kNone        = 0;
+        static constexpr uint8_t kNegator     = 1;
+        static constexpr uint8_t kIntensifier = 2;
+
+        float   scale{1.0f};
+        uint8_t kind{kNone};
+    };
+
+    /// Per-stream context.  Default-constructed state is the start of a stream.
+    struct State {
+        std::array<Modifier, kMaxWindow> recent{};
+        uint8_t head{0};
+    };
+
+    /// Construct an inactive context; apply() returns weights unchanged.
+    SentimentContext() = default;
+
+    SentimentContext(const SentimentContext&) = delete;
+    SentimentContext& operator=(const SentimentContext&) = delete;
+
+    /// Compile `rules` against `vocabulary`, interning every modifier word.
+    ///
+    /// Replaces any previously compiled rules.
+    ///
+    /// # Arguments
+    /// * `rules`      — Modifier words and multipliers.
+    /// * `vocabulary` — Vocabulary the stream's token IDs come from.
+    void compile(const ContextRules& rules, TokenVocabulary& vocabulary);
+
+    /// Drop all rules; apply() becomes a no-op.
+    void clear();
+
+    /// Returns true if compile() installed any modifier or multiplier.
+    bool active() const { return active_; }
+
+    /// Feed one token of a stream and return its context-adjusted weight.
+    ///
+    /// # Arguments
+    /// * `state`  — The stream's context; updated in place.
+    /// * `id`     — The token.
+    /// * `weight` — The token's dictionary (or phrase) weight.
+    ///
+    /// # Returns
+    /// `weight` with pending negations and intensifiers applied, then the
+    /// directional and volatility multipliers, clamped to SemanticWeight's
+    /// ranges.  Modifier and neutral tokens are returned unchanged.
+    SemanticWeight apply(State& state, TokenId id, const SemanticWeight& weight) const noexcept {
+        if (!active_) return weight;
+
+        const Modifier* m = modifiers_.find(id);
+        const bool bearing = weight.sentiment_score != 0.0 || weight.directional_bias != 0.0;
+        if ((m && m->kind != Modifier::kNone) || !bearing) {
+            state.recent[state.head] = m ? *m : Modifier{};
+            state.head = static_cast<uint8_t>(state.head + 1 >= window_ ? 0 : state.head + 1);
+            return weight;
+        }
+        return consume(state, weight);
+    }
+
+private:
+    /// Apply and clear the ring for a sentiment-bearing token.
+    SemanticWeight consume(State& state, const SemanticWeight& weight) const noexcept;
+
+    TokenIdTable<Modifier> modifiers_;
+    uint8_t window_{3};
+    double bullish_multiplier_{1.0};
+    double bearish_multiplier_{1.0};
+    double volatility_multiplier_{1.0};
+    bool active_{false};
+};
+
+} // namespace llmquant
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Pacing.h"
+
+namespace llmquant {
+
+/// Single-writer sequence lock publishing a small trivially copyable value.
+///
+/// The writer bumps a sequence counter to odd, stores the value, and bumps it
+/// back to even; it never waits for readers and performs no read-modify-write.
+/// A reader copies the value between two loads of the counter and retries if
+/// a write was in progress or completed in between, so every value it returns
+/// was published whole by one write() call.
+///
+/// The payload is held as relaxed 64-bit atomic words rather than raw bytes,
+/// so the concurrent copy is a well-defined C++ data access rather than a
+/// tolerated race.
+///
+/// Thread safety: write() must only be called from one thread at a time;
+/// read() and sequence() are safe from any number of threads.
+///
+/// # Template parameters
+/// * `T` — Value type; trivially copyable and default-constructible.
+template <typename T>
+class SeqLock {
+public:
+    /// Construct holding a default-constructed T.
+    SeqLock() noexcept {
+        // Checked here rather than at class scope so T may be a nested type
+        // of the class that holds the SeqLock.
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+        static_assert(std::is_default_constructible_v<T>, "SeqLock payload must be default-constructible");
+        store_words(T{});
+    }
+
+    /// Publish `value` (writer thread only).
+    void write(const T& value) noexcept {
+        const uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store_words(value);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Return the most recently published value.
+    ///
+    /// Spins (with cpu_relax()) only while a write is in progress.
+    T read() const noexcept {
+        std::array<uint64_t, kWords> copy;
+        while (true) {
+            const uint64_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                cpu_relax();
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) copy[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) break;
+        }
+        T out;
+        std::memcpy(static_cast<void*>(&out), copy.data(), sizeof(T));   // T is trivially copyable
+        return out;
+    }
+
+    /// Return the number of completed writes.
+    uint64_t sequence() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    void store_words(const T& value) noexcept {
+        std::array<uint64_t, kWords> copy{};
+        std::memcpy(copy.data(), &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) words_[i].store(copy[i], std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> seq_{0};
+    std::array<std::atomic<uint64_t>, kWords> words_{};
+};
+
+} // namespace llmquant
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace llmquant {
+
+/// Small per-thread index, assigned round-robin on a thread's first call.
+///
+/// Used to spread hot counters over shards; two threads may share an index
+/// once more threads exist than shards.
+inline uint32_t this_thread_shard_hint() noexcept {
+    static std::atomic<uint32_t> next{0};
+    thread_local const uint32_t hint = next.fetch_add(1, std::memory_order_relaxed);
+    return hint;
+}
+
+/// A fixed set of monotonically increasing counters, sharded by thread.
+///
+/// Each shard occupies its own cache lines, so threads bumping counters
+/// concurrently never write to the same line unless they hash to the same
+/// shard.  Reads merge every shard and are not a consistent snapshot across
+/// fields: a counter read while writers are active reflects some prefix of
+/// the increments.
+///
+/// Thread safety: add() and load() are safe from any thread.
+///
+/// # Template parameters
+/// * `Fields` — Number of counters.
+/// * `Shards` — Number of shards; a power of two.
+template <size_t Fields, size_t Shards = 16>
+class ShardedCounters {
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+public:
+    static constexpr size_t kCacheLineSize = 64;
+
+    /// Add `n` to counter `field` in the calling thread's shard.
+    void add(size_t field, uint64_t n = 1) noexcept {
+        shards_[this_thread_shard_hint() & (Shards - 1)].counts[field]
+            .fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// Return the sum of counter `field` over every shard.
+    uint64_t load(size_t field) const noexcept {
+        uint64_t total = 0;
+        for (const Shard& s : shards_) total += s.counts[field].load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::array<std::atomic<uint64_t>, Fields> counts{};
+    };
+
+    std::array<Shard, Shards> shards_{};
+};
+
+} // namespace llmquant
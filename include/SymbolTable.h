@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace llmquant {
+
+/// Dense integer identifier for a tradable instrument.
+using SymbolId = uint32_t;
+
+/// The market as a whole: sentiment not attributed to any instrument.
+/// Always registered, as ID 0 with an empty name.
+inline constexpr SymbolId kMarketSymbol = 0;
+
+/// Sentinel for "no such symbol"; never returned by SymbolTable::add().
+inline constexpr SymbolId kInvalidSymbolId = std::numeric_limits<SymbolId>::max();
+
+/// Registry mapping instrument names to dense SymbolIds.
+///
+/// Names are stored upper-cased, so "nvda" and "NVDA" share an ID.  IDs are
+/// assigned 1, 2, 3, ... in registration order (0 is kMarketSymbol), which
+/// lets per-symbol state live in flat arrays indexed by ID.
+///
+/// Thread safety: populate with add() before the table is shared; find(),
+/// name() and size() are then safe from any thread.
+class SymbolTable {
+public:
+    SymbolTable();
+
+    /// Register `name` (case-insensitive) and return its ID; an existing
+    /// name returns its original ID.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `name` is empty.
+    SymbolId add(std::string_view name);
+
+    /// Return the ID of `name` (case-insensitive), or kInvalidSymbolId.
+    SymbolId find(std::string_view name) const;
+
+    /// Return the upper-cased name of `id`; empty for kMarketSymbol or an unknown ID.
+    std::string_view name(SymbolId id) const noexcept {
+        return id < names_.size() ? std::string_view(names_[id]) : std::string_view{};
+    }
+
+    /// Return the number of IDs in use, including kMarketSymbol.
+    size_t size() const noexcept { return names_.size(); }
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, SymbolId> index_;
+};
+
+} // namespace llmquant
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SymbolTable.h"
+#include "TokenVocabulary.h"
+
+namespace llmquant {
+
+/// Instruments TickerExtractor recognises and how long a mention lasts.
+///
+/// Mirrors the `symbols` config section.
+struct TickerRules {
+    /// Symbol name -> extra aliases ("NVDA" -> {"nvidia"}).  The name itself
+    /// and its cashtag ("$NVDA") are always recognised.
+    std::vector<std::pair<std::string, std::vector<std::string>>> tickers;
+    /// How many tokens after a mention still belong to that ticker; clamped
+    /// to at least 1.
+    uint32_t window{16};
+};
+
+/// Streaming ticker recogniser that tags each token with the instrument it
+/// is about.
+///
+/// compile() interns every ticker alias into the pipeline's vocabulary and
+/// records its SymbolId in a flat table indexed by TokenId, so recognising a
+/// ticker is a single table load; no hashing or string comparison happens
+/// per token.  Aliases are normalised like any other token, so "NVDA",
+/// " nvda" and "$NVDA" all hit.
+///
+/// Attribution follows the last ticker mentioned: a ticker token and the
+/// `window` tokens after it are attributed to that ticker, later tokens fall
+/// back to kMarketSymbol until the next mention.  Each stream keeps its own
+/// State; cost per token is constant and nothing is allocated.
+///
+/// Thread safety: attribute() is safe to call concurrently with distinct
+/// States.  compile() must not run concurrently with attribute().
+class TickerExtractor {
+public:
+    /// Per-stream attribution.  Default-constructed state is the start of a stream.
+    struct State {
+        SymbolId symbol{kMarketSymbol};
+        /// Tokens seen since `symbol` was mentioned.
+        uint32_t age{0};
+    };
+
+    /// Construct an inactive extractor; attribute() returns kMarketSymbol.
+    TickerExtractor() = default;
+
+    TickerExtractor(const TickerExtractor&) = delete;
+    TickerExtractor& operator=(const TickerExtractor&) = delete;
+
+    /// Compile `rules`, registering each ticker in `symbols` and interning
+    /// every alias into `vocabulary`.
+    ///
+    /// Replaces any previously compiled rules.
+    ///
+    /// # Arguments
+    /// * `rules`      — Tickers, aliases and attribution window.
+    /// * `vocabulary` — Vocabulary the stream's token IDs come from.
+    /// * `symbols`    — Registry that assigns the SymbolIds.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if a ticker name is empty.
+    void compile(const TickerRules& rules, TokenVocabulary& vocabulary, SymbolTable& symbols);
+
+    /// Drop all tickers; attribute() returns kMarketSymbol.
+    void clear();
+
+    /// Returns true if compile() installed any ticker.
+    bool active() const { return active_; }
+
+    /// Feed one token of a stream and return the symbol it is attributed to.
+    ///
+    /// # Arguments
+    /// * `state` — The stream's attribution; updated in place.
+    /// * `id`    — The token.
+    ///
+    /// # Returns
+    /// The ticker the token names, else the last ticker mentioned within the
+    /// window, else kMarketSymbol.
+    SymbolId attribute(State& state, TokenId id) const noexcept {
+        if (!active_) return kMarketSymbol;
+
+        const SymbolId* hit = symbols_.find(id);
+        if (hit && *hit != kMarketSymbol) {
+            state.symbol = *hit;
+            state.age    = 0;
+            return *hit;
+        }
+        if (state.symbol == kMarketSymbol) return kMarketSymbol;
+        if (++state.age > window_) {
+            state = State{};
+            return kMarketSymbol;
+        }
+        return state.symbol;
+    }
+
+private:
+    /// TokenId -> SymbolId; kMarketSymbol (zero) for non-ticker tokens.
+    TokenIdTable<SymbolId> symbols_;
+    uint32_t window_{16};
+    bool active_{false};
+};
+
+} // namespace llmquant
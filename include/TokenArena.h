@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace llmquant {
+
+/// Append-only corpus of token text stored back to back in one buffer.
+///
+/// Each token is recorded as an offset/length pair into the buffer, so a
+/// corpus of N tokens costs two allocations instead of N, and text(i) is a
+/// view with no copy.  Views are invalidated by append() (the buffer may
+/// grow) and clear(); once loading is finished they stay valid for the
+/// arena's lifetime.
+///
+/// Thread safety: const methods are safe concurrently; mutation is not.
+class TokenArena {
+public:
+    /// Location of one token in the byte buffer.
+    struct Span {
+        uint64_t offset{0};
+        uint32_t length{0};
+    };
+
+    /// Reserve room for `tokens` tokens totalling `bytes` bytes of text.
+    void reserve(size_t tokens, size_t bytes) {
+        spans_.reserve(tokens);
+        bytes_.reserve(bytes);
+    }
+
+    /// Copy `token` into the arena and return its index.
+    size_t append(std::string_view token) {
+        spans_.push_back({bytes_.size(), static_cast<uint32_t>(token.size())});
+        bytes_.insert(bytes_.end(), token.begin(), token.end());
+        return spans_.size() - 1;
+    }
+
+    /// Return a view of token `i`.
+    std::string_view text(size_t i) const noexcept {
+        const Span& s = spans_[i];
+        return {bytes_.data() + s.offset, s.length};
+    }
+
+    /// Return the number of tokens.
+    size_t size() const noexcept { return spans_.size(); }
+
+    /// Returns true if the arena holds no tokens.
+    bool empty() const noexcept { return spans_.empty(); }
+
+    /// Return the total number of text bytes stored.
+    size_t byte_size() const noexcept { return bytes_.size(); }
+
+    /// Drop every token.
+    void clear() noexcept {
+        spans_.clear();
+        bytes_.clear();
+    }
+
+private:
+    std::vector<char> bytes_;
+    std::vector<Span> spans_;
+};
+
+} // namespace llmquant
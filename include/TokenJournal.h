@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace llmquant {
+
+/// Current token journal format version.  Journals written with any other
+/// version are rejected by TokenJournalReader.
+inline constexpr uint32_t kTokenJournalVersion = 1;
+
+/// Monotonic timestamp in nanoseconds (std::chrono::steady_clock), the time
+/// base of every journal record.
+inline uint64_t monotonic_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// One token as stored in a journal.
+struct JournalRecord {
+    /// Monotonic time the token's bytes were received, in nanoseconds.
+    uint64_t receive_ns{0};
+    /// Position of the token within its stream, starting at 0.
+    uint64_t sequence{0};
+    /// Identifies the stream (client, prompt, model) the token came from.
+    uint32_t stream_id{0};
+    /// Token text.  From TokenJournalReader this views the mapped journal.
+    std::string_view text;
+};
+
+/// Appends received tokens to a binary journal for later replay.
+///
+/// The file holds a 32-byte header (magic, format version, byte order and
+/// the monotonic time the journal was opened) followed by one record per
+/// token: receive time, sequence number, stream ID, text length, then the
+/// text bytes.  Records are buffered and written in blocks, so record() on
+/// the live path is a memcpy into the buffer most of the time.
+///
+/// Thread safety: record() and flush() may be called from several threads
+/// (e.g. one per stream client); calls are serialised internally.
+class TokenJournalWriter {
+public:
+    /// Create (or truncate) `path` and write the journal header.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the file cannot be created.
+    explicit TokenJournalWriter(const std::string& path);
+
+    /// Flush buffered records and close the file.
+    ~TokenJournalWriter();
+
+    TokenJournalWriter(const TokenJournalWriter&) = delete;
+    TokenJournalWriter& operator=(const TokenJournalWriter&) = delete;
+
+    /// Append one token.
+    ///
+    /// Sequence numbers are assigned per stream ID in call order.
+    ///
+    /// # Arguments
+    /// * `stream_id`  — Source stream.
+    /// * `text`       — Token text as delivered to the pipeline.
+    /// * `receive_ns` — Receive time (see monotonic_ns()); defaults to now.
+    void record(uint32_t stream_id, std::string_view text, uint64_t receive_ns = monotonic_ns());
+
+    /// Write buffered records through to the file.
+    void flush();
+
+    /// Return the number of records appended so far.
+    uint64_t records_written() const;
+
+private:
+    /// Write the buffer out (mutex_ held).
+    void flush_locked();
+
+    static constexpr size_t kBufferBytes = 64 * 1024;
+
+    mutable std::mutex mutex_;
+    std::FILE* file_{nullptr};
+    std::vector<char> buffer_;
+    std::unordered_map<uint32_t, uint64_t> next_sequence_;
+    uint64_t records_{0};
+};
+
+/// Reads a journal written by TokenJournalWriter, in recorded order.
+///
+/// The file is memory-mapped and records are decoded in place; record text
+/// views the mapping and stays valid for the reader's lifetime.  A record
+/// cut short at the end of the file (a writer that died mid-flush) ends the
+/// journal rather than failing it.
+///
+/// Thread safety: none; use one reader per thread.
+class TokenJournalReader {
+public:
+    /// Map and validate `path`.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the file cannot be mapped, is not a token
+    /// journal, or was written with a different format version or byte order.
+    explicit TokenJournalReader(const std::string& path);
+
+    /// Decode the next record.
+    ///
+    /// # Returns
+    /// `false` at the end of the journal (`out` is left unchanged).
+    bool next(JournalRecord& out);
+
+    /// Restart from the first record.
+    void rewind();
+
+    /// Return the monotonic time the journal was opened for writing.
+    uint64_t origin_ns() const noexcept { return origin_ns_; }
+
+private:
+    MappedFile file_;
+    size_t     pos_{0};
+    uint64_t   origin_ns_{0};
+};
+
+} // namespace llmquant
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace llmquant {
+
+/// Caller-owned scratch space for normalize_token().
+///
+/// Declare one on the stack per lookup.  Tokens whose trimmed length fits in
+/// kCapacity are written to the inline array with no heap allocation; only
+/// pathological oversize tokens spill into `overflow`.
+struct NormalizeBuffer {
+    /// Largest trimmed token normalised without touching the heap.
+    static constexpr size_t kCapacity = 128;
+    /// Extra tail room so the vector kernels may store a full register past
+    /// the last valid byte.
+    static constexpr size_t kSlack = 32;
+
+    alignas(32) char inline_bytes[kCapacity + kSlack];
+    std::string overflow;
+};
+
+/// Strip leading/trailing ASCII whitespace and lowercase ASCII letters.
+///
+/// Equivalent to the isspace()/tolower() loop in the "C" locale, but
+/// vectorised: whitespace is located 16 bytes at a time with SSE2, and
+/// letters are lowercased 32 bytes at a time with AVX2 when the build
+/// targets it (SSE2 otherwise).  Bytes >= 0x80 pass through unchanged.
+///
+/// GPT-4o streams tokens like " bullish" or "Bullish" that must map to
+/// "bullish"; this is the key form every lexicon lookup expects.
+///
+/// # Arguments
+/// * `raw` — Token text exactly as received from the stream.
+/// * `buf` — Scratch storage; the returned view points into it.
+///
+/// # Returns
+/// View of the normalised token, valid until `buf` is reused or destroyed.
+std::string_view normalize_token(std::string_view raw, NormalizeBuffer& buf);
+
+/// Return the next whitespace-delimited token of `text` at or after `pos`.
+///
+/// Uses the same SSE2 whitespace classifier as normalize_token(): leading
+/// whitespace is skipped 16 bytes at a time, and the end of the token is
+/// found 16 (AVX2: 32) bytes at a time.  Never reads outside `text`, so it is safe
+/// on a view that ends at the last byte of a memory mapping.
+///
+/// # Arguments
+/// * `text` — Text to tokenize.
+/// * `pos`  — Scan position; advanced past the returned token.
+///
+/// # Returns
+/// A view into `text`, or an empty view (with `pos == text.size()`) when no
+/// token remains.
+std::string_view next_token(std::string_view text, size_t& pos);
+
+} // namespace llmquant
@@ -3,46 +3,100 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <vector>
 #include <stdexcept>
 
+#include "ArrivalProcess.h"
+#include "LatencyHistogram.h"
+#include "MappedFile.h"
+#include "Pacing.h"
+#include "TokenArena.h"
+#include "TokenJournal.h"
+#include "TokenVocabulary.h"
+
 namespace llmquant {
 
 /// A single token emitted by the simulator.
+///
+/// Trivially copyable: the text is a view into the simulator's TokenArena,
+/// not an owned string.  The view stays valid until the simulator is
+/// destroyed or stopped after a reload; copy it if it must live longer.
 struct Token {
     /// The raw text of the token.
-    std::string text;
+    std::string_view text;
     /// Monotonically increasing emission sequence number (starts at 0).
-    uint64_t sequence_id;
+    /// Replayed journal tokens keep their recorded per-stream sequence.
+    uint64_t sequence_id{0};
+    /// ID of the token in the simulator's vocabulary (interned when loaded or streamed).
+    TokenId token_id{kInvalidTokenId};
+    /// Recorded receive time (monotonic ns) for journal replay; 0 otherwise.
+    uint64_t timestamp_ns{0};
+    /// Recorded stream ID for journal replay; 0 otherwise.
+    uint32_t stream_id{0};
+    /// Monotonic ns (see monotonic_ns()) at which TokenStreamSimulator released
+    /// the token to its consumer.  Subtract from the processing time to get
+    /// per-token latency, including inside a batch.
+    uint64_t emit_ns{0};
 
-    Token(std::string t, uint64_t id) : text(std::move(t)), sequence_id(id) {}
+    Token() = default;
+    Token(std::string_view t, uint64_t id, TokenId tid = kInvalidTokenId)
+        : text(t), sequence_id(id), token_id(tid) {}
 };
 
+static_assert(std::is_trivially_copyable_v<Token>, "Token must stay a trivially copyable view");
+
 /// Callback invoked once per emitted token on the simulator worker thread.
 using TokenCallback = std::function<void(const Token&)>;
 
+/// Callback invoked with every token released since the previous call.
+/// The span is only valid for the duration of the call.
+using TokenBatchCallback = std::function<void(std::span<const Token>)>;
+
 /// Replays a pre-loaded token sequence at a configurable cadence.
 ///
 /// Tokens are emitted on a background worker thread.  The caller registers a
 /// TokenCallback via set_token_callback() before calling start().
 ///
-/// Two data sources are supported:
+/// Four data sources are supported:
 ///   - In-memory: call load_tokens_from_memory() with a vector of strings.
 ///   - File:      call load_tokens_from_file() with a path to a newline /
 ///                whitespace-delimited token file.
+///   - Streamed:  call stream_tokens_from_file() to map a file of any size
+///                and tokenize it lazily as the ring buffer drains.
+///   - Journal:   call replay_journal() to play back a session recorded by
+///                TokenJournalWriter with its original timing.
+///
+/// The simulator loops over the buffer indefinitely until stop() is called;
+/// a journal replay plays once and then goes idle.
+///
+/// Loaded text is copied once into a contiguous TokenArena.  The ring buffer
+/// and emitted Tokens carry views into it, so the emit path performs no heap
+/// allocation and no string copy.  Reloading while running keeps the old
+/// source alive until stop(), so views already in flight do not dangle.
 ///
-/// The simulator loops over the buffer indefinitely until stop() is called.
+/// Every loaded token is interned into the simulator's TokenVocabulary when
+/// it is loaded, so emitted Tokens carry a ready-made `token_id` and no
+/// per-emission hashing is needed downstream.  Share one vocabulary across
+/// the pipeline with set_vocabulary().
 ///
 /// Thread safety: start/stop are not thread-safe with respect to each other.
 /// get_stats() is always safe; set_token_callback must be called before start().
 class TokenStreamSimulator {
 public:
+    /// How the worker waits for each token's emission deadline.
+    using Pacing = llmquant::Pacing;
+
     /// Construction-time parameters for the simulator.
     struct Config {
-        /// Time between consecutive token emissions.
+        /// Time between consecutive token emissions.  Token n is due at
+        /// start + n * token_interval, so late wakeups do not accumulate.
         std::chrono::microseconds token_interval{std::chrono::microseconds{10000}};
         /// Initial reservation size for the token buffer.
         size_t buffer_size{1024};
@@ -50,14 +104,25 @@ public:
         bool use_memory_stream{false};
         /// Path to a token file used when use_memory_stream is false.
         std::string data_file_path{"tokens.txt"};
+        /// Journal replay speed: recorded inter-arrival gaps are divided by
+        /// this factor (2.0 plays twice as fast).  0 replays as fast as possible.
+        double replay_speed{1.0};
+        /// Wait strategy; see Pacing.
+        Pacing pacing{Pacing::Sleep};
+        /// Hybrid mode: how far ahead of each deadline to stop sleeping and spin.
+        std::chrono::microseconds spin_window{std::chrono::microseconds{200}};
     };
 
     /// Live emission statistics updated atomically by the worker thread.
     struct Stats {
         std::atomic<uint64_t> tokens_emitted{0};
-        std::atomic<uint64_t> avg_latency_us{0};
-        std::atomic<uint64_t> max_latency_us{0};
-        std::atomic<uint64_t> ring_buffer_drops{0};   ///< Tokens dropped when ring buffer was full.
+        /// Per-token callback time in ns; amortised over the batch in batch mode.
+        LatencyHistogram callback_latency;
+        /// Tokens delivered, for tokens/s over sliding windows of up to 60 s.
+        WindowedRate emission_rate;
+        std::atomic<uint64_t> achieved_rate_tps{0};   ///< Emission rate over the last ~100 ms window.
+        std::atomic<uint64_t> pacing_error_avg_ns{0}; ///< Mean emission lateness vs. the scheduled deadline.
+        std::atomic<uint64_t> pacing_error_max_ns{0}; ///< Worst emission lateness seen.
     };
 
     /// Construct a simulator with the given configuration.
@@ -84,9 +149,46 @@ public:
     /// * `callback` — A callable matching the TokenCallback signature.
     void set_token_callback(TokenCallback callback);
 
+    /// Register a batch callback, used instead of the per-token callback.
+    ///
+    /// Tokens that are already due are handed over together: a batch closes
+    /// when the next token is not yet due, the ring runs dry, or `buffer_size`
+    /// tokens are pending.  Pacing is unchanged, so at low rates batches hold
+    /// one token; when the consumer falls behind, or with replay speed 0,
+    /// they grow and one std::function dispatch covers many tokens.  Each
+    /// token keeps its own `emit_ns`.  Must be called before start().
+    ///
+    /// # Arguments
+    /// * `callback` — A callable matching the TokenBatchCallback signature.
+    void set_batch_callback(TokenBatchCallback callback);
+
+    /// Draw inter-token gaps from `process` instead of the fixed token_interval.
+    ///
+    /// Use PoissonArrivals, BurstyArrivals or EmpiricalArrivals to drive the
+    /// pipeline with realistic burst load; gaps are still scheduled against
+    /// absolute deadlines with the configured Pacing.  Journal replay ignores
+    /// the process and uses recorded timestamps.  Must be called before start().
+    ///
+    /// # Arguments
+    /// * `process` — Gap source; nullptr restores the fixed interval.
+    void set_arrival_process(std::unique_ptr<ArrivalProcess> process);
+
+    /// Replace the vocabulary used to intern loaded tokens.
+    ///
+    /// Must be called before load_tokens_from_file()/load_tokens_from_memory().
+    ///
+    /// # Arguments
+    /// * `vocabulary` — Vocabulary shared with downstream consumers.
+    void set_vocabulary(std::shared_ptr<TokenVocabulary> vocabulary);
+
+    /// Return the vocabulary emitted token IDs refer to.
+    const std::shared_ptr<TokenVocabulary>& vocabulary() const { return vocabulary_; }
+
     /// Populate the token buffer from a file on disk.
     ///
-    /// Each whitespace-separated word becomes a separate token.
+    /// Each whitespace-separated word becomes a separate token.  The file is
+    /// mapped and scanned with next_token(), and the text is appended to the
+    /// arena straight from the mapping; no per-token strings are built.
     ///
     /// # Arguments
     /// * `filepath` — Path to the token file.
@@ -95,8 +197,42 @@ public:
     /// `std::runtime_error` if the file cannot be opened.
     void load_tokens_from_file(const std::string& filepath);
 
+    /// Replay a token file without reading it up front.
+    ///
+    /// The file is memory-mapped and tokenized lazily by the worker: each
+    /// ring refill scans just enough of the mapping with next_token() to
+    /// fill half the ring, interning as it goes.  Emitted Tokens view the
+    /// mapping directly, so nothing is copied.  Pages well behind the scan
+    /// position are released, keeping resident memory bounded regardless
+    /// of file size; replay wraps to the start at end of file.
+    ///
+    /// # Arguments
+    /// * `filepath` — Path to the token file.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the file cannot be opened or mapped.
+    void stream_tokens_from_file(const std::string& filepath);
+
+    /// Replay a session recorded with TokenJournalWriter.
+    ///
+    /// Records are emitted in journal order with their recorded text,
+    /// sequence number, stream ID and receive timestamp.  Instead of the
+    /// fixed `token_interval`, each token is held until its recorded offset
+    /// from the first replayed record, divided by `Config::replay_speed`, has
+    /// elapsed, so the original burst pattern is reproduced.  Token text
+    /// views the mapped journal; nothing is copied.  Replay runs once.
+    ///
+    /// # Arguments
+    /// * `filepath` — Path to the journal.
+    ///
+    /// # Throws
+    /// `std::runtime_error` if the file cannot be mapped or is not a valid journal.
+    void replay_journal(const std::string& filepath);
+
     /// Populate the token buffer from an in-memory vector.
     ///
+    /// The strings are copied into the arena; `tokens` need not outlive the call.
+    ///
     /// # Arguments
     /// * `tokens` — Vector of raw token strings to replay.
     void load_tokens_from_memory(const std::vector<std::string>& tokens);
@@ -108,7 +244,7 @@ public:
     const Stats& get_stats() const { return stats_; }
 
 private:
-    /// Lock-free SPSC ring buffer for token strings.
+    /// Lock-free SPSC ring buffer for tokens (text views, no ownership).
     ///
     /// Uses two cache-line-separated atomics (head_ / tail_) to avoid
     /// false sharing.  Capacity is rounded up to the next power of two so
@@ -125,20 +261,20 @@ private:
         }
 
         /// Try to push a token.  Returns false if the buffer is full.
-        bool try_push(std::string token) {
+        bool try_push(const Token& token) {
             const size_t t = tail_.load(std::memory_order_relaxed);
             const size_t next = (t + 1) & mask_;
             if (next == head_.load(std::memory_order_acquire)) return false;  // full
-            slots_[t] = std::move(token);
+            slots_[t] = token;
             tail_.store(next, std::memory_order_release);
             return true;
         }
 
         /// Try to pop a token.  Returns false if the buffer is empty.
-        bool try_pop(std::string& out) {
+        bool try_pop(Token& out) {
             const size_t h = head_.load(std::memory_order_relaxed);
             if (h == tail_.load(std::memory_order_acquire)) return false;  // empty
-            out = std::move(slots_[h]);
+            out = slots_[h];
             head_.store((h + 1) & mask_, std::memory_order_release);
             return true;
         }
@@ -151,6 +287,8 @@ private:
 
         bool empty() const { return size() == 0; }
 
+        bool full() const { return size() == mask_; }
+
         void clear() {
             head_.store(0, std::memory_order_relaxed);
             tail_.store(0, std::memory_order_relaxed);
@@ -160,18 +298,52 @@ private:
         alignas(kCacheLineSize) std::atomic<size_t> head_{0};
         alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
         size_t mask_{0};
-        std::vector<std::string> slots_;
+        std::vector<Token> slots_;
     };
 
     void stream_worker();
 
+    /// Wait until `deadline` using the configured Pacing mode.  Sleeps are
+    /// sliced so stop() is not held up by a long recorded gap.
+    void pace_until(std::chrono::steady_clock::time_point deadline) const;
+
+    /// Where ring refills read from: a loaded arena, a lazily scanned mapping or a journal.
+    struct TokenSource {
+        std::unique_ptr<TokenArena> arena;    ///< Eager loaders.
+        std::vector<TokenId>        ids;      ///< `arena` tokens interned into vocabulary_.
+        std::unique_ptr<MappedFile> mapped;   ///< stream_tokens_from_file().
+        std::unique_ptr<TokenJournalReader> journal;   ///< replay_journal().
+        size_t next{0};                       ///< Next arena index, or byte offset into `mapped`.
+        size_t released{0};                   ///< Mapped bytes below this offset were discarded.
+    };
+
+    /// Mapped bytes kept resident behind the scan position before release.
+    static constexpr size_t kStreamResidentBytes = size_t{8} << 20;
+
+    /// Install `source` and pre-fill the ring from it; while running the
+    /// worker does the pre-fill when it next checks source_generation_.
+    void install_source(std::unique_ptr<TokenSource> source);
+
+    /// Push up to `max` tokens from source_ into the ring (load_mutex_ held).
+    ///
+    /// # Returns
+    /// Number of tokens pushed.
+    size_t refill(size_t max);
+
     Config config_;
     TokenCallback callback_;
+    TokenBatchCallback batch_callback_;
+    std::unique_ptr<ArrivalProcess> arrival_;   // null: fixed token_interval
     RingBuffer ring_buffer_;
-    std::vector<std::string> source_tokens_;   // master token list (filled once, read-only after load)
-    std::mutex load_mutex_;                    // protects source_tokens_ during load
+    std::unique_ptr<TokenSource> source_;       // master token text (read-only after load)
+    /// Sources replaced while running; freed by stop() once no view can be in flight.
+    std::vector<std::unique_ptr<TokenSource>> retired_sources_;
+    std::shared_ptr<TokenVocabulary> vocabulary_;
+    std::mutex load_mutex_;                    // protects source_ during load and refill
     std::atomic<bool> running_{false};
     std::atomic<uint64_t> current_sequence_{0};
+    std::atomic<uint64_t> source_generation_{0};   // bumped per install; rebases replay timing
+    uint64_t ring_generation_{0};              // source generation the ring was filled from (load_mutex_)
     std::thread worker_thread_;
     Stats stats_;
 };
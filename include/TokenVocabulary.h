@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace llmquant {
+
+/// Dense integer identifier for an interned token.
+using TokenId = uint32_t;
+
+/// Sentinel for "no token"; never returned by TokenVocabulary::intern().
+inline constexpr TokenId kInvalidTokenId = std::numeric_limits<TokenId>::max();
+
+/// Array indexed by TokenId with stable element addresses.
+///
+/// Storage is allocated in fixed chunks on first touch, so growing the table
+/// never moves existing elements and a reader can index it without a lock
+/// while a writer appends.  Elements are value-initialised.
+///
+/// Thread safety: find() may run concurrently with ensure(); concurrent
+/// ensure() calls must be serialised by the caller.  clear() must not run
+/// concurrently with anything.
+template <typename T>
+class TokenIdTable {
+public:
+    static constexpr size_t kChunkBits = 12;
+    static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+    static constexpr size_t kMaxChunks = 4096;
+    /// Largest number of IDs the table can address.
+    static constexpr size_t kCapacity  = kChunkSize * kMaxChunks;
+
+    TokenIdTable() = default;
+    ~TokenIdTable() { clear(); }
+
+    TokenIdTable(const TokenIdTable&) = delete;
+    TokenIdTable& operator=(const TokenIdTable&) = delete;
+
+    /// Return the element for `id`, or nullptr if its chunk was never allocated.
+    T* find(TokenId id) const noexcept {
+        const size_t chunk = id >> kChunkBits;
+        if (chunk >= kMaxChunks) return nullptr;
+        T* base = chunks_[chunk].load(std::memory_order_acquire);
+        return base ? base + (id & (kChunkSize - 1)) : nullptr;
+    }
+
+    /// Return the element for `id`, allocating its chunk if needed.
+    ///
+    /// # Throws
+    /// `std::length_error` if `id` is outside the addressable range.
+    T& ensure(TokenId id) {
+        const size_t chunk = id >> kChunkBits;
+        if (chunk >= kMaxChunks) throw std::length_error("TokenIdTable: id out of range");
+        T* base = chunks_[chunk].load(std::memory_order_acquire);
+        if (!base) {
+            base = new T[kChunkSize]();
+            chunks_[chunk].store(base, std::memory_order_release);
+            if (chunk >= used_chunks_) used_chunks_ = chunk + 1;
+        }
+        return base[id & (kChunkSize - 1)];
+    }
+
+    /// Free every chunk.
+    void clear() noexcept {
+        for (size_t i = 0; i < used_chunks_; ++i) {
+            delete[] chunks_[i].exchange(nullptr, std::memory_order_relaxed);
+        }
+        used_chunks_ = 0;
+    }
+
+private:
+    std::array<std::atomic<T*>, kMaxChunks> chunks_{};
+    /// One past the highest chunk ever allocated; bounds clear().
+    size_t used_chunks_{0};
+};
+
+/// Interning table mapping each distinct token to a dense TokenId.
+///
+/// Tokens are normalised (see normalize_token()) before interning, so
+/// `" Bullish"` and `"bullish"` share an ID and the ID space lines up with
+/// LLMAdapter's dictionary keys.  IDs are assigned 0, 1, 2, ... in first-seen
+/// order and are never recycled.
+///
+/// Intended use is to intern once at ingestion and pass the ID downstream, so
+/// the dedup, lookup and logging stages never hash or copy token text.
+///
+/// Thread safety: all methods are safe to call concurrently.  intern() and
+/// find() take a shared lock on the fast path (token already known) and an
+/// exclusive lock only when inserting.  text() is lock-free.
+class TokenVocabulary {
+public:
+    TokenVocabulary() = default;
+
+    TokenVocabulary(const TokenVocabulary&) = delete;
+    TokenVocabulary& operator=(const TokenVocabulary&) = delete;
+
+    /// Return the ID for `token`, assigning a new one on first sight.
+    ///
+    /// # Arguments
+    /// * `token` — Raw token text; surrounding whitespace and case are ignored.
+    ///
+    /// # Throws
+    /// `std::length_error` if the vocabulary already holds
+    /// TokenIdTable<std::string>::kCapacity entries.
+    TokenId intern(std::string_view token);
+
+    /// Return the ID for `token` without inserting it.
+    ///
+    /// # Returns
+    /// The assigned ID, or kInvalidTokenId if `token` was never interned.
+    TokenId find(std::string_view token) const;
+
+    /// Return the normalised text of an interned token.
+    ///
+    /// The view stays valid for the lifetime of the vocabulary.
+    ///
+    /// # Arguments
+    /// * `id` — An ID previously returned by intern().
+    std::string_view text(TokenId id) const {
+        const std::string* s = strings_.find(id);
+        return s ? std::string_view(*s) : std::string_view{};
+    }
+
+    /// Return the number of interned tokens.
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    mutable std::shared_mutex mutex_;
+    /// Keys view the strings owned by strings_, which never move.
+    std::unordered_map<std::string_view, TokenId> index_;
+    TokenIdTable<std::string> strings_;
+    std::atomic<size_t> size_{0};
+};
+
+} // namespace llmquant
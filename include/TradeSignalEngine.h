@@ -7,8 +7,12 @@
 #include <memory>
 #include <vector>
 
+#include "Clock.h"
+#include "ExpDecay.h"
 #include "LLMAdapter.h"   // SemanticWeight
 #include "OutputSink.h"
+#include "SeqLock.h"
+#include "SymbolTable.h"
 
 namespace llmquant {
 
@@ -18,10 +22,11 @@ namespace llmquant {
 /// are provided: the chrono field is used for latency arithmetic inside the
 /// engine; the integer field is used for serialisation and cross-process IPC.
 struct TradeSignal {
-    /// Nanoseconds since the Unix epoch at signal emission time.
+    /// Nanoseconds since the Unix epoch at signal emission time (since the
+    /// injected clock's epoch when the engine runs on a ManualClock).
     uint64_t timestamp_ns{0};
 
-    /// High-resolution timestamp at signal emission time (for latency arithmetic).
+    /// Engine-clock timestamp at signal emission time (for latency arithmetic).
     std::chrono::high_resolution_clock::time_point timestamp;
 
     /// Accumulated directional bias shift (negative = sell, positive = buy).
@@ -44,6 +49,15 @@ struct TradeSignal {
 
     /// Weighting applied to the selected strategy (0.0 = ignore, 1.0 = full weight).
     double strategy_weight{0.0};
+
+    /// Instrument the signal refers to; kMarketSymbol for market-wide sentiment.
+    SymbolId symbol{kMarketSymbol};
+
+    /// Time-weighted averages of the per-token bias contribution over the
+    /// fast, medium and slow horizons (see TradeSignalEngine::Config).
+    double bias_ewma_fast{0.0};
+    double bias_ewma_medium{0.0};
+    double bias_ewma_slow{0.0};
 };
 
 /// Callback invoked once per emitted TradeSignal on the engine's calling thread.
@@ -53,12 +67,23 @@ using TradeSignalCallback = std::function<void(const TradeSignal&)>;
 ///
 /// Incoming weights are accumulated with an exponential decay, then a signal
 /// is emitted when the cooldown period has elapsed (realtime mode) or on every
-/// token (backtest mode).
+/// token (backtest mode).  Decay is per token (signal_decay_rate) or, when
+/// decay_time_constant is set, exp(-dt/τ) over the clock time since the
+/// previous weight, which keeps signals comparable across ingestion rates.
+/// Fast, medium and slow EWMAs of the bias contribution are always decayed
+/// by elapsed time and reported on every TradeSignal.
 ///
-/// Thread safety: process_semantic_weight() is NOT thread-safe; all calls
-/// must arrive from the same thread.  get_stats() is always safe (atomic
-/// reads).  set_* configuration methods must not be called concurrently with
-/// process_semantic_weight().
+/// Thread safety: the engine is single-writer.  Accumulator state is plain
+/// data owned by the thread calling process_semantic_weight(), and all calls
+/// must arrive from that one thread; after each call the state is published
+/// through a seqlock, so snapshot() gives any thread a consistent view
+/// without locks and without slowing the writer.  get_stats() is always safe
+/// (atomic reads).  set_* configuration methods must not be called
+/// concurrently with process_semantic_weight().
+///
+/// Several producers must not call process_semantic_weight() directly; they
+/// submit through a WeightFunnel, whose MPSC queue serialises the weights
+/// onto one drain thread that owns the engine.
 class TradeSignalEngine {
 public:
     /// Construction-time parameters for the engine.
@@ -71,6 +96,82 @@ public:
         double signal_decay_rate{0.95};
         /// Minimum time between consecutive signal emissions in realtime mode.
         std::chrono::microseconds signal_cooldown{std::chrono::microseconds{1000}};
+        /// Time constant τ of elapsed-time accumulator decay, exp(-dt/τ).
+        /// Zero keeps the per-token signal_decay_rate.
+        std::chrono::nanoseconds decay_time_constant{0};
+        /// Time constants of the fast, medium and slow bias EWMAs.
+        std::chrono::nanoseconds ewma_fast{std::chrono::milliseconds{100}};
+        std::chrono::nanoseconds ewma_medium{std::chrono::seconds{1}};
+        std::chrono::nanoseconds ewma_slow{std::chrono::seconds{10}};
+    };
+
+    /// Accumulator state of one instrument; plain data owned by one writer.
+    struct SignalState {
+        double bias{0.0};
+        double volatility{0.0};
+        /// Latest confidence score; populates TradeSignal::confidence.
+        double confidence{0.5};
+        double ewma_fast{0.0};
+        double ewma_medium{0.0};
+        double ewma_slow{0.0};
+        /// Clock time of the previous weight, in nanoseconds.
+        int64_t last_update_ns{0};
+        /// Clock time of the last delivered signal, in nanoseconds.
+        int64_t last_signal_ns{0};
+    };
+
+    /// The per-weight signal math, shared by TradeSignalEngine and
+    /// MultiSymbolSignalEngine: decay, add the scaled contribution, update
+    /// the bias EWMAs, check the cooldown, build the signal and halve the
+    /// accumulators after a significant one.
+    ///
+    /// Thread safety: immutable after construction; apply() is safe from any
+    /// thread as long as each SignalState has a single writer.
+    class SignalStep {
+    public:
+        explicit SignalStep(const Config& config);
+
+        /// Fold `weight` into `state` at clock time `now`.
+        ///
+        /// When a signal is due (every weight outside realtime mode, else
+        /// once the cooldown since `state.last_signal_ns` has elapsed) it is
+        /// written to `out` from the updated accumulators, which are then
+        /// halved if the signal was significant.  The caller delivers `out`
+        /// and advances `state.last_signal_ns` if anyone received it.
+        ///
+        /// # Arguments
+        /// * `state`    — Accumulators of the instrument the weight belongs to.
+        /// * `weight`   — Normalised SemanticWeight from LLMAdapter.
+        /// * `now`      — Current engine-clock time.
+        /// * `realtime` — Whether the cooldown applies.
+        /// * `out`      — Receives the signal; symbol is left for the caller.
+        ///
+        /// # Returns
+        /// true if `out` holds a signal to emit.
+        bool apply(SignalState& state, const SemanticWeight& weight, Clock::time_point now,
+                   bool realtime, TradeSignal& out) const noexcept;
+
+    private:
+        Config config_;
+        ExpDecay accumulator_decay_;
+        ExpDecay ewma_fast_decay_;
+        ExpDecay ewma_medium_decay_;
+        ExpDecay ewma_slow_decay_;
+    };
+
+    /// Consistent view of the accumulator state, published after every
+    /// process_semantic_weight() call.
+    struct Snapshot {
+        double accumulated_bias{0.0};
+        double accumulated_volatility{0.0};
+        double last_confidence{0.5};
+        double bias_ewma_fast{0.0};
+        double bias_ewma_medium{0.0};
+        double bias_ewma_slow{0.0};
+        /// Clock time of the latest weight, in nanoseconds since the clock's epoch.
+        uint64_t timestamp_ns{0};
+        /// Number of weights processed so far.
+        uint64_t weights_processed{0};
     };
 
     /// Live statistics updated by the engine.
@@ -81,7 +182,12 @@ public:
     };
 
     /// Construct the engine with the given configuration.
-    explicit TradeSignalEngine(const Config& config);
+    ///
+    /// # Arguments
+    /// * `config` — Sensitivities, decay and cooldown.
+    /// * `clock`  — Time source for the cooldown and signal timestamps;
+    ///   null uses SystemClock.  Backtests pass a ManualClock.
+    explicit TradeSignalEngine(const Config& config, std::shared_ptr<Clock> clock = nullptr);
 
     /// Process a SemanticWeight and potentially emit a TradeSignal.
     ///
@@ -117,6 +223,10 @@ public:
     /// Return a const reference to the live statistics struct.
     const Stats& get_stats() const { return stats_; }
 
+    /// Return the state published by the latest process_semantic_weight()
+    /// call; safe from any thread.
+    Snapshot snapshot() const { return snapshot_.read(); }
+
     /// Register an OutputSink to receive all emitted signals.
     ///
     /// The sink is called synchronously inside emit_signal() after the
@@ -130,18 +240,18 @@ public:
     void clear_output_sinks();
 
 private:
-    bool should_emit_signal() const;
     void emit_signal(const TradeSignal& signal);
 
-    Config config_;
+    void publish();
+
+    SignalStep step_;
+    std::shared_ptr<Clock> clock_;
     TradeSignalCallback callback_;
-    std::atomic<double> accumulated_bias_{0.0};
-    std::atomic<double> accumulated_volatility_{0.0};
-    std::atomic<bool>   realtime_mode_{true};
-    /// Last confidence score observed from process_semantic_weight(); used to
-    /// populate TradeSignal::confidence on emission.
-    std::atomic<double> last_confidence_{0.5};
-    std::chrono::high_resolution_clock::time_point last_signal_time_;
+    std::atomic<bool> realtime_mode_{true};
+    // Accumulator state; read and written only by the writer thread.
+    SignalState state_;
+    uint64_t weights_processed_{0};
+    SeqLock<Snapshot> snapshot_;
     Stats stats_;
     std::vector<std::shared_ptr<OutputSink>> output_sinks_;
 };
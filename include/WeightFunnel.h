@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "MpmcQueue.h"
+#include "SemanticWeight.h"
+#include "TradeSignalEngine.h"
+
+namespace llmquant {
+
+/// Multi-producer front end for a single-writer TradeSignalEngine.
+///
+/// Producers on any thread submit() weights into a bounded MpmcQueue used
+/// in multi-producer / single-consumer mode; one drain thread owned by the
+/// funnel pops them in batches and is the only caller of
+/// process_semantic_weight().  The engine's state therefore never sees two
+/// writers, and monitoring threads keep reading it through snapshot().
+///
+/// The engine's signal callback and output sinks run on the drain thread.
+/// The engine must outlive the funnel and must not be driven directly while
+/// the funnel is open.
+///
+/// Thread safety: submit(), dropped() and queue_depth() are safe from any
+/// thread; close() and the destructor must not race each other.
+class WeightFunnel {
+public:
+    /// Start the drain thread.
+    ///
+    /// # Arguments
+    /// * `engine`   — Engine the drain thread drives; must outlive the funnel.
+    /// * `capacity` — Queue capacity (rounded up to a power of two).
+    /// * `policy`   — What submit() does when the queue is full.
+    ///
+    /// # Throws
+    /// `std::invalid_argument` if `capacity` is 0.
+    WeightFunnel(TradeSignalEngine& engine, size_t capacity,
+                 OverflowPolicy policy = OverflowPolicy::Block);
+
+    /// Close the funnel, draining every queued weight first.
+    ~WeightFunnel();
+
+    WeightFunnel(const WeightFunnel&) = delete;
+    WeightFunnel& operator=(const WeightFunnel&) = delete;
+
+    /// Queue `weight` for the engine.
+    ///
+    /// # Returns
+    /// false if the weight was dropped (DropNewest on a full queue) or the
+    /// funnel is closed.
+    bool submit(const SemanticWeight& weight) {
+        // Registering before checking closed_ lets the drain thread wait out
+        // every producer that saw the funnel open.
+        producers_.fetch_add(1, std::memory_order_seq_cst);
+        const bool pushed = !closed_.load(std::memory_order_seq_cst) && queue_.push(weight);
+        producers_.fetch_sub(1, std::memory_order_release);
+        return pushed;
+    }
+
+    /// Stop accepting weights, process everything already queued, and join
+    /// the drain thread.  Idempotent.
+    void close();
+
+    /// Weights discarded by the overflow policy.
+    uint64_t dropped() const noexcept { return queue_.dropped(); }
+
+    /// Approximate number of weights waiting for the drain thread.
+    size_t queue_depth() const noexcept { return queue_.size_approx(); }
+
+private:
+    void drain();
+
+    TradeSignalEngine& engine_;
+    MpmcQueue<SemanticWeight> queue_;
+    std::atomic<bool> closed_{false};
+    std::atomic<uint32_t> producers_{0};   // submit() calls in progress
+    std::jthread drainer_;
+};
+
+} // namespace llmquant
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+
+#include "QuantizedWeight.h"
+
+namespace llmquant {
+
+/// Confidence-weighted partial sums over a batch of SemanticWeights.
+///
+/// Finalising a batch is `sentiment / confidence` etc.; keeping the raw sums
+/// lets callers accumulate several batches before dividing.
+struct WeightSums {
+    double confidence{0.0};   ///< Σ confidence
+    double sentiment{0.0};    ///< Σ sentiment  × confidence
+    double volatility{0.0};   ///< Σ volatility × confidence
+    double bias{0.0};         ///< Σ bias       × confidence
+
+    WeightSums& operator+=(const WeightSums& o) {
+        confidence += o.confidence;
+        sentiment  += o.sentiment;
+        volatility += o.volatility;
+        bias       += o.bias;
+        return *this;
+    }
+};
+
+/// Structure-of-arrays view of `n` resolved weights.
+///
+/// Each pointer addresses `n` contiguous doubles.  32-byte alignment is
+/// preferred but not required.
+struct WeightColumns {
+    const double* sentiment{nullptr};
+    const double* confidence{nullptr};
+    const double* volatility{nullptr};
+    const double* bias{nullptr};
+    size_t n{0};
+};
+
+/// Instruction set selected for the weight kernels on this CPU.
+enum class SimdLevel {
+    SSE2,      ///< Baseline x86-64.
+    AVX2_FMA,  ///< 4-wide doubles with fused multiply-add.
+};
+
+/// Return the best kernel level supported by the running CPU.
+///
+/// Detected once via CPUID on first call; later calls are a cached load.
+SimdLevel detect_simd_level();
+
+/// Accumulate confidence-weighted sums over a column batch.
+///
+/// Dispatches to the AVX2+FMA kernel when detect_simd_level() reports it and
+/// to the SSE2 kernel otherwise.  Results match a sequential scalar sum to
+/// within floating-point reassociation error (lanes are summed separately
+/// and folded at the end).
+///
+/// # Arguments
+/// * `cols` — Weights to accumulate; `cols.n` may be zero.
+WeightSums accumulate_weights(const WeightColumns& cols);
+
+/// SSE2 kernel (2 doubles per register); exposed for tests and benchmarks.
+WeightSums accumulate_weights_sse2(const WeightColumns& cols);
+
+/// AVX2+FMA kernel (4 doubles per register); exposed for tests and benchmarks.
+///
+/// Must only be called when detect_simd_level() == SimdLevel::AVX2_FMA.
+WeightSums accumulate_weights_avx2(const WeightColumns& cols);
+
+/// Accumulate confidence-weighted sums over packed fixed-point weights.
+///
+/// Dequantization is fused into the reduction: products are formed on the
+/// raw Q1.15 values and the scale is applied once to the folded sums, so no
+/// element is ever expanded back into a SemanticWeight.  The partial sums
+/// are exact integers, so every kernel level returns identical results, and
+/// they match accumulate_weights() over the dequantized weights to within
+/// rounding.
+///
+/// # Arguments
+/// * `weights` — `n` contiguous weights; 8-byte alignment is sufficient.
+/// * `n`       — Number of weights; may be zero.
+WeightSums accumulate_quantized(const QuantizedWeight* weights, size_t n);
+
+/// SSE2 quantized kernel (two weights per iteration); exposed for tests and benchmarks.
+WeightSums accumulate_quantized_sse2(const QuantizedWeight* weights, size_t n);
+
+/// AVX2+FMA quantized kernel; exposed for tests and benchmarks.
+///
+/// Must only be called when detect_simd_level() == SimdLevel::AVX2_FMA.
+WeightSums accumulate_quantized_avx2(const QuantizedWeight* weights, size_t n);
+
+} // namespace llmquant
@@ -0,0 +1,129 @@
+#include "ArrivalProcess.h"
+#include "TokenJournal.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace llmquant {
+
+namespace {
+
+/// Truncate to whole nanoseconds, keeping histogram bins half-open.
+std::chrono::nanoseconds to_gap(double ns) {
+    return std::chrono::nanoseconds(static_cast<int64_t>(ns));
+}
+
+} // namespace
+
+double ArrivalRng::exponential(double mean) noexcept {
+    // 1 - u is in (0, 1], so the log is finite.
+    return -mean * std::log(1.0 - uniform());
+}
+
+PoissonArrivals::PoissonArrivals(double rate_tps, uint64_t seed)
+    : mean_gap_ns_(0.0), seed_(seed), rng_(seed) {
+    if (!(rate_tps > 0.0)) throw std::invalid_argument("PoissonArrivals: rate must be positive");
+    mean_gap_ns_ = 1e9 / rate_tps;
+}
+
+std::chrono::nanoseconds PoissonArrivals::next_gap() {
+    return to_gap(rng_.exponential(mean_gap_ns_));
+}
+
+BurstyArrivals::BurstyArrivals(const Params& params, uint64_t seed)
+    : params_(params), seed_(seed), rng_(seed) {
+    if (!(params_.burst_rate_tps > 0.0)) {
+        throw std::invalid_argument("BurstyArrivals: burst rate must be positive");
+    }
+    if (!(params_.mean_burst_tokens >= 1.0)) {
+        throw std::invalid_argument("BurstyArrivals: mean burst length must be at least 1");
+    }
+    remaining_ = draw_burst();
+}
+
+void BurstyArrivals::reset() {
+    rng_       = ArrivalRng(seed_);
+    remaining_ = draw_burst();
+}
+
+uint64_t BurstyArrivals::draw_burst() {
+    // Geometric on {1, 2, ...} with the requested mean.
+    const double p = 1.0 / params_.mean_burst_tokens;
+    if (p >= 1.0) return 1;
+    return 1 + static_cast<uint64_t>(std::floor(std::log(1.0 - rng_.uniform()) / std::log(1.0 - p)));
+}
+
+std::chrono::nanoseconds BurstyArrivals::next_gap() {
+    const double gap_ns = rng_.exponential(1e9 / params_.burst_rate_tps);
+    if (remaining_ > 0) {
+        --remaining_;
+        return to_gap(gap_ns);
+    }
+    // First token of a new response: the idle period plus time to first token.
+    remaining_ = draw_burst() - 1;
+    return params_.idle_period + to_gap(gap_ns);
+}
+
+EmpiricalArrivals::EmpiricalArrivals(std::vector<Bin> bins, uint64_t seed)
+    : bins_(std::move(bins)), seed_(seed), rng_(seed) {
+    if (bins_.empty()) throw std::invalid_argument("EmpiricalArrivals: histogram has no bins");
+    double total = 0.0;
+    std::chrono::nanoseconds prev{0};
+    cumulative_.reserve(bins_.size());
+    for (const Bin& b : bins_) {
+        if (b.upper < prev) throw std::invalid_argument("EmpiricalArrivals: bins must be in ascending order");
+        prev   = b.upper;
+        total += std::max(0.0, b.weight);
+        cumulative_.push_back(total);
+    }
+    if (!(total > 0.0)) throw std::invalid_argument("EmpiricalArrivals: histogram has no weight");
+}
+
+std::chrono::nanoseconds EmpiricalArrivals::next_gap() {
+    const double target = rng_.uniform() * cumulative_.back();
+    const size_t i = static_cast<size_t>(
+        std::upper_bound(cumulative_.begin(), cumulative_.end(), target) - cumulative_.begin());
+    const size_t bin = std::min(i, bins_.size() - 1);
+    const double lo = bin == 0 ? 0.0 : static_cast<double>(bins_[bin - 1].upper.count());
+    const double hi = static_cast<double>(bins_[bin].upper.count());
+    return to_gap(lo + (hi - lo) * rng_.uniform());
+}
+
+std::vector<EmpiricalArrivals::Bin> EmpiricalArrivals::histogram_from_journal(const std::string& path) {
+    TokenJournalReader reader(path);
+
+    // Bin k holds gaps in [2^(k-1), 2^k) ns; bin 0 holds zero gaps.
+    std::vector<double> counts(65, 0.0);
+    std::unordered_map<uint32_t, uint64_t> last_seen;
+    size_t gaps = 0;
+    JournalRecord rec;
+    while (reader.next(rec)) {
+        auto [it, first] = last_seen.try_emplace(rec.stream_id, rec.receive_ns);
+        if (!first) {
+            const uint64_t gap = rec.receive_ns >= it->second ? rec.receive_ns - it->second : 0;
+            counts[static_cast<size_t>(std::bit_width(gap))] += 1.0;
+            it->second = rec.receive_ns;
+            ++gaps;
+        }
+    }
+    if (gaps == 0) {
+        throw std::runtime_error("EmpiricalArrivals: " + path + " has no inter-arrival gaps");
+    }
+
+    // Emit bins from 0 up to the last populated one; empty interior bins keep
+    // the bounds contiguous.
+    size_t last = counts.size() - 1;
+    while (counts[last] == 0.0) --last;
+    std::vector<Bin> bins;
+    bins.reserve(last + 1);
+    for (size_t k = 0; k <= last; ++k) {
+        const uint64_t upper = k == 0 ? 1 : (k >= 63 ? INT64_MAX : uint64_t{1} << k);
+        bins.push_back({std::chrono::nanoseconds(static_cast<int64_t>(upper)), counts[k]});
+    }
+    return bins;
+}
+
+} // namespace llmquant
@@ -0,0 +1,143 @@
+#include "AsyncSinkDispatcher.h"
+
+#include <algorithm>
+
+#include "Pacing.h"
+
+namespace llmquant {
+
+AsyncSinkDispatcher::AsyncSinkDispatcher(std::vector<std::shared_ptr<OutputSink>> sinks, Config config)
+    : config_(config) {
+    if (config_.ring_capacity == 0) throw std::invalid_argument("AsyncSinkDispatcher: ring_capacity must be positive");
+    if (config_.batch_size == 0) throw std::invalid_argument("AsyncSinkDispatcher: batch_size must be positive");
+
+    size_t cap = 2;
+    while (cap < config_.ring_capacity) cap <<= 1;
+    for (auto& sink : sinks) {
+        if (!sink) throw std::invalid_argument("AsyncSinkDispatcher: null sink");
+        auto lane  = std::make_unique<Lane>();
+        lane->sink = std::move(sink);
+        lane->slots.resize(cap);
+        lane->mask = cap - 1;
+        lanes_.push_back(std::move(lane));
+    }
+    io_thread_ = std::thread([this] { run(); });
+}
+
+AsyncSinkDispatcher::~AsyncSinkDispatcher() {
+    close();
+}
+
+void AsyncSinkDispatcher::emit(const TradeSignal& sig) {
+    for (auto& lane_ptr : lanes_) {
+        Lane& lane = *lane_ptr;
+        const uint64_t tail = lane.tail.load(std::memory_order_relaxed);
+        if (closed_.load(std::memory_order_relaxed)) {
+            lane.dropped.store(lane.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            continue;
+        }
+        uint64_t head = lane.head.load(std::memory_order_acquire);
+        if (tail - head > lane.mask) {
+            if (config_.overflow == Overflow::Drop) {
+                lane.dropped.store(lane.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                continue;
+            }
+            for (uint32_t spins = 0; tail - head > lane.mask; ++spins) {
+                if (spins < 64) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+                head = lane.head.load(std::memory_order_acquire);
+            }
+        }
+        lane.slots[tail & lane.mask] = sig;
+        lane.tail.store(tail + 1, std::memory_order_release);
+
+        const uint64_t lag = tail + 1 - head;
+        if (lag > lane.max_lag.load(std::memory_order_relaxed)) lane.max_lag.store(lag, std::memory_order_relaxed);
+    }
+}
+
+void AsyncSinkDispatcher::flush() {
+    if (closed_.load(std::memory_order_relaxed)) return;   // close() already drained and flushed
+    const uint64_t ticket = flush_requested_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    for (uint32_t spins = 0; flush_completed_.load(std::memory_order_acquire) < ticket; ++spins) {
+        if (spins < 64) {
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void AsyncSinkDispatcher::close() {
+    closed_.store(true, std::memory_order_release);
+    if (io_thread_.joinable()) io_thread_.join();
+}
+
+AsyncSinkDispatcher::SinkStats AsyncSinkDispatcher::stats(size_t index) const {
+    if (index >= lanes_.size()) throw std::out_of_range("AsyncSinkDispatcher: sink index out of range");
+    const Lane& lane = *lanes_[index];
+    SinkStats s;
+    s.written  = lane.head.load(std::memory_order_acquire);
+    s.enqueued = lane.tail.load(std::memory_order_acquire);
+    s.dropped  = lane.dropped.load(std::memory_order_relaxed);
+    s.lag      = s.enqueued > s.written ? s.enqueued - s.written : 0;
+    s.max_lag  = lane.max_lag.load(std::memory_order_relaxed);
+    return s;
+}
+
+size_t AsyncSinkDispatcher::drain_pass() {
+    size_t total = 0;
+    for (auto& lane_ptr : lanes_) {
+        Lane& lane = *lane_ptr;
+        const uint64_t head  = lane.head.load(std::memory_order_relaxed);
+        const uint64_t tail  = lane.tail.load(std::memory_order_acquire);
+        const uint64_t count = std::min<uint64_t>(tail - head, config_.batch_size);
+        for (uint64_t i = 0; i < count; ++i) lane.sink->emit(lane.slots[(head + i) & lane.mask]);
+        if (count > 0) lane.head.store(head + count, std::memory_order_release);
+        total += count;
+    }
+    return total;
+}
+
+void AsyncSinkDispatcher::run() {
+    uint32_t idle = 0;
+    bool dirty = false;   // written since the last sink flush
+    while (true) {
+        // Signals emitted before a flush request are already in the rings,
+        // so draining to empty after reading the request covers them.
+        const uint64_t requested = flush_requested_.load(std::memory_order_acquire);
+        const bool closing = closed_.load(std::memory_order_acquire);
+
+        size_t n = 0;
+        while (true) {
+            const size_t pass = drain_pass();
+            n += pass;
+            if (pass == 0) break;
+            if (!closing && requested == flush_completed_.load(std::memory_order_relaxed)) break;
+        }
+        if (n > 0) {
+            dirty = true;
+            idle  = 0;
+            if (!closing && requested == flush_completed_.load(std::memory_order_relaxed)) continue;
+        }
+
+        // Caught up: flush the sinks once per catch-up, then answer waiters.
+        if (dirty) {
+            for (auto& lane : lanes_) lane->sink->flush();
+            dirty = false;
+        }
+        flush_completed_.store(requested, std::memory_order_release);
+        if (closing) break;
+
+        if (++idle < 64) {
+            cpu_relax();
+        } else {
+            std::this_thread::sleep_for(config_.idle_sleep);
+        }
+    }
+}
+
+} // namespace llmquant
@@ -0,0 +1,182 @@
+#include "CompiledLexicon.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace llmquant {
+
+namespace {
+
+// Average keys per bucket.  Larger buckets shrink the seed array but make the
+// seed search for the first (largest) buckets more expensive.
+constexpr size_t kKeysPerBucket = 4;
+
+// Seeds tried per multi-key bucket before the whole build is restarted with a
+// fresh hash seed.
+constexpr uint32_t kMaxSeedAttempts = 1u << 20;
+
+constexpr int kMaxBuildAttempts = 32;
+
+} // namespace
+
+CompiledLexicon::CompiledLexicon(const TokenWeightMap& entries) {
+    if (entries.empty()) return;
+    if (entries.size() >= kDirectSlot) {
+        throw std::length_error("CompiledLexicon: too many entries");
+    }
+
+    std::vector<std::pair<std::string_view, const SemanticWeight*>> keys;
+    keys.reserve(entries.size());
+    for (const auto& [token, weight] : entries) keys.emplace_back(token, &weight);
+
+    auto storage = std::make_shared<Storage>();
+    uint64_t seed = 0x243F6A8885A308D3ULL;
+    for (int attempt = 0; attempt < kMaxBuildAttempts; ++attempt) {
+        if (try_build(keys, seed, *storage)) {
+            key_pool_       = storage->key_pool.data();
+            key_pool_bytes_ = storage->key_pool.size();
+            owner_          = std::move(storage);
+            return;
+        }
+        seed = mix64(seed + 0x9E3779B97F4A7C15ULL);
+    }
+    // Only reachable with a pathological hash collision on every seed.
+    throw std::runtime_error("CompiledLexicon: failed to construct perfect hash");
+}
+
+bool CompiledLexicon::try_build(
+        const std::vector<std::pair<std::string_view, const SemanticWeight*>>& keys,
+        uint64_t seed, Storage& storage) {
+    const size_t n = keys.size();
+    auto& bucket_seeds = storage.bucket_seeds;
+    auto& slots        = storage.slots;
+    auto& key_pool     = storage.key_pool;
+    bucket_seeds.assign(std::max<size_t>(1, (n + kKeysPerBucket - 1) / kKeysPerBucket), 0);
+    slots.assign(n, Slot{});
+    key_pool.clear();
+
+    // Point the views at the storage so bucket_of()/slot_of() see its sizes.
+    hash_seed_    = seed;
+    bucket_seeds_ = bucket_seeds.data();
+    bucket_count_ = bucket_seeds.size();
+    slots_        = slots.data();
+    slot_count_   = n;
+
+    std::vector<uint64_t> hashes(n);
+    std::vector<std::vector<uint32_t>> buckets(bucket_count_);
+    for (size_t i = 0; i < n; ++i) {
+        hashes[i] = hash(keys[i].first, seed);
+        buckets[bucket_of(hashes[i])].push_back(static_cast<uint32_t>(i));
+    }
+
+    // Place the largest buckets first while the table is still mostly empty.
+    std::vector<uint32_t> order(buckets.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<bool> taken(n, false);
+    std::vector<uint32_t> positions;
+    size_t next_free = 0;
+
+    for (uint32_t b : order) {
+        const auto& members = buckets[b];
+        if (members.empty()) break;  // sorted: the rest are empty too
+
+        if (members.size() == 1) {
+            // Singletons go straight into the next free slot.
+            while (taken[next_free]) ++next_free;
+            taken[next_free] = true;
+            bucket_seeds[b] = kDirectSlot | static_cast<uint32_t>(next_free);
+            continue;
+        }
+
+        bool placed = false;
+        for (uint32_t s = 0; s < kMaxSeedAttempts && !placed; ++s) {
+            positions.clear();
+            placed = true;
+            for (uint32_t k : members) {
+                uint32_t pos = slot_of(hashes[k], s);
+                if (taken[pos] ||
+                    std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+                    placed = false;
+                    break;
+                }
+                positions.push_back(pos);
+            }
+            if (placed) {
+                for (uint32_t pos : positions) taken[pos] = true;
+                bucket_seeds[b] = s;
+            }
+        }
+        if (!placed) return false;
+    }
+
+    // Every key now has a unique slot; fill them in.
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t seed_or_slot = bucket_seeds_[bucket_of(hashes[i])];
+        const uint32_t pos = (seed_or_slot & kDirectSlot) ? (seed_or_slot & ~kDirectSlot)
+                                                         : slot_of(hashes[i], seed_or_slot);
+        const std::string_view key = keys[i].first;
+        Slot& slot = slots[pos];
+        slot.length = static_cast<uint32_t>(key.size());
+        slot.weight = *keys[i].second;
+        if (key.size() <= kInlineKeyBytes) {
+            std::memcpy(slot.inline_key, key.data(), key.size());
+        } else {
+            slot.pool_offset = static_cast<uint32_t>(key_pool.size());
+            key_pool.insert(key_pool.end(), key.begin(), key.end());
+        }
+    }
+    return true;
+}
+
+CompiledLexicon CompiledLexicon::adopt(const Image& image, std::shared_ptr<const void> owner) {
+    CompiledLexicon lex;
+    if (image.slot_count == 0) return lex;
+    if (image.slot_count >= kDirectSlot || image.bucket_count == 0 ||
+        !image.bucket_seeds || !image.slots ||
+        reinterpret_cast<uintptr_t>(image.slots) % alignof(Slot) != 0) {
+        throw std::runtime_error("CompiledLexicon: malformed image");
+    }
+
+    const auto* slots = static_cast<const Slot*>(image.slots);
+    for (size_t b = 0; b < image.bucket_count; ++b) {
+        const uint32_t s = image.bucket_seeds[b];
+        if ((s & kDirectSlot) && (s & ~kDirectSlot) >= image.slot_count) {
+            throw std::runtime_error("CompiledLexicon: bucket slot index out of range");
+        }
+    }
+    for (size_t i = 0; i < image.slot_count; ++i) {
+        const Slot& slot = slots[i];
+        if (slot.length > kInlineKeyBytes &&
+            static_cast<uint64_t>(slot.pool_offset) + slot.length > image.key_pool_bytes) {
+            throw std::runtime_error("CompiledLexicon: key pool reference out of range");
+        }
+    }
+
+    lex.hash_seed_      = image.hash_seed;
+    lex.bucket_seeds_   = image.bucket_seeds;
+    lex.bucket_count_   = image.bucket_count;
+    lex.slots_          = slots;
+    lex.slot_count_     = image.slot_count;
+    lex.key_pool_       = image.key_pool;
+    lex.key_pool_bytes_ = image.key_pool_bytes;
+    lex.owner_          = std::move(owner);
+    return lex;
+}
+
+CompiledLexicon::Image CompiledLexicon::image() const noexcept {
+    return Image{hash_seed_, bucket_seeds_, bucket_count_,
+                 slots_, slot_count_, key_pool_, key_pool_bytes_};
+}
+
+size_t CompiledLexicon::memory_bytes() const {
+    return bucket_count_ * sizeof(uint32_t)
+         + slot_count_ * sizeof(Slot)
+         + key_pool_bytes_;
+}
+
+} // namespace llmquant
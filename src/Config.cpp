@@ -25,8 +25,17 @@ bool Config::load_from_yaml_string(const std::string& yaml_content) {
             auto ts = yaml["token_stream"];
             if (ts["data_file_path"]) config_.token_stream.data_file_path = ts["data_file_path"].as<std::string>();
             if (ts["token_interval_ms"]) config_.token_stream.token_interval_ms = ts["token_interval_ms"].as<int>();
+            if (ts["token_interval_us"]) config_.token_stream.token_interval_us = ts["token_interval_us"].as<int>();
+            if (ts["pacing"]) config_.token_stream.pacing = ts["pacing"].as<std::string>();
+            if (ts["arrival_process"]) config_.token_stream.arrival_process = ts["arrival_process"].as<std::string>();
+            if (ts["arrival_seed"]) config_.token_stream.arrival_seed = ts["arrival_seed"].as<uint64_t>();
+            if (ts["burst_tokens"]) config_.token_stream.burst_tokens = ts["burst_tokens"].as<double>();
+            if (ts["burst_idle_ms"]) config_.token_stream.burst_idle_ms = ts["burst_idle_ms"].as<int>();
+            if (ts["arrival_journal_path"]) config_.token_stream.arrival_journal_path = ts["arrival_journal_path"].as<std::string>();
             if (ts["buffer_size"]) config_.token_stream.buffer_size = ts["buffer_size"].as<size_t>();
             if (ts["use_memory_stream"]) config_.token_stream.use_memory_stream = ts["use_memory_stream"].as<bool>();
+            if (ts["ingest_queue_capacity"]) config_.token_stream.ingest_queue_capacity = ts["ingest_queue_capacity"].as<size_t>();
+            if (ts["ingest_overflow"]) config_.token_stream.ingest_overflow = ts["ingest_overflow"].as<std::string>();
         }
         
         // Trading settings
@@ -36,6 +45,10 @@ bool Config::load_from_yaml_string(const std::string& yaml_content) {
             if (t["volatility_sensitivity"]) config_.trading.volatility_sensitivity = t["volatility_sensitivity"].as<double>();
             if (t["signal_decay_rate"]) config_.trading.signal_decay_rate = t["signal_decay_rate"].as<double>();
             if (t["signal_cooldown_us"]) config_.trading.signal_cooldown_us = t["signal_cooldown_us"].as<int>();
+            if (t["decay_time_constant_us"]) config_.trading.decay_time_constant_us = t["decay_time_constant_us"].as<int64_t>();
+            if (t["ewma_fast_ms"]) config_.trading.ewma_fast_ms = t["ewma_fast_ms"].as<int>();
+            if (t["ewma_medium_ms"]) config_.trading.ewma_medium_ms = t["ewma_medium_ms"].as<int>();
+            if (t["ewma_slow_ms"]) config_.trading.ewma_slow_ms = t["ewma_slow_ms"].as<int>();
         }
         
         // Latency settings
@@ -53,6 +66,27 @@ bool Config::load_from_yaml_string(const std::string& yaml_content) {
             if (log["format"]) config_.logging.format = log["format"].as<std::string>();
             if (log["enable_console"]) config_.logging.enable_console = log["enable_console"].as<bool>();
             if (log["flush_interval_ms"]) config_.logging.flush_interval_ms = log["flush_interval_ms"].as<int>();
+            if (log["signal_file_path"]) config_.logging.signal_file_path = log["signal_file_path"].as<std::string>();
+            if (log["sink_ring_capacity"]) config_.logging.sink_ring_capacity = log["sink_ring_capacity"].as<size_t>();
+            if (log["sink_overflow"]) config_.logging.sink_overflow = log["sink_overflow"].as<std::string>();
+        }
+        
+        // Semantic dictionary settings
+        if (yaml["semantic_weights"]) {
+            auto sw = yaml["semantic_weights"];
+            if (sw["dictionary_path"]) config_.semantic_weights.dictionary_path = sw["dictionary_path"].as<std::string>();
+            if (sw["bullish_multiplier"]) config_.semantic_weights.bullish_multiplier = sw["bullish_multiplier"].as<double>();
+            if (sw["bearish_multiplier"]) config_.semantic_weights.bearish_multiplier = sw["bearish_multiplier"].as<double>();
+            if (sw["volatility_multiplier"]) config_.semantic_weights.volatility_multiplier = sw["volatility_multiplier"].as<double>();
+            if (sw["negators"]) config_.semantic_weights.negators = sw["negators"].as<std::vector<std::string>>();
+            if (sw["intensifiers"]) config_.semantic_weights.intensifiers = sw["intensifiers"].as<std::map<std::string, double>>();
+            if (sw["context_window"]) config_.semantic_weights.context_window = sw["context_window"].as<int>();
+        }
+
+        if (yaml["symbols"]) {
+            auto sy = yaml["symbols"];
+            if (sy["tickers"]) config_.symbols.tickers = sy["tickers"].as<std::map<std::string, std::vector<std::string>>>();
+            if (sy["attribution_window"]) config_.symbols.attribution_window = sy["attribution_window"].as<int>();
         }
         
         return true;
@@ -69,14 +103,27 @@ void Config::save_to_file(const std::string& filepath) const {
     // Token stream
     yaml["token_stream"]["data_file_path"] = config_.token_stream.data_file_path;
     yaml["token_stream"]["token_interval_ms"] = config_.token_stream.token_interval_ms;
+    yaml["token_stream"]["token_interval_us"] = config_.token_stream.token_interval_us;
+    yaml["token_stream"]["pacing"] = config_.token_stream.pacing;
+    yaml["token_stream"]["arrival_process"] = config_.token_stream.arrival_process;
+    yaml["token_stream"]["arrival_seed"] = config_.token_stream.arrival_seed;
+    yaml["token_stream"]["burst_tokens"] = config_.token_stream.burst_tokens;
+    yaml["token_stream"]["burst_idle_ms"] = config_.token_stream.burst_idle_ms;
+    yaml["token_stream"]["arrival_journal_path"] = config_.token_stream.arrival_journal_path;
     yaml["token_stream"]["buffer_size"] = config_.token_stream.buffer_size;
     yaml["token_stream"]["use_memory_stream"] = config_.token_stream.use_memory_stream;
+    yaml["token_stream"]["ingest_queue_capacity"] = config_.token_stream.ingest_queue_capacity;
+    yaml["token_stream"]["ingest_overflow"] = config_.token_stream.ingest_overflow;
     
     // Trading
     yaml["trading"]["bias_sensitivity"] = config_.trading.bias_sensitivity;
     yaml["trading"]["volatility_sensitivity"] = config_.trading.volatility_sensitivity;
     yaml["trading"]["signal_decay_rate"] = config_.trading.signal_decay_rate;
     yaml["trading"]["signal_cooldown_us"] = config_.trading.signal_cooldown_us;
+    yaml["trading"]["decay_time_constant_us"] = config_.trading.decay_time_constant_us;
+    yaml["trading"]["ewma_fast_ms"] = config_.trading.ewma_fast_ms;
+    yaml["trading"]["ewma_medium_ms"] = config_.trading.ewma_medium_ms;
+    yaml["trading"]["ewma_slow_ms"] = config_.trading.ewma_slow_ms;
     
     // Latency
     yaml["latency"]["target_latency_us"] = config_.latency.target_latency_us;
@@ -88,6 +135,20 @@ void Config::save_to_file(const std::string& filepath) const {
     yaml["logging"]["format"] = config_.logging.format;
     yaml["logging"]["enable_console"] = config_.logging.enable_console;
     yaml["logging"]["flush_interval_ms"] = config_.logging.flush_interval_ms;
+    yaml["logging"]["signal_file_path"] = config_.logging.signal_file_path;
+    yaml["logging"]["sink_ring_capacity"] = config_.logging.sink_ring_capacity;
+    yaml["logging"]["sink_overflow"] = config_.logging.sink_overflow;
+    
+    // Semantic weights
+    yaml["semantic_weights"]["dictionary_path"] = config_.semantic_weights.dictionary_path;
+    yaml["semantic_weights"]["bullish_multiplier"] = config_.semantic_weights.bullish_multiplier;
+    yaml["semantic_weights"]["bearish_multiplier"] = config_.semantic_weights.bearish_multiplier;
+    yaml["semantic_weights"]["volatility_multiplier"] = config_.semantic_weights.volatility_multiplier;
+    yaml["semantic_weights"]["negators"] = config_.semantic_weights.negators;
+    yaml["semantic_weights"]["intensifiers"] = config_.semantic_weights.intensifiers;
+    yaml["semantic_weights"]["context_window"] = config_.semantic_weights.context_window;
+    yaml["symbols"]["tickers"] = config_.symbols.tickers;
+    yaml["symbols"]["attribution_window"] = config_.symbols.attribution_window;
     
     std::ofstream file(filepath);
     file << yaml;
@@ -97,6 +158,10 @@ void Config::set_defaults() {
     // Defaults are already set in SystemConfig struct initialization
 }
 
+void Config::set_dictionary_callback(std::function<void(const std::string&)> callback) {
+    on_dictionary_change_ = std::move(callback);
+}
+
 void Config::start_watching(const std::string& filepath,
                             std::function<void(const SystemConfig&)> on_reload,
                             int poll_interval_ms) {
@@ -106,11 +171,16 @@ void Config::start_watching(const std::string& filepath,
     watcher_thread_ = std::thread([this, filepath, on_reload, poll_interval_ms]() {
         namespace fs = std::filesystem;
         std::filesystem::file_time_type last_mtime{};
+        std::string dict_path = config_.semantic_weights.dictionary_path;
+        std::filesystem::file_time_type dict_mtime{};
 
-        // Capture the initial mtime so we don't fire immediately.
+        // Capture the initial mtimes so we don't fire immediately.
         try {
             last_mtime = fs::last_write_time(filepath);
         } catch (...) {}
+        try {
+            if (!dict_path.empty()) dict_mtime = fs::last_write_time(dict_path);
+        } catch (...) {}
 
         while (watching_.load()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval_ms));
@@ -125,6 +195,27 @@ void Config::start_watching(const std::string& filepath,
             } catch (...) {
                 // File temporarily unavailable during write — retry next poll.
             }
+
+            if (!on_dictionary_change_) continue;
+            try {
+                const std::string& path = config_.semantic_weights.dictionary_path;
+                if (path != dict_path) {
+                    // Config now points at a different dictionary: load it
+                    // outright, or drop the old one if none is named.
+                    dict_path  = path;
+                    dict_mtime = {};
+                    if (!dict_path.empty()) dict_mtime = fs::last_write_time(dict_path);
+                    on_dictionary_change_(dict_path);
+                } else if (!dict_path.empty()) {
+                    auto mtime = fs::last_write_time(dict_path);
+                    if (mtime != dict_mtime) {
+                        dict_mtime = mtime;
+                        on_dictionary_change_(dict_path);
+                    }
+                }
+            } catch (...) {
+                // Dictionary missing or mid-write — retry next poll.
+            }
         }
     });
 }
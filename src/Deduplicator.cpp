@@ -1,5 +1,6 @@
 #include "Deduplicator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <sstream>
 
@@ -34,10 +35,20 @@ DedupKey DedupKey::from_token(const std::string& token, const std::string& conte
 // InProcessDeduplicator
 // ---------------------------------------------------------------------------
 
+InProcessDeduplicator::InProcessDeduplicator(std::shared_ptr<Clock> clock)
+    : clock_(std::move(clock)) {}
+
+std::chrono::steady_clock::time_point InProcessDeduplicator::now() const noexcept {
+    if (!clock_) return std::chrono::steady_clock::now();
+    // Only differences matter, so the injected clock's epoch is reused as-is.
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(clock_->now().time_since_epoch()));
+}
+
 DedupResult InProcessDeduplicator::check_and_register(const DedupKey& key,
                                                        std::chrono::milliseconds ttl) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto now = std::chrono::steady_clock::now();
+    auto now = this->now();
 
     auto it = table_.find(key);
     if (it != table_.end()) {
@@ -61,14 +72,42 @@ void InProcessDeduplicator::evict(const DedupKey& key) {
     table_.erase(key);
 }
 
+DedupResult InProcessDeduplicator::check_and_register_id(TokenId id, std::string_view text,
+                                                          std::chrono::milliseconds ttl) {
+    if (id >= IdExpiry::kCapacity) return DeduplicatorBackend::check_and_register_id(id, text, ttl);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = this->now();
+
+    auto& expires_at = id_expiry_.ensure(id);
+    id_limit_ = std::max(id_limit_, static_cast<size_t>(id) + 1);
+    if (expires_at > now) {
+        total_duplicates_++;
+        return DedupResult::Duplicate;
+    }
+    if (expires_at == std::chrono::steady_clock::time_point{}) id_entries_++;
+    expires_at = now + ttl;
+    total_novel_++;
+    return DedupResult::Novel;
+}
+
+void InProcessDeduplicator::evict_id(TokenId id, std::string_view text) {
+    if (id >= IdExpiry::kCapacity) return DeduplicatorBackend::evict_id(id, text);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* expires_at = id_expiry_.find(id);
+    if (expires_at && *expires_at != std::chrono::steady_clock::time_point{}) {
+        *expires_at = {};
+        id_entries_--;
+    }
+}
+
 size_t InProcessDeduplicator::size() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return table_.size();
+    return table_.size() + id_entries_;
 }
 
 void InProcessDeduplicator::purge_expired() {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto now = std::chrono::steady_clock::now();
+    auto now = this->now();
     for (auto it = table_.begin(); it != table_.end(); ) {
         if (it->second.expires_at <= now) {
             it = table_.erase(it);
@@ -76,6 +115,16 @@ void InProcessDeduplicator::purge_expired() {
             ++it;
         }
     }
+    for (size_t first = 0; first < id_limit_; first += IdExpiry::kChunkSize) {
+        auto* chunk = id_expiry_.find(static_cast<TokenId>(first));
+        if (!chunk) continue;
+        for (size_t i = 0; i < IdExpiry::kChunkSize; ++i) {
+            if (chunk[i] != std::chrono::steady_clock::time_point{} && chunk[i] <= now) {
+                chunk[i] = {};
+                id_entries_--;
+            }
+        }
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -195,6 +244,10 @@ DedupResult Deduplicator::check(const std::string& token, const std::string& con
     return backend_->check_and_register(DedupKey::from_token(token, context), default_ttl_);
 }
 
+DedupResult Deduplicator::check(TokenId id, std::string_view text) {
+    return backend_->check_and_register_id(id, text, default_ttl_);
+}
+
 DedupResult Deduplicator::check_with_ttl(const DedupKey& key, std::chrono::milliseconds ttl) {
     return backend_->check_and_register(key, ttl);
 }
@@ -203,6 +256,10 @@ void Deduplicator::evict(const std::string& token, const std::string& context) {
     backend_->evict(DedupKey::from_token(token, context));
 }
 
+void Deduplicator::evict(TokenId id, std::string_view text) {
+    backend_->evict_id(id, text);
+}
+
 void Deduplicator::purge_expired() { backend_->purge_expired(); }
 
 } // namespace llmquant
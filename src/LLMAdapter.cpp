@@ -1,40 +1,55 @@
 #include "LLMAdapter.h"
-#include <fstream>
-#include <sstream>
+#include "TokenNormalizer.h"
+#include "WeightKernels.h"
 #include <algorithm>
 #include <numeric>
-#include <immintrin.h>  // SSE2/AVX2 intrinsics
 
 namespace llmquant {
 
-LLMAdapter::LLMAdapter() {
+LLMAdapter::LLMAdapter(WeightStorage storage) : storage_(storage) {
     initialize_default_mappings();
+    freeze();
 }
 
-SemanticWeight LLMAdapter::map_token_to_weight(const std::string& token) const {
-    stats_.tokens_processed++;
+LLMAdapter::Stats LLMAdapter::get_stats() const {
+    Stats s;
+#ifndef LLMQUANT_DISABLE_ADAPTER_STATS
+    s.tokens_processed = stats_.load(kTokensProcessed);
+    s.cache_hits       = stats_.load(kCacheHits);
+    s.cache_misses     = stats_.load(kCacheMisses);
+    s.phrase_matches   = stats_.load(kPhraseMatches);
+#endif
+    return s;
+}
+
+const SemanticWeight* LLMAdapter::Lexicon::find(std::string_view normalized) const {
+    if (file_layer) {
+        if (const SemanticWeight* w = file_layer->find(normalized)) return w;
+    }
+    if (compiled) return compiled->find(normalized);
+    auto it = weights.find(normalized);
+    return it != weights.end() ? &it->second : nullptr;
+}
+
+void LLMAdapter::Lexicon::clear_id_weights() const {
+    id_weights.clear();
+    compact_id_weights.clear();
+}
 
-    // Normalize: strip leading/trailing whitespace, lowercase.
-    // GPT-4o streams tokens like " bullish" or "Bullish" that must map to "bullish".
-    std::string norm;
-    norm.reserve(token.size());
-    size_t start = 0;
-    while (start < token.size() && std::isspace(static_cast<unsigned char>(token[start]))) ++start;
-    size_t end = token.size();
-    while (end > start && std::isspace(static_cast<unsigned char>(token[end - 1]))) --end;
-    for (size_t i = start; i < end; ++i)
-        norm += static_cast<char>(std::tolower(static_cast<unsigned char>(token[i])));
+SemanticWeight LLMAdapter::map_token_to_weight(std::string_view token) const {
+    count(kTokensProcessed);
 
-    auto it = token_weights_.find(norm);
-    if (it != token_weights_.end()) {
-        stats_.cache_hits++;
-        return it->second;
+    EpochGuard guard;
+    NormalizeBuffer buf;
+    if (const SemanticWeight* w = lexicon_.load()->find(normalize_token(token, buf))) {
+        count(kCacheHits);
+        return *w;
     }
 
-    stats_.cache_misses++;
+    count(kCacheMisses);
 
     // Default neutral weight for unknown tokens
-    return SemanticWeight{0.0, 0.5, 0.1, 0.0};
+    return kUnknownTokenWeight;
 }
 
 SemanticWeight LLMAdapter::map_sequence_to_weight(const std::vector<std::string>& tokens) const {
@@ -49,112 +64,302 @@ SemanticWeight LLMAdapter::map_sequence_to_weight(const std::vector<std::string>
         weights.push_back(map_token_to_weight(token));
     }
     
-    // Aggregate weights (simple average with confidence weighting)
-    double total_confidence = 0.0;
-    SemanticWeight result{0.0, 0.0, 0.0, 0.0};
-    
-    for (const auto& w : weights) {
-        total_confidence += w.confidence_score;
-        result.sentiment_score += w.sentiment_score * w.confidence_score;
-        result.volatility_score += w.volatility_score * w.confidence_score;
-        result.directional_bias += w.directional_bias * w.confidence_score;
+    return aggregate_scalar(weights, 0, weights.size());
+}
+
+void LLMAdapter::load_sentiment_dictionary(const std::string& filepath) {
+    const auto [weights, phrases] = read_text_dictionary(filepath);
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Lexicon& lex = *lexicon_.load();
+    for (const auto& [token, weight] : weights) {
+        base_weights_[token] = weight;
+        lex.weights[token]   = weight;
     }
-    
-    if (total_confidence > 0.0) {
-        result.sentiment_score /= total_confidence;
-        result.volatility_score /= total_confidence;
-        result.directional_bias /= total_confidence;
-        result.confidence_score = total_confidence / tokens.size();
+    if (!weights.empty()) {
+        lex.compiled.reset();
+        lex.clear_id_weights();
+    }
+    if (!phrases.empty()) {
+        base_phrases_.insert(base_phrases_.end(), phrases.begin(), phrases.end());
+        lex.phrase_list.insert(lex.phrase_list.end(), phrases.begin(), phrases.end());
+        lex.phrases    = compile_phrases(lex.phrase_list);
+        lex.generation = ++generation_;
     }
-    
-    return result;
 }
 
-void LLMAdapter::load_sentiment_dictionary(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open sentiment dictionary: " + filepath);
+void LLMAdapter::reload_sentiment_dictionary(const std::string& filepath) {
+    std::optional<CompiledLexicon> file_layer;
+    DictionaryEntries file;
+    if (is_binary_lexicon(filepath)) {
+        BinaryLexicon binary = open_binary_lexicon(filepath);
+        file_layer.emplace(std::move(binary.tokens));
+        file.phrases = std::move(binary.phrases);
+    } else {
+        file = read_text_dictionary(filepath);
     }
-    
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string token;
-        double sentiment, confidence, volatility, bias;
-        
-        if (iss >> token >> sentiment >> confidence >> volatility >> bias) {
-            add_token_mapping(token, {sentiment, confidence, volatility, bias});
-        }
+    publish_overlay(std::move(file), std::move(file_layer));
+}
+
+void LLMAdapter::clear_sentiment_dictionary() {
+    publish_overlay(DictionaryEntries{}, std::nullopt);
+}
+
+void LLMAdapter::publish_overlay(DictionaryEntries file, std::optional<CompiledLexicon> file_layer) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    auto next = std::make_unique<Lexicon>();
+    next->weights = base_weights_;
+    for (const auto& [token, weight] : file.tokens) next->weights[token] = weight;
+    next->file_layer  = std::move(file_layer);
+    next->phrase_list = base_phrases_;
+    next->phrase_list.insert(next->phrase_list.end(), file.phrases.begin(), file.phrases.end());
+
+    next->compiled.emplace(next->weights);
+    next->phrases    = compile_phrases(next->phrase_list);
+    next->generation = ++generation_;
+    lexicon_.store(std::move(next));
+}
+
+void LLMAdapter::add_phrase_mapping(const std::string& phrase, const SemanticWeight& weight) {
+    DictionaryEntries entry;
+    add_dictionary_entry(phrase, weight, entry);
+    if (!entry.tokens.empty()) {
+        add_token_mapping(entry.tokens.begin()->first, weight);
+        return;
     }
+    if (entry.phrases.empty()) return;
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Lexicon& lex = *lexicon_.load();
+    base_phrases_.push_back(entry.phrases.front());
+    lex.phrase_list.push_back(std::move(entry.phrases.front()));
+    lex.phrases    = compile_phrases(lex.phrase_list);
+    lex.generation = ++generation_;
+}
+
+PhraseMatcher LLMAdapter::compile_phrases(const PhraseList& phrases) const {
+    if (!vocabulary_ || phrases.empty()) return PhraseMatcher{};
+
+    std::vector<PhraseMatcher::Phrase> compiled;
+    compiled.reserve(phrases.size());
+    for (const auto& [words, weight] : phrases) {
+        PhraseMatcher::Phrase p{{}, weight};
+        for (const auto& w : words) p.tokens.push_back(vocabulary_->intern(w));
+        compiled.push_back(std::move(p));
+    }
+    return PhraseMatcher(compiled);
+}
+
+size_t LLMAdapter::phrase_count() const {
+    EpochGuard guard;
+    return lexicon_.load()->phrases.phrase_count();
 }
 
 void LLMAdapter::add_token_mapping(const std::string& token, const SemanticWeight& weight) {
-    token_weights_[token] = weight;
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Lexicon& lex = *lexicon_.load();
+    base_weights_[token] = weight;
+    lex.weights[token]   = weight;
+    lex.compiled.reset();
+    lex.clear_id_weights();
+}
+
+void LLMAdapter::bind_vocabulary(std::shared_ptr<TokenVocabulary> vocabulary) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    vocabulary_ = std::move(vocabulary);
+    Lexicon& lex = *lexicon_.load();
+    lex.clear_id_weights();
+    lex.phrases    = compile_phrases(lex.phrase_list);
+    lex.generation = ++generation_;
+    if (vocabulary_) context_.compile(context_rules_, *vocabulary_);
+}
+
+void LLMAdapter::set_context_rules(const ContextRules& rules) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    context_rules_ = rules;
+    if (vocabulary_) context_.compile(context_rules_, *vocabulary_);
+}
+
+void LLMAdapter::freeze() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Lexicon& lex = *lexicon_.load();
+    lex.compiled.emplace(lex.weights);
+}
+
+bool LLMAdapter::is_frozen() const {
+    EpochGuard guard;
+    return lexicon_.load()->compiled.has_value();
+}
+
+SemanticWeight LLMAdapter::map_token_id(TokenId id) const {
+    EpochGuard guard;
+    return map_token_id_in(*lexicon_.load(), id);
+}
+
+SemanticWeight LLMAdapter::map_token_id(TokenId id, StreamState& stream) const {
+    EpochGuard guard;
+    const Lexicon& lex = *lexicon_.load();
+    if (stream.lexicon_generation != lex.generation) {
+        stream.phrase_state       = PhraseMatcher::kRoot;
+        stream.lexicon_generation = lex.generation;
+    }
+
+    SemanticWeight weight = map_token_id_in(lex, id);
+    if (const PhraseMatcher::Match* m = lex.phrases.advance(stream.phrase_state, id)) {
+        count(kPhraseMatches);
+        weight = m->weight;
+    }
+    return context_.apply(stream.context, id, weight);
+}
+
+SemanticWeight LLMAdapter::map_token_id_in(const Lexicon& lex, TokenId id) const {
+    count(kTokensProcessed);
+
+    uint8_t state;
+    SemanticWeight weight;
+    if (storage_ == WeightStorage::Int16) {
+        const CompactIdWeight& slot = compact_id_slot(lex, id);
+        state  = slot.state.load(std::memory_order_relaxed);
+        weight = dequantize_weight(slot.weight);
+    } else {
+        const IdWeight& slot = id_slot(lex, id);
+        state  = slot.state.load(std::memory_order_relaxed);
+        weight = slot.weight;
+    }
+
+    if (state == IdWeight::kKnown) {
+        count(kCacheHits);
+    } else {
+        count(kCacheMisses);
+    }
+    return weight;
+}
+
+const SemanticWeight* LLMAdapter::find_id(const Lexicon& lex, TokenId id) const {
+    if (!vocabulary_) {
+        throw std::logic_error("LLMAdapter::map_token_id called without a bound vocabulary");
+    }
+    // Vocabulary text is already normalised.
+    return lex.find(vocabulary_->text(id));
+}
+
+const LLMAdapter::IdWeight& LLMAdapter::resolve_id(const Lexicon& lex, TokenId id) const {
+    const SemanticWeight* w = find_id(lex, id);
+
+    std::lock_guard<std::mutex> lock(lex.id_resolve_mutex);
+    IdWeight& slot = lex.id_weights.ensure(id);
+    if (slot.state.load(std::memory_order_relaxed) == IdWeight::kUnresolved) {
+        slot.weight = w ? *w : kUnknownTokenWeight;
+        slot.state.store(w ? IdWeight::kKnown : IdWeight::kUnknown, std::memory_order_release);
+    }
+    return slot;
+}
+
+const LLMAdapter::CompactIdWeight& LLMAdapter::resolve_compact_id(const Lexicon& lex,
+                                                                  TokenId id) const {
+    const SemanticWeight* w = find_id(lex, id);
+
+    std::lock_guard<std::mutex> lock(lex.id_resolve_mutex);
+    CompactIdWeight& slot = lex.compact_id_weights.ensure(id);
+    if (slot.state.load(std::memory_order_relaxed) == IdWeight::kUnresolved) {
+        slot.weight = quantize_weight(w ? *w : kUnknownTokenWeight);
+        slot.state.store(w ? IdWeight::kKnown : IdWeight::kUnknown, std::memory_order_release);
+    }
+    return slot;
 }
 
 SemanticWeight LLMAdapter::map_sequence_simd(const std::vector<std::string>& tokens) const {
     if (tokens.empty()) return SemanticWeight{0.0, 0.0, 0.0, 0.0};
 
-    // Resolve all tokens to weights first (single-token lookup is already O(1)).
-    std::vector<SemanticWeight> weights;
-    weights.reserve(tokens.size());
-    for (const auto& t : tokens) weights.push_back(map_token_to_weight(t));
-
-    const size_t n = weights.size();
-
-    // SIMD accumulators: [sentiment*conf, volatility*conf] packed as two doubles.
-    __m128d acc_sv = _mm_setzero_pd();   // sentiment * confidence, volatility * confidence
-    __m128d acc_db = _mm_setzero_pd();   // directional_bias * confidence, confidence
-    __m128d acc_c  = _mm_setzero_pd();   // confidence, confidence (for denominator)
-
-    size_t i = 0;
-    // Process pairs with SSE2.
-    for (; i + 1 < n; i += 2) {
-        const auto& w0 = weights[i];
-        const auto& w1 = weights[i + 1];
-
-        __m128d s  = _mm_set_pd(w1.sentiment_score,   w0.sentiment_score);
-        __m128d v  = _mm_set_pd(w1.volatility_score,  w0.volatility_score);
-        __m128d d  = _mm_set_pd(w1.directional_bias,  w0.directional_bias);
-        __m128d c  = _mm_set_pd(w1.confidence_score,  w0.confidence_score);
-
-        acc_sv = _mm_add_pd(acc_sv, _mm_mul_pd(s, c));
-        // reuse acc_db second lane for volatility*conf
-        __m128d vc = _mm_mul_pd(v, c);
-        __m128d dc = _mm_mul_pd(d, c);
-        // pack volatility*conf and directional*conf together temporarily
-        acc_db = _mm_add_pd(acc_db, _mm_unpacklo_pd(dc, vc));
-        acc_c  = _mm_add_pd(acc_c,  c);
-    }
-
-    // Horizontal sum the SSE2 registers.
-    double buf_sv[2], buf_db[2], buf_c[2];
-    _mm_storeu_pd(buf_sv, acc_sv);
-    _mm_storeu_pd(buf_db, acc_db);
-    _mm_storeu_pd(buf_c,  acc_c);
-
-    [[maybe_unused]] double sum_s  = buf_sv[0] + buf_sv[1];
-    [[maybe_unused]] double sum_dc = buf_db[0] + buf_db[1];   // directional * conf
-    [[maybe_unused]] double sum_vc = 0.0;                      // volatility  * conf — see below
-    double total_conf = buf_c[0] + buf_c[1];
-
-    // The volatility lane is stored in the high double of acc_db after unpacklo;
-    // retrieve from a separate scalar accumulation to keep the code clear.
-    // (Scalar cleanup also handles this for the remainder below.)
-
-    // Scalar cleanup for remainder and volatility accumulation.
-    auto scalar_part = aggregate_scalar(weights, i, n);
-    // Merge scalar part into SIMD totals weighted by their confidence sums.
-    double scalar_conf = scalar_part.confidence_score * static_cast<double>(n - i);
-
-    SemanticWeight result;
-    double grand_conf = total_conf + scalar_conf;
-    if (grand_conf > 0.0) {
-        // For simplicity, re-aggregate the full vector scalar-side and blend.
-        // The SIMD path accelerates the hot loop; correctness comes from scalar.
-        result = aggregate_scalar(weights, 0, n);
+    // Resolve tokens a chunk at a time into stack-resident columns, then let
+    // the vector kernel consume each chunk.  No heap allocation, and the stat
+    // counters are bumped once per call instead of once per token.
+    alignas(32) double sentiment[kSimdChunk];
+    alignas(32) double confidence[kSimdChunk];
+    alignas(32) double volatility[kSimdChunk];
+    alignas(32) double bias[kSimdChunk];
+
+    WeightSums sums;
+    uint64_t hits = 0;
+    NormalizeBuffer buf;
+    EpochGuard guard;
+    const Lexicon& lex = *lexicon_.load();
+
+    for (size_t base = 0; base < tokens.size(); base += kSimdChunk) {
+        const size_t n = std::min(kSimdChunk, tokens.size() - base);
+        for (size_t j = 0; j < n; ++j) {
+            const SemanticWeight* w = lex.find(normalize_token(tokens[base + j], buf));
+            if (w) {
+                ++hits;
+            } else {
+                w = &kUnknownTokenWeight;
+            }
+            sentiment[j]  = w->sentiment_score;
+            confidence[j] = w->confidence_score;
+            volatility[j] = w->volatility_score;
+            bias[j]       = w->directional_bias;
+        }
+        sums += accumulate_weights({sentiment, confidence, volatility, bias, n});
+    }
+
+    count(kTokensProcessed, tokens.size());
+    count(kCacheHits,       hits);
+    count(kCacheMisses,     tokens.size() - hits);
+    return finish_sums(sums, tokens.size());
+}
+
+SemanticWeight LLMAdapter::map_id_sequence(const std::vector<TokenId>& ids) const {
+    if (ids.empty()) return SemanticWeight{0.0, 0.0, 0.0, 0.0};
+
+    WeightSums sums;
+    uint64_t hits = 0;
+    EpochGuard guard;
+    const Lexicon& lex = *lexicon_.load();
+
+    if (storage_ == WeightStorage::Int16) {
+        // Gather the packed weights as stored; the kernel dequantizes.
+        QuantizedWeight packed[kSimdChunk];
+        for (size_t base = 0; base < ids.size(); base += kSimdChunk) {
+            const size_t n = std::min(kSimdChunk, ids.size() - base);
+            for (size_t j = 0; j < n; ++j) {
+                const CompactIdWeight& slot = compact_id_slot(lex, ids[base + j]);
+                hits += slot.state.load(std::memory_order_relaxed) == IdWeight::kKnown;
+                packed[j] = slot.weight;
+            }
+            sums += accumulate_quantized(packed, n);
+        }
     } else {
-        result = SemanticWeight{0.0, 0.0, 0.0, 0.0};
+        alignas(32) double sentiment[kSimdChunk];
+        alignas(32) double confidence[kSimdChunk];
+        alignas(32) double volatility[kSimdChunk];
+        alignas(32) double bias[kSimdChunk];
+        for (size_t base = 0; base < ids.size(); base += kSimdChunk) {
+            const size_t n = std::min(kSimdChunk, ids.size() - base);
+            for (size_t j = 0; j < n; ++j) {
+                const IdWeight& slot = id_slot(lex, ids[base + j]);
+                hits += slot.state.load(std::memory_order_relaxed) == IdWeight::kKnown;
+                sentiment[j]  = slot.weight.sentiment_score;
+                confidence[j] = slot.weight.confidence_score;
+                volatility[j] = slot.weight.volatility_score;
+                bias[j]       = slot.weight.directional_bias;
+            }
+            sums += accumulate_weights({sentiment, confidence, volatility, bias, n});
+        }
+    }
+
+    count(kTokensProcessed, ids.size());
+    count(kCacheHits,       hits);
+    count(kCacheMisses,     ids.size() - hits);
+    return finish_sums(sums, ids.size());
+}
+
+SemanticWeight LLMAdapter::finish_sums(const WeightSums& sums, size_t count) {
+    SemanticWeight result{0.0, 0.0, 0.0, 0.0};
+    if (sums.confidence > 0.0) {
+        result.sentiment_score  = sums.sentiment  / sums.confidence;
+        result.volatility_score = sums.volatility / sums.confidence;
+        result.directional_bias = sums.bias       / sums.confidence;
+        result.confidence_score = sums.confidence / static_cast<double>(count);
     }
     return result;
 }
@@ -245,6 +450,12 @@ void LLMAdapter::initialize_default_mappings() {
     add_token_mapping("in",        {0.0,  0.1,  0.0,  0.0});
     add_token_mapping("of",        {0.0,  0.1,  0.0,  0.0});
     add_token_mapping("to",        {0.0,  0.1,  0.0,  0.0});
+
+    // Multi-token phrases — streams often split these across deltas
+    add_phrase_mapping("sell off",      {-0.8, 0.85, 0.80, -0.75});
+    add_phrase_mapping("break down",    {-0.8, 0.85, 0.80, -0.80});
+    add_phrase_mapping("break out",     {0.4,  0.70, 0.70,  0.60});
+    add_phrase_mapping("short squeeze", {0.6,  0.85, 0.90,  0.85});
 }
 
 } // namespace llmquant
\ No newline at end of file
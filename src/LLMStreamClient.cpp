@@ -1,4 +1,5 @@
 #include "LLMStreamClient.h"
+#include "TokenJournal.h"
 
 #ifdef LLMQUANT_TLS_ENABLED
   #include <openssl/ssl.h>
@@ -77,8 +78,14 @@ LLMStreamClient::~LLMStreamClient() {
 }
 
 void LLMStreamClient::set_token_callback(TokenCallback cb) { token_cb_ = std::move(cb); }
+void LLMStreamClient::set_batch_callback(TokenBatchCallback cb) { batch_cb_ = std::move(cb); }
 void LLMStreamClient::set_done_callback(DoneCallback cb)   { done_cb_  = std::move(cb); }
 
+void LLMStreamClient::set_journal(std::shared_ptr<TokenJournalWriter> journal, uint32_t stream_id) {
+    journal_           = std::move(journal);
+    journal_stream_id_ = stream_id;
+}
+
 bool LLMStreamClient::connect() {
     if (running_.load()) return false;
     // The reader_thread opens (and re-opens) its own socket per request,
@@ -318,6 +325,10 @@ void LLMStreamClient::reader_thread() {
         // --debug-raw: dump all bytes to stderr for 3 seconds then stop.
         auto debug_start = std::chrono::steady_clock::now();
 
+        // Batch mode: tokens decoded from one read, delivered together.
+        std::vector<std::string>   batch_text;
+        std::vector<ReceivedToken> batch;
+
         char chunk[4096];
         while (running_.load() && !stream_done) {
             ssize_t n;
@@ -331,6 +342,7 @@ void LLMStreamClient::reader_thread() {
             }
 #endif
             if (n <= 0) break;
+            const uint64_t received_ns = monotonic_ns();
             chunk[n] = '\0';
             buf.append(chunk, static_cast<size_t>(n));
 
@@ -377,10 +389,24 @@ void LLMStreamClient::reader_thread() {
                     std::string payload = line.substr(6);
                     if (payload == "[DONE]") { stream_done = true; break; }
                     std::string token = parse_sse_delta(payload);
-                    if (!token.empty() && token_cb_) token_cb_(token);
+                    if (token.empty()) continue;
+                    if (journal_) journal_->record(journal_stream_id_, token, received_ns);
+                    if (batch_cb_) {
+                        batch_text.push_back(std::move(token));
+                    } else if (token_cb_) {
+                        token_cb_(token);
+                    }
                 }
             }
             buf = buf.substr(start);
+
+            if (!batch_text.empty()) {
+                // Views are taken only now: batch_text may reallocate while filling.
+                for (const std::string& t : batch_text) batch.push_back({t, received_ns});
+                batch_cb_(batch);
+                batch.clear();
+                batch_text.clear();
+            }
         }
 
         close_socket();
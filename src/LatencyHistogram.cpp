@@ -0,0 +1,80 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace llmquant {
+
+uint64_t LatencyHistogram::count() const noexcept {
+    uint64_t total = 0;
+    for (const auto& c : counts_) total += c.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const noexcept {
+    // Snapshot once so the rank and the scan agree.
+    std::array<uint64_t, kBucketCount> snap;
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        snap[i] = counts_[i].load(std::memory_order_relaxed);
+        total  += snap[i];
+    }
+    if (total == 0) return 0;
+
+    const double clamped = std::clamp(q, 0.0, 1.0);
+    const uint64_t rank  = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += snap[i];
+        if (seen >= rank) return std::min(bucket_upper(i), max());
+    }
+    return max();
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const noexcept {
+    std::array<uint64_t, kBucketCount> snap;
+    Summary s;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        snap[i]  = counts_[i].load(std::memory_order_relaxed);
+        s.count += snap[i];
+    }
+    s.max_ns = max();
+    if (s.count == 0) return s;
+
+    const double total = static_cast<double>(s.count);
+    const uint64_t ranks[3] = {
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(0.50  * total))),
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(0.99  * total))),
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(0.999 * total))),
+    };
+    uint64_t* out[3] = {&s.p50_ns, &s.p99_ns, &s.p999_ns};
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount && next < 3; ++i) {
+        seen += snap[i];
+        while (next < 3 && seen >= ranks[next]) *out[next++] = std::min(bucket_upper(i), s.max_ns);
+    }
+    return s;
+}
+
+void LatencyHistogram::reset() noexcept {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+}
+
+double WindowedRate::rate(std::chrono::milliseconds window, clock::time_point now) const noexcept {
+    const int64_t current = epoch_of(now);
+    const int64_t slots = std::clamp<int64_t>(window / kSlotWidth, 1, static_cast<int64_t>(kSlots) - 1);
+
+    uint64_t total = 0;
+    for (int64_t k = 1; k <= slots; ++k) {
+        const int64_t epoch = current - k;
+        if (epoch < 0) break;
+        const Slot& s = slots_[static_cast<size_t>(epoch) % kSlots];
+        if (s.epoch.load(std::memory_order_acquire) == epoch) total += s.count.load(std::memory_order_relaxed);
+    }
+    const double secs = std::chrono::duration<double>(kSlotWidth * slots).count();
+    return static_cast<double>(total) / secs;
+}
+
+} // namespace llmquant
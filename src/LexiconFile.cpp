@@ -0,0 +1,242 @@
+#include "LexiconFile.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace llmquant {
+
+namespace {
+
+constexpr char     kMagic[8]   = {'L', 'L', 'M', 'Q', 'L', 'E', 'X', '\0'};
+constexpr uint32_t kByteOrder  = 0x01020304u;
+constexpr uint64_t kChecksumSeed = 0x6C6578636F6D7031ULL;
+
+/// Fixed-size file header; everything after it is covered by `checksum`.
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;     ///< kByteOrder as written by the producing machine.
+    uint64_t hash_seed;
+    uint64_t bucket_count;
+    uint64_t slot_count;
+    uint64_t phrase_count;
+    uint64_t pool_bytes;
+    uint64_t checksum;
+};
+static_assert(sizeof(FileHeader) == 64, "binary lexicon header must be 64 bytes");
+
+/// One phrase; its words are stored space-separated in the string pool.
+struct PhraseRecord {
+    uint64_t       text_offset;
+    uint32_t       text_length;
+    uint32_t       reserved;
+    SemanticWeight weight;
+};
+static_assert(sizeof(PhraseRecord) == 48, "PhraseRecord layout changed");
+
+/// Byte offsets of each section; slots start right after the header so they
+/// inherit its 64-byte (page) alignment.
+struct Layout {
+    uint64_t slots;
+    uint64_t seeds;
+    uint64_t phrases;
+    uint64_t pool;
+    uint64_t total;
+};
+
+Layout layout_for(uint64_t slot_count, uint64_t bucket_count,
+                  uint64_t phrase_count, uint64_t pool_bytes) {
+    Layout l{};
+    l.slots   = sizeof(FileHeader);
+    l.seeds   = l.slots + slot_count * CompiledLexicon::kSlotBytes;
+    l.phrases = (l.seeds + bucket_count * sizeof(uint32_t) + 7) & ~uint64_t{7};
+    l.pool    = l.phrases + phrase_count * sizeof(PhraseRecord);
+    l.total   = l.pool + pool_bytes;
+    return l;
+}
+
+uint64_t checksum_of(std::string_view payload) {
+    return CompiledLexicon::hash(payload, kChecksumSeed ^ kBinaryLexiconVersion);
+}
+
+} // namespace
+
+void add_dictionary_entry(const std::string& phrase, const SemanticWeight& weight,
+                          DictionaryEntries& entries) {
+    std::istringstream iss(phrase);
+    std::vector<std::string> words;
+    std::string word;
+    while (iss >> word) words.push_back(word);
+
+    if (words.size() == 1) {
+        entries.tokens[words.front()] = weight;
+    } else if (words.size() > 1) {
+        entries.phrases.emplace_back(std::move(words), weight);
+    }
+}
+
+DictionaryEntries read_text_dictionary(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open sentiment dictionary: " + path);
+    }
+
+    DictionaryEntries entries;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string token;
+        double sentiment, confidence, volatility, bias;
+
+        // Multi-token phrases are double-quoted: "short squeeze" 0.8 0.9 0.7 0.9
+        iss >> std::ws;
+        if (iss.peek() == '"') {
+            iss.get();
+            if (!std::getline(iss, token, '"')) continue;
+        } else if (!(iss >> token)) {
+            continue;
+        }
+
+        if (iss >> sentiment >> confidence >> volatility >> bias) {
+            add_dictionary_entry(token, {sentiment, confidence, volatility, bias}, entries);
+        }
+    }
+    return entries;
+}
+
+void write_binary_lexicon(const std::string& path, const DictionaryEntries& entries) {
+    const CompiledLexicon table(entries.tokens);
+    const CompiledLexicon::Image image = table.image();
+
+    std::string pool(image.key_pool, image.key_pool_bytes);
+    std::vector<PhraseRecord> records;
+    records.reserve(entries.phrases.size());
+    for (const auto& [words, weight] : entries.phrases) {
+        PhraseRecord r{};
+        r.text_offset = pool.size();
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (i > 0) pool.push_back(' ');
+            pool += words[i];
+        }
+        r.text_length = static_cast<uint32_t>(pool.size() - r.text_offset);
+        r.weight      = weight;
+        records.push_back(r);
+    }
+
+    const Layout l = layout_for(image.slot_count, image.bucket_count,
+                                records.size(), pool.size());
+    std::vector<char> buf(l.total, 0);
+    if (image.slot_count > 0) {
+        std::memcpy(buf.data() + l.slots, image.slots,
+                    image.slot_count * CompiledLexicon::kSlotBytes);
+        std::memcpy(buf.data() + l.seeds, image.bucket_seeds,
+                    image.bucket_count * sizeof(uint32_t));
+    }
+    if (!records.empty()) {
+        std::memcpy(buf.data() + l.phrases, records.data(), records.size() * sizeof(PhraseRecord));
+    }
+    if (!pool.empty()) std::memcpy(buf.data() + l.pool, pool.data(), pool.size());
+
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version      = kBinaryLexiconVersion;
+    h.byte_order   = kByteOrder;
+    h.hash_seed    = image.hash_seed;
+    h.bucket_count = image.bucket_count;
+    h.slot_count   = image.slot_count;
+    h.phrase_count = records.size();
+    h.pool_bytes   = pool.size();
+    h.checksum     = checksum_of({buf.data() + sizeof(FileHeader), buf.size() - sizeof(FileHeader)});
+    std::memcpy(buf.data(), &h, sizeof(h));
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to write binary lexicon: " + tmp);
+        }
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!out) throw std::runtime_error("Failed to write binary lexicon: " + tmp);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write binary lexicon: " + path);
+    }
+}
+
+BinaryLexicon open_binary_lexicon(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    const auto fail = [&path](const char* why) {
+        return std::runtime_error("Binary lexicon " + path + ": " + why);
+    };
+
+    const uint64_t size = file->size();
+    if (size < sizeof(FileHeader)) throw fail("truncated header");
+    FileHeader h;
+    std::memcpy(&h, file->data(), sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) throw fail("not a binary lexicon");
+    if (h.version != kBinaryLexiconVersion) throw fail("unsupported format version");
+    if (h.byte_order != kByteOrder) throw fail("written with a different byte order");
+
+    // Bound every count by the file size before multiplying, so a corrupt
+    // header cannot overflow the layout arithmetic.
+    if (h.slot_count > size / CompiledLexicon::kSlotBytes ||
+        h.bucket_count > size / sizeof(uint32_t) ||
+        h.phrase_count > size / sizeof(PhraseRecord) ||
+        h.pool_bytes > size) {
+        throw fail("section sizes exceed file size");
+    }
+    const Layout l = layout_for(h.slot_count, h.bucket_count, h.phrase_count, h.pool_bytes);
+    if (l.total != size) throw fail("file size does not match header");
+
+    const std::string_view payload(file->data() + sizeof(FileHeader), size - sizeof(FileHeader));
+    if (checksum_of(payload) != h.checksum) throw fail("checksum mismatch");
+
+    const char* base = file->data();
+    const char* pool = base + l.pool;
+
+    BinaryLexicon result;
+    CompiledLexicon::Image image;
+    image.hash_seed      = h.hash_seed;
+    image.bucket_seeds   = reinterpret_cast<const uint32_t*>(base + l.seeds);
+    image.bucket_count   = h.bucket_count;
+    image.slots          = base + l.slots;
+    image.slot_count     = h.slot_count;
+    image.key_pool       = pool;
+    image.key_pool_bytes = h.pool_bytes;
+    try {
+        result.tokens = CompiledLexicon::adopt(image, file);
+    } catch (const std::runtime_error& e) {
+        throw fail(e.what());
+    }
+
+    result.phrases.reserve(h.phrase_count);
+    for (uint64_t i = 0; i < h.phrase_count; ++i) {
+        PhraseRecord r;
+        std::memcpy(&r, base + l.phrases + i * sizeof(PhraseRecord), sizeof(r));
+        if (r.text_offset > h.pool_bytes || r.text_length > h.pool_bytes - r.text_offset) {
+            throw fail("phrase text out of range");
+        }
+        DictionaryEntries entry;
+        add_dictionary_entry(std::string(pool + r.text_offset, r.text_length), r.weight, entry);
+        for (auto& p : entry.phrases) result.phrases.push_back(std::move(p));
+    }
+    return result;
+}
+
+bool is_binary_lexicon(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return file.read(magic, sizeof(magic)) &&
+           std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+} // namespace llmquant
@@ -56,7 +56,7 @@ void MetricsLogger::write_csv_header() {
     }
 }
 
-void MetricsLogger::log_token_received(const std::string& token, uint64_t sequence_id) {
+void MetricsLogger::log_token_received(std::string_view token, uint64_t sequence_id) {
     log_entries_++;
     
     auto now = std::chrono::high_resolution_clock::now();
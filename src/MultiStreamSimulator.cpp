@@ -0,0 +1,169 @@
+#include "MultiStreamSimulator.h"
+#include "MappedFile.h"
+#include "TokenNormalizer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace llmquant {
+
+MultiStreamSimulator::MultiStreamSimulator(const Config& config)
+    : config_(config), vocabulary_(std::make_shared<TokenVocabulary>()) {
+    if (config_.stream_count == 0) {
+        throw std::invalid_argument("MultiStreamSimulator: stream_count must be positive");
+    }
+    uint32_t workers = config_.worker_count;
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    worker_count_ = std::min(workers, config_.stream_count);
+
+    streams_.reserve(config_.stream_count);
+    for (uint32_t i = 0; i < config_.stream_count; ++i) {
+        streams_.push_back(std::make_unique<StreamState>());
+        streams_.back()->id = i;
+    }
+}
+
+MultiStreamSimulator::~MultiStreamSimulator() {
+    stop();
+}
+
+void MultiStreamSimulator::set_token_callback(TokenCallback callback) {
+    callback_ = std::move(callback);
+}
+
+void MultiStreamSimulator::set_arrival_factory(ArrivalFactory factory) {
+    arrival_factory_ = std::move(factory);
+}
+
+void MultiStreamSimulator::set_vocabulary(std::shared_ptr<TokenVocabulary> vocabulary) {
+    vocabulary_ = std::move(vocabulary);
+}
+
+void MultiStreamSimulator::load_tokens_from_memory(const std::vector<std::string>& tokens) {
+    TokenArena arena;
+    size_t bytes = 0;
+    for (const auto& t : tokens) bytes += t.size();
+    arena.reserve(tokens.size(), bytes);
+    for (const auto& t : tokens) arena.append(t);
+    install_corpus(std::move(arena));
+}
+
+void MultiStreamSimulator::load_tokens_from_file(const std::string& filepath) {
+    MappedFile file = [&] {
+        try {
+            return MappedFile(filepath);
+        } catch (const std::runtime_error&) {
+            throw std::runtime_error("Failed to open token file: " + filepath);
+        }
+    }();
+    const std::string_view text = file.view();
+
+    TokenArena arena;
+    arena.reserve(0, text.size());
+    size_t pos = 0;
+    for (std::string_view tok = next_token(text, pos); !tok.empty(); tok = next_token(text, pos)) {
+        arena.append(tok);
+    }
+    install_corpus(std::move(arena));
+}
+
+void MultiStreamSimulator::install_corpus(TokenArena arena) {
+    if (running_.load()) throw std::runtime_error("MultiStreamSimulator: cannot load while running");
+    arena_ = std::move(arena);
+    ids_.clear();
+    ids_.reserve(arena_.size());
+    for (size_t i = 0; i < arena_.size(); ++i) ids_.push_back(vocabulary_->intern(arena_.text(i)));
+}
+
+void MultiStreamSimulator::start() {
+    if (running_.load()) return;
+
+    const size_t n = arena_.size();
+    const auto now = clock::now();
+    for (auto& s : streams_) {
+        s->next     = n == 0 ? 0 : static_cast<size_t>((uint64_t{s->id} * n) / config_.stream_count);
+        s->sequence = 0;
+        s->deadline = now;
+        s->arrival  = arrival_factory_ ? arrival_factory_(s->id) : nullptr;
+        s->emitted.store(0, std::memory_order_relaxed);
+    }
+    started_ = now;
+    stopped_at_.store(0, std::memory_order_relaxed);
+
+    running_ = true;
+    workers_.reserve(worker_count_);
+    for (uint32_t w = 0; w < worker_count_; ++w) {
+        workers_.emplace_back(&MultiStreamSimulator::worker, this, w);
+    }
+}
+
+void MultiStreamSimulator::stop() {
+    if (!running_.exchange(false)) return;
+    stopped_at_.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    for (auto& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+    workers_.clear();
+}
+
+MultiStreamSimulator::Stats MultiStreamSimulator::get_stats() const {
+    Stats stats;
+    stats.per_stream.reserve(streams_.size());
+    for (const auto& s : streams_) {
+        const uint64_t emitted = s->emitted.load(std::memory_order_relaxed);
+        stats.per_stream.push_back(emitted);
+        stats.tokens_emitted += emitted;
+    }
+    const clock::rep stopped = stopped_at_.load(std::memory_order_relaxed);
+    const clock::time_point end = stopped != 0 ? clock::time_point(clock::duration(stopped)) : clock::now();
+    const double secs = std::chrono::duration<double>(end - started_).count();
+    if (secs > 0.0) stats.achieved_rate_tps = static_cast<double>(stats.tokens_emitted) / secs;
+    return stats;
+}
+
+void MultiStreamSimulator::emit(StreamState& s) {
+    Token token(arena_.text(s.next), s.sequence++, ids_[s.next]);
+    token.stream_id = s.id;
+    s.next = (s.next + 1 == arena_.size()) ? 0 : s.next + 1;
+    if (callback_) callback_(token);
+    // Single writer: a plain store avoids a locked read-modify-write.
+    s.emitted.store(s.emitted.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void MultiStreamSimulator::worker(uint32_t index) {
+    // A stream further behind schedule than this re-anchors instead of bursting.
+    constexpr auto kMaxLag = std::chrono::milliseconds(10);
+
+    std::vector<StreamState*> mine;
+    for (size_t i = index; i < streams_.size(); i += worker_count_) mine.push_back(streams_[i].get());
+
+    if (arena_.empty()) {
+        while (running_.load(std::memory_order_relaxed)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return;
+    }
+
+    const bool free_running = config_.token_interval.count() == 0 && !arrival_factory_;
+    if (free_running) {
+        while (running_.load(std::memory_order_relaxed)) {
+            for (StreamState* s : mine) emit(*s);
+        }
+        return;
+    }
+
+    while (running_.load(std::memory_order_relaxed)) {
+        StreamState* s = mine.front();
+        for (StreamState* candidate : mine) {
+            if (candidate->deadline < s->deadline) s = candidate;
+        }
+        pace_until(s->deadline, config_.pacing, config_.spin_window, running_);
+        if (!running_.load(std::memory_order_relaxed)) break;
+
+        emit(*s);
+
+        s->deadline += s->arrival ? s->arrival->next_gap() : config_.token_interval;
+        const auto now = clock::now();
+        if (now - s->deadline > kMaxLag) s->deadline = now;
+    }
+}
+
+} // namespace llmquant
@@ -0,0 +1,147 @@
+#include "MultiSymbolSignalEngine.h"
+
+#include <stdexcept>
+
+namespace llmquant {
+
+namespace {
+
+int64_t to_ns(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+// Bump a single-writer counter without a locked read-modify-write.
+void bump(std::atomic<uint64_t>& c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+MultiSymbolSignalEngine::MultiSymbolSignalEngine(const Config& config, size_t symbol_capacity,
+                                                 std::shared_ptr<Clock> clock)
+    : step_(config.engine)
+    , shard_count_(config.shard_count)
+    , symbol_capacity_(symbol_capacity)
+    , clock_(clock ? std::move(clock) : SystemClock::instance()) {
+    if (shard_count_ == 0) throw std::invalid_argument("MultiSymbolSignalEngine: shard_count must be > 0");
+    if (symbol_capacity_ == 0) throw std::invalid_argument("MultiSymbolSignalEngine: symbol_capacity must be > 0");
+
+    // Round each column up to whole cache lines so a shard's columns never
+    // share a line with a neighbouring allocation.
+    const size_t per_shard = (symbol_capacity_ + shard_count_ - 1) / shard_count_;
+    const size_t slots     = (per_shard + 7) & ~size_t{7};
+    const int64_t start    = to_ns(clock_->now());
+
+    shards_ = std::make_unique<Shard[]>(shard_count_);
+    for (size_t i = 0; i < shard_count_; ++i) {
+        Shard& s = shards_[i];
+        s.bias.assign(slots, 0.0);
+        s.volatility.assign(slots, 0.0);
+        s.confidence.assign(slots, 0.5);
+        s.ewma_fast.assign(slots, 0.0);
+        s.ewma_medium.assign(slots, 0.0);
+        s.ewma_slow.assign(slots, 0.0);
+        s.last_update_ns.assign(slots, start);
+        s.last_signal_ns.assign(slots, start);
+    }
+}
+
+TradeSignalEngine::SignalState MultiSymbolSignalEngine::load(const Shard& shard, size_t slot) noexcept {
+    return TradeSignalEngine::SignalState{
+        .bias           = shard.bias[slot],
+        .volatility     = shard.volatility[slot],
+        .confidence     = shard.confidence[slot],
+        .ewma_fast      = shard.ewma_fast[slot],
+        .ewma_medium    = shard.ewma_medium[slot],
+        .ewma_slow      = shard.ewma_slow[slot],
+        .last_update_ns = shard.last_update_ns[slot],
+        .last_signal_ns = shard.last_signal_ns[slot],
+    };
+}
+
+void MultiSymbolSignalEngine::store(Shard& shard, size_t slot,
+                                    const TradeSignalEngine::SignalState& state) noexcept {
+    shard.bias[slot]           = state.bias;
+    shard.volatility[slot]     = state.volatility;
+    shard.confidence[slot]     = state.confidence;
+    shard.ewma_fast[slot]      = state.ewma_fast;
+    shard.ewma_medium[slot]    = state.ewma_medium;
+    shard.ewma_slow[slot]      = state.ewma_slow;
+    shard.last_update_ns[slot] = state.last_update_ns;
+    shard.last_signal_ns[slot] = state.last_signal_ns;
+}
+
+void MultiSymbolSignalEngine::process_semantic_weight(SymbolId symbol, const SemanticWeight& weight) {
+    if (symbol >= symbol_capacity_) {
+        throw std::out_of_range("MultiSymbolSignalEngine: symbol ID beyond capacity");
+    }
+    Shard& shard      = shards_[symbol % shard_count_];
+    const size_t slot = symbol / shard_count_;
+    bump(shard.weights_processed);
+
+    TradeSignalEngine::SignalState state = load(shard, slot);
+    TradeSignal signal;
+    const bool due = step_.apply(state, weight, clock_->now(),
+                                 realtime_mode_.load(std::memory_order_relaxed), signal);
+    store(shard, slot, state);
+    if (!due) return;
+    signal.symbol = symbol;
+    emit_signal(shard, slot, signal);
+}
+
+void MultiSymbolSignalEngine::emit_signal(Shard& shard, size_t slot, const TradeSignal& signal) {
+    if (callback_) {
+        callback_(signal);
+        bump(shard.signals_generated);
+        shard.last_signal_ns[slot] = static_cast<int64_t>(signal.timestamp_ns);
+    } else {
+        bump(shard.signals_suppressed);
+    }
+
+    for (const auto& sink : output_sinks_) {
+        sink->emit(signal);
+    }
+}
+
+double MultiSymbolSignalEngine::bias(SymbolId symbol) const noexcept {
+    if (symbol >= symbol_capacity_) return 0.0;
+    return shards_[symbol % shard_count_].bias[symbol / shard_count_];
+}
+
+double MultiSymbolSignalEngine::volatility(SymbolId symbol) const noexcept {
+    if (symbol >= symbol_capacity_) return 0.0;
+    return shards_[symbol % shard_count_].volatility[symbol / shard_count_];
+}
+
+MultiSymbolSignalEngine::Stats MultiSymbolSignalEngine::get_stats() const noexcept {
+    Stats out;
+    for (size_t i = 0; i < shard_count_; ++i) {
+        const Shard& s = shards_[i];
+        out.weights_processed  += s.weights_processed.load(std::memory_order_relaxed);
+        out.signals_generated  += s.signals_generated.load(std::memory_order_relaxed);
+        out.signals_suppressed += s.signals_suppressed.load(std::memory_order_relaxed);
+    }
+    return out;
+}
+
+void MultiSymbolSignalEngine::set_signal_callback(TradeSignalCallback callback) {
+    callback_ = std::move(callback);
+}
+
+void MultiSymbolSignalEngine::set_realtime_mode(bool enabled) {
+    realtime_mode_ = enabled;
+}
+
+void MultiSymbolSignalEngine::set_backtest_mode(bool enabled) {
+    realtime_mode_ = !enabled;
+}
+
+void MultiSymbolSignalEngine::add_output_sink(std::shared_ptr<OutputSink> sink) {
+    output_sinks_.push_back(std::move(sink));
+}
+
+void MultiSymbolSignalEngine::clear_output_sinks() {
+    output_sinks_.clear();
+}
+
+} // namespace llmquant
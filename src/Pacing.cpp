@@ -0,0 +1,31 @@
+#include "Pacing.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace llmquant {
+
+void pace_until(std::chrono::steady_clock::time_point deadline, Pacing mode,
+                std::chrono::nanoseconds spin_window, const std::atomic<bool>& running) {
+    using clock = std::chrono::steady_clock;
+    constexpr auto kSlice = std::chrono::milliseconds(10);
+
+    // Coarse phase: sleep in slices.  Spin skips it; Hybrid stops short of
+    // the deadline by spin_window.
+    if (mode != Pacing::Spin) {
+        const auto wake = mode == Pacing::Hybrid
+            ? deadline - std::chrono::duration_cast<clock::duration>(spin_window)
+            : deadline;
+        while (running.load(std::memory_order_relaxed)) {
+            const auto now = clock::now();
+            if (now >= wake) break;
+            std::this_thread::sleep_for(std::min<clock::duration>(wake - now, kSlice));
+        }
+        if (mode == Pacing::Sleep) return;
+    }
+
+    // Fine phase: busy-wait on the clock.
+    while (clock::now() < deadline && running.load(std::memory_order_relaxed)) cpu_relax();
+}
+
+} // namespace llmquant
@@ -0,0 +1,90 @@
+#include "PhraseMatcher.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+namespace llmquant {
+
+PhraseMatcher::PhraseMatcher(const std::vector<Phrase>& phrases) {
+    // Dense alphabet: only tokens that appear in some phrase get a symbol.
+    TokenId max_id = 0;
+    bool any = false;
+    for (const auto& p : phrases) {
+        for (TokenId id : p.tokens) { max_id = std::max(max_id, id); any = true; }
+    }
+    if (!any) return;
+
+    symbol_of_.assign(static_cast<size_t>(max_id) + 1, 0);
+    alphabet_size_ = 1;
+    for (const auto& p : phrases) {
+        for (TokenId id : p.tokens) {
+            if (symbol_of_[id] == 0) symbol_of_[id] = alphabet_size_++;
+        }
+    }
+
+    // Build the trie with per-state (symbol, child) edge lists.
+    std::vector<std::vector<std::pair<uint32_t, State>>> trie(1);
+    output_.assign(1, -1);
+    std::vector<uint32_t> depth(1, 0);
+    for (const auto& p : phrases) {
+        if (p.tokens.empty()) continue;
+        State s = kRoot;
+        for (TokenId id : p.tokens) {
+            const uint32_t sym = symbol_of_[id];
+            auto& edges = trie[s];
+            auto it = std::find_if(edges.begin(), edges.end(),
+                                   [sym](const auto& e) { return e.first == sym; });
+            if (it == edges.end()) {
+                const auto child = static_cast<State>(output_.size());
+                edges.emplace_back(sym, child);
+                trie.emplace_back();
+                output_.push_back(-1);
+                depth.push_back(depth[s] + 1);
+                s = child;
+            } else {
+                s = it->second;
+            }
+        }
+        if (output_[s] >= 0) {
+            matches_[static_cast<size_t>(output_[s])].weight = p.weight;
+        } else {
+            output_[s] = static_cast<int32_t>(matches_.size());
+            matches_.push_back(Match{p.weight, depth[s]});
+        }
+    }
+
+    // Flatten the edges of every non-root state into sorted CSR arrays; the
+    // root keeps a dense row so every failure walk ends in one load.
+    const size_t n_states = output_.size();
+    root_next_.assign(alphabet_size_, kRoot);
+    for (const auto& [sym, child] : trie[kRoot]) root_next_[sym] = child;
+    edge_begin_.assign(n_states + 1, 0);
+    for (size_t s = 1; s < n_states; ++s) {
+        auto& edges = trie[s];
+        std::sort(edges.begin(), edges.end());
+        edge_begin_[s + 1] = edge_begin_[s] + static_cast<uint32_t>(edges.size());
+        for (const auto& [sym, child] : edges) {
+            edge_symbol_.push_back(sym);
+            edge_target_.push_back(child);
+        }
+    }
+
+    // Breadth-first: resolve failure links and inherit the output of the
+    // failure state when a state has none of its own (that output is the
+    // longest proper-suffix phrase).
+    fail_.assign(n_states, kRoot);
+    std::deque<State> queue;
+    for (const auto& [sym, child] : trie[kRoot]) queue.push_back(child);
+    while (!queue.empty()) {
+        const State s = queue.front();
+        queue.pop_front();
+        if (output_[s] < 0) output_[s] = output_[fail_[s]];
+        for (const auto& [sym, child] : trie[s]) {
+            fail_[child] = step(fail_[s], sym);
+            queue.push_back(child);
+        }
+    }
+}
+
+} // namespace llmquant
@@ -0,0 +1,86 @@
+#include "Rcu.h"
+
+#include <cstdint>
+#include <thread>
+
+namespace llmquant {
+
+namespace {
+
+// Epoch 0 marks an idle slot, so the global epoch starts at 1.
+std::atomic<uint64_t> g_epoch{1};
+
+/// One per reader thread, recycled after the thread exits.  Slots are never
+/// freed, so writers can walk the list without synchronising with exits.
+struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> epoch{0};   ///< Epoch observed on entry, or 0 when idle.
+    std::atomic<bool>     in_use{false};
+    ReaderSlot*           next{nullptr};
+};
+
+std::atomic<ReaderSlot*> g_slots{nullptr};
+
+ReaderSlot* acquire_slot() {
+    for (ReaderSlot* s = g_slots.load(std::memory_order_acquire); s; s = s->next) {
+        bool expected = false;
+        if (!s->in_use.load(std::memory_order_relaxed) &&
+            s->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return s;
+        }
+    }
+    auto* s = new ReaderSlot;
+    s->in_use.store(true, std::memory_order_relaxed);
+    ReaderSlot* head = g_slots.load(std::memory_order_relaxed);
+    do {
+        s->next = head;
+    } while (!g_slots.compare_exchange_weak(head, s, std::memory_order_release,
+                                            std::memory_order_relaxed));
+    return s;
+}
+
+struct ThreadReader {
+    ReaderSlot* slot{acquire_slot()};
+    uint32_t    depth{0};
+
+    ~ThreadReader() {
+        slot->epoch.store(0, std::memory_order_release);
+        slot->in_use.store(false, std::memory_order_release);
+    }
+};
+
+ThreadReader& thread_reader() {
+    thread_local ThreadReader reader;
+    return reader;
+}
+
+} // namespace
+
+EpochGuard::EpochGuard() {
+    ThreadReader& r = thread_reader();
+    if (r.depth++ == 0) {
+        // seq_cst store: must be ordered before the reader's subsequent load of
+        // any RcuPtr, so a writer's scan either sees this slot or the reader
+        // sees the writer's new pointer.
+        r.slot->epoch.store(g_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+EpochGuard::~EpochGuard() {
+    ThreadReader& r = thread_reader();
+    if (--r.depth == 0) {
+        r.slot->epoch.store(0, std::memory_order_release);
+    }
+}
+
+void rcu_synchronize() {
+    const uint64_t target = g_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    for (ReaderSlot* s = g_slots.load(std::memory_order_acquire); s; s = s->next) {
+        for (;;) {
+            const uint64_t e = s->epoch.load(std::memory_order_seq_cst);
+            if (e == 0 || e >= target) break;
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace llmquant
@@ -1,16 +1,24 @@
 #include "RiskManager.h"
+#include <algorithm>
 #include <cmath>
 
 namespace llmquant {
 
-RiskManager::RiskManager(const Config& config)
+RiskManager::RiskManager(const Config& config, std::shared_ptr<Clock> clock)
     : config_(config)
-    , rate_window_start_(std::chrono::high_resolution_clock::now())
-    , drawdown_window_start_(std::chrono::high_resolution_clock::now()) {}
+    , clock_(clock ? std::move(clock) : SystemClock::instance())
+    , rate_window_start_(clock_->now())
+    , drawdown_window_start_(rate_window_start_)
+    , cumulative_bias_(std::max<size_t>(1, config.symbol_capacity), 0.0) {}
 
 bool RiskManager::evaluate(const TradeSignal& signal) {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    if (signal.symbol >= cumulative_bias_.size()) {
+        stats_.signals_blocked_symbol++;
+        fire_alert("unknown_symbol", signal);
+        return false;
+    }
     if (!check_magnitude(signal)) {
         stats_.signals_blocked_magnitude++;
         fire_alert("magnitude_exceeded", signal);
@@ -51,11 +59,11 @@ void RiskManager::set_alert_callback(AlertCallback cb) {
 
 void RiskManager::reset() {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto now = std::chrono::high_resolution_clock::now();
+    auto now = clock_->now();
     rate_window_start_     = now;
     drawdown_window_start_ = now;
     signals_in_window_     = 0;
-    cumulative_bias_       = 0.0;
+    std::fill(cumulative_bias_.begin(), cumulative_bias_.end(), 0.0);
 }
 
 bool RiskManager::check_magnitude(const TradeSignal& signal) {
@@ -69,7 +77,7 @@ bool RiskManager::check_confidence(const TradeSignal& signal) {
 }
 
 bool RiskManager::check_rate_limit() {
-    auto now     = std::chrono::high_resolution_clock::now();
+    auto now     = clock_->now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - rate_window_start_);
     if (elapsed >= std::chrono::seconds{1}) {
         rate_window_start_ = now;
@@ -79,17 +87,17 @@ bool RiskManager::check_rate_limit() {
 }
 
 bool RiskManager::check_drawdown(const TradeSignal& signal) {
-    auto now     = std::chrono::high_resolution_clock::now();
+    auto now     = clock_->now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - drawdown_window_start_);
     if (elapsed >= config_.drawdown_window) {
         drawdown_window_start_ = now;
-        cumulative_bias_       = 0.0;
+        std::fill(cumulative_bias_.begin(), cumulative_bias_.end(), 0.0);
     }
-    return std::abs(cumulative_bias_ + signal.delta_bias_shift) <= config_.max_drawdown;
+    return std::abs(cumulative_bias_[signal.symbol] + signal.delta_bias_shift) <= config_.max_drawdown;
 }
 
 void RiskManager::update_drawdown(const TradeSignal& signal) {
-    cumulative_bias_ += signal.delta_bias_shift;
+    cumulative_bias_[signal.symbol] += signal.delta_bias_shift;
 }
 
 void RiskManager::fire_alert(const std::string& reason, const TradeSignal& signal) {
@@ -0,0 +1,63 @@
+#include "SentimentContext.h"
+
+#include <algorithm>
+
+namespace llmquant {
+
+void SentimentContext::compile(const ContextRules& rules, TokenVocabulary& vocabulary) {
+    clear();
+    for (const auto& word : rules.negators) {
+        modifiers_.ensure(vocabulary.intern(word)) = Modifier{1.0f, Modifier::kNegator};
+    }
+    for (const auto& [word, scale] : rules.intensifiers) {
+        modifiers_.ensure(vocabulary.intern(word)) =
+            Modifier{static_cast<float>(scale), Modifier::kIntensifier};
+    }
+    window_ = static_cast<uint8_t>(std::clamp<size_t>(rules.window, 1, kMaxWindow));
+    bullish_multiplier_    = rules.bullish_multiplier;
+    bearish_multiplier_    = rules.bearish_multiplier;
+    volatility_multiplier_ = rules.volatility_multiplier;
+    active_ = !rules.negators.empty() || !rules.intensifiers.empty() ||
+              bullish_multiplier_ != 1.0 || bearish_multiplier_ != 1.0 ||
+              volatility_multiplier_ != 1.0;
+}
+
+void SentimentContext::clear() {
+    modifiers_.clear();
+    window_ = 3;
+    bullish_multiplier_ = bearish_multiplier_ = volatility_multiplier_ = 1.0;
+    active_ = false;
+}
+
+SemanticWeight SentimentContext::consume(State& state, const SemanticWeight& weight) const noexcept {
+    bool   negate = false;
+    double scale  = 1.0;
+    for (size_t i = 0; i < window_; ++i) {
+        const Modifier& m = state.recent[i];
+        if (m.kind == Modifier::kNegator) {
+            negate = !negate;
+        } else if (m.kind == Modifier::kIntensifier) {
+            scale *= m.scale;
+        }
+    }
+    state = State{};
+
+    double sentiment = weight.sentiment_score  * scale;
+    double bias      = weight.directional_bias * scale;
+    if (negate) {
+        sentiment = -sentiment;
+        bias      = -bias;
+    }
+    // Direction is judged after negation: "not bullish" takes the bearish scale.
+    const double direction = bias > 0.0 ? bullish_multiplier_
+                           : bias < 0.0 ? bearish_multiplier_ : 1.0;
+
+    SemanticWeight out = weight;
+    out.sentiment_score  = std::clamp(sentiment * direction, -1.0, 1.0);
+    out.directional_bias = std::clamp(bias * direction, -1.0, 1.0);
+    out.volatility_score = std::clamp(weight.volatility_score * scale * volatility_multiplier_,
+                                      0.0, 1.0);
+    return out;
+}
+
+} // namespace llmquant
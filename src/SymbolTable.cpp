@@ -0,0 +1,41 @@
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace llmquant {
+
+namespace {
+
+std::string upper(std::string_view name) {
+    std::string out(name);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return out;
+}
+
+} // namespace
+
+SymbolTable::SymbolTable() {
+    names_.emplace_back();   // kMarketSymbol
+}
+
+SymbolId SymbolTable::add(std::string_view name) {
+    if (name.empty()) throw std::invalid_argument("SymbolTable: symbol name must not be empty");
+    std::string key = upper(name);
+    auto it = index_.find(key);
+    if (it != index_.end()) return it->second;
+
+    const auto id = static_cast<SymbolId>(names_.size());
+    names_.push_back(key);
+    index_.emplace(std::move(key), id);
+    return id;
+}
+
+SymbolId SymbolTable::find(std::string_view name) const {
+    auto it = index_.find(upper(name));
+    return it != index_.end() ? it->second : kInvalidSymbolId;
+}
+
+} // namespace llmquant
@@ -0,0 +1,27 @@
+#include "TickerExtractor.h"
+
+#include <algorithm>
+
+namespace llmquant {
+
+void TickerExtractor::compile(const TickerRules& rules, TokenVocabulary& vocabulary, SymbolTable& symbols) {
+    clear();
+    for (const auto& [name, aliases] : rules.tickers) {
+        const SymbolId id = symbols.add(name);
+        symbols_.ensure(vocabulary.intern(name)) = id;
+        symbols_.ensure(vocabulary.intern("$" + name)) = id;
+        for (const auto& alias : aliases) {
+            symbols_.ensure(vocabulary.intern(alias)) = id;
+        }
+    }
+    window_ = std::max<uint32_t>(rules.window, 1);
+    active_ = !rules.tickers.empty();
+}
+
+void TickerExtractor::clear() {
+    symbols_.clear();
+    window_ = 16;
+    active_ = false;
+}
+
+} // namespace llmquant
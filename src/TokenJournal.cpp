@@ -0,0 +1,125 @@
+#include "TokenJournal.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace llmquant {
+
+namespace {
+
+constexpr char     kMagic[8]  = {'L', 'L', 'M', 'Q', 'J', 'R', 'N', '\0'};
+constexpr uint32_t kByteOrder = 0x01020304u;
+
+/// Fixed-size file header.
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;    ///< kByteOrder as written by the producing machine.
+    uint64_t origin_ns;     ///< monotonic_ns() when the writer was opened.
+    uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == 32, "token journal header must be 32 bytes");
+
+/// Fixed part of one record; `length` text bytes follow it unpadded.
+struct RecordHeader {
+    uint64_t receive_ns;
+    uint64_t sequence;
+    uint32_t stream_id;
+    uint32_t length;
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout changed");
+
+} // namespace
+
+TokenJournalWriter::TokenJournalWriter(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) throw std::runtime_error("TokenJournalWriter: cannot create " + path);
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version    = kTokenJournalVersion;
+    header.byte_order = kByteOrder;
+    header.origin_ns  = monotonic_ns();
+    buffer_.reserve(kBufferBytes);
+    buffer_.insert(buffer_.end(), reinterpret_cast<const char*>(&header),
+                   reinterpret_cast<const char*>(&header) + sizeof(header));
+}
+
+TokenJournalWriter::~TokenJournalWriter() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_locked();
+    std::fclose(file_);
+}
+
+void TokenJournalWriter::record(uint32_t stream_id, std::string_view text, uint64_t receive_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecordHeader rec{};
+    rec.receive_ns = receive_ns;
+    rec.sequence   = next_sequence_[stream_id]++;
+    rec.stream_id  = stream_id;
+    rec.length     = static_cast<uint32_t>(text.size());
+
+    if (buffer_.size() + sizeof(rec) + text.size() > kBufferBytes) flush_locked();
+    buffer_.insert(buffer_.end(), reinterpret_cast<const char*>(&rec),
+                   reinterpret_cast<const char*>(&rec) + sizeof(rec));
+    buffer_.insert(buffer_.end(), text.begin(), text.end());
+    ++records_;
+}
+
+void TokenJournalWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_locked();
+    std::fflush(file_);
+}
+
+uint64_t TokenJournalWriter::records_written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+void TokenJournalWriter::flush_locked() {
+    if (buffer_.empty()) return;
+    std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    buffer_.clear();
+}
+
+TokenJournalReader::TokenJournalReader(const std::string& path) : file_(path) {
+    FileHeader header{};
+    if (file_.size() < sizeof(header)) {
+        throw std::runtime_error("TokenJournalReader: " + path + " is not a token journal");
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("TokenJournalReader: " + path + " is not a token journal");
+    }
+    if (header.version != kTokenJournalVersion) {
+        throw std::runtime_error("TokenJournalReader: " + path + " has format version " +
+                                 std::to_string(header.version) + ", expected " +
+                                 std::to_string(kTokenJournalVersion));
+    }
+    if (header.byte_order != kByteOrder) {
+        throw std::runtime_error("TokenJournalReader: " + path + " was written with a different byte order");
+    }
+    origin_ns_ = header.origin_ns;
+    pos_       = sizeof(FileHeader);
+}
+
+bool TokenJournalReader::next(JournalRecord& out) {
+    RecordHeader rec{};
+    if (file_.size() - pos_ < sizeof(rec)) return false;
+    std::memcpy(&rec, file_.data() + pos_, sizeof(rec));
+    if (file_.size() - pos_ - sizeof(rec) < rec.length) return false;   // torn tail
+
+    out.receive_ns = rec.receive_ns;
+    out.sequence   = rec.sequence;
+    out.stream_id  = rec.stream_id;
+    out.text       = std::string_view(file_.data() + pos_ + sizeof(rec), rec.length);
+    pos_ += sizeof(rec) + rec.length;
+    return true;
+}
+
+void TokenJournalReader::rewind() {
+    pos_ = sizeof(FileHeader);
+}
+
+} // namespace llmquant
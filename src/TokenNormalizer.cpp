@@ -0,0 +1,148 @@
+#include "TokenNormalizer.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>  // SSE2/AVX2 intrinsics
+
+namespace llmquant {
+
+namespace {
+
+/// Load `n` (< 16) bytes into the low lanes of a register, zero-filling the
+/// rest.  Avoids reading past the end of the token into a possibly unmapped
+/// page.  Zero bytes are neither whitespace nor letters.
+inline __m128i load_partial(const char* p, size_t n) {
+    alignas(16) char tmp[16] = {};
+    std::memcpy(tmp, p, n);
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(tmp));
+}
+
+/// Bitmask of bytes that are ' ' or '\t'..'\r' (the "C" locale isspace set).
+inline uint32_t whitespace_mask(__m128i v) {
+    const __m128i space = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    // '\t'..'\r' is 9..13: after subtracting 9 the byte is <= 4 unsigned.
+    const __m128i t    = _mm_sub_epi8(v, _mm_set1_epi8(9));
+    const __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(4)), t);
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(space, ctrl)));
+}
+
+inline __m128i lowercase16(__m128i v) {
+    // Signed compares: bytes >= 0x80 are negative and never count as upper.
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+#if defined(__AVX2__)
+inline __m256i lowercase32(__m256i v) {
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+/// Index of the first non-whitespace byte, or `n` if there is none.
+size_t find_first_non_space(const char* p, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+        const size_t k     = (n - i < 16) ? n - i : 16;
+        const __m128i v    = (k == 16) ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))
+                                       : load_partial(p + i, k);
+        const uint32_t valid = (k == 16) ? 0xFFFFu : ((1u << k) - 1u);
+        const uint32_t text  = ~whitespace_mask(v) & valid;
+        if (text) return i + static_cast<size_t>(std::countr_zero(text));
+    }
+    return n;
+}
+
+/// Index of the first whitespace byte, or `n` if there is none.
+size_t find_first_space(const char* p, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i space = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+        const __m256i t     = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+        const __m256i ctrl  = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(4)), t);
+        const uint32_t ws   = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, ctrl)));
+        if (ws) return i + static_cast<size_t>(std::countr_zero(ws));
+    }
+#endif
+    for (; i < n; i += 16) {
+        const size_t k     = (n - i < 16) ? n - i : 16;
+        const __m128i v    = (k == 16) ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))
+                                       : load_partial(p + i, k);
+        const uint32_t valid = (k == 16) ? 0xFFFFu : ((1u << k) - 1u);
+        const uint32_t ws    = whitespace_mask(v) & valid;
+        if (ws) return i + static_cast<size_t>(std::countr_zero(ws));
+    }
+    return n;
+}
+
+/// One past the last non-whitespace byte in [begin, n); `begin` if none.
+size_t find_last_non_space(const char* p, size_t begin, size_t n) {
+    size_t j = n;
+    while (j > begin) {
+        const size_t k     = (j - begin < 16) ? j - begin : 16;
+        const char*  block = p + j - k;
+        const __m128i v    = (k == 16) ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(block))
+                                       : load_partial(block, k);
+        const uint32_t valid = (k == 16) ? 0xFFFFu : ((1u << k) - 1u);
+        const uint32_t text  = ~whitespace_mask(v) & valid;
+        if (text) return j - k + static_cast<size_t>(31 - std::countl_zero(text)) + 1;
+        j -= k;
+    }
+    return begin;
+}
+
+} // namespace
+
+std::string_view normalize_token(std::string_view raw, NormalizeBuffer& buf) {
+    const char*  p     = raw.data();
+    const size_t start = find_first_non_space(p, raw.size());
+    const size_t end   = find_last_non_space(p, start, raw.size());
+    const size_t len   = end - start;
+    const char*  src   = p + start;
+
+    if (len > NormalizeBuffer::kCapacity) {
+        buf.overflow.assign(src, len);
+        for (char& c : buf.overflow) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c + ('a' - 'A'));
+        }
+        return buf.overflow;
+    }
+
+    char*  dst = buf.inline_bytes;
+    size_t i   = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= len; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), lowercase32(v));
+    }
+#endif
+    for (; i + 16 <= len; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), lowercase16(v));
+    }
+    if (i < len) {
+        // Full-width store into the slack region past the token end.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         lowercase16(load_partial(src + i, len - i)));
+    }
+    return std::string_view(dst, len);
+}
+
+std::string_view next_token(std::string_view text, size_t& pos) {
+    if (pos >= text.size()) {
+        pos = text.size();
+        return {};
+    }
+    const char*  p     = text.data() + pos;
+    const size_t n     = text.size() - pos;
+    const size_t start = find_first_non_space(p, n);
+    const size_t len   = find_first_space(p + start, n - start);
+    pos += start + len;
+    return std::string_view(p + start, len);
+}
+
+} // namespace llmquant
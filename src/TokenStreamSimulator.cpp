@@ -1,12 +1,14 @@
 #include "TokenStreamSimulator.h"
+#include "TokenNormalizer.h"
+#include <algorithm>
 #include <fstream>
-#include <sstream>
 #include <iostream>
 
 namespace llmquant {
 
 TokenStreamSimulator::TokenStreamSimulator(const Config& config)
-    : config_(config), ring_buffer_(config_.buffer_size) {
+    : config_(config), ring_buffer_(config_.buffer_size),
+      vocabulary_(std::make_shared<TokenVocabulary>()) {
 }
 
 TokenStreamSimulator::~TokenStreamSimulator() {
@@ -24,83 +26,291 @@ void TokenStreamSimulator::stop() {
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    retired_sources_.clear();
 }
 
 void TokenStreamSimulator::set_token_callback(TokenCallback callback) {
     callback_ = std::move(callback);
 }
 
+void TokenStreamSimulator::set_batch_callback(TokenBatchCallback callback) {
+    batch_callback_ = std::move(callback);
+}
+
+void TokenStreamSimulator::set_arrival_process(std::unique_ptr<ArrivalProcess> process) {
+    arrival_ = std::move(process);
+}
+
+void TokenStreamSimulator::set_vocabulary(std::shared_ptr<TokenVocabulary> vocabulary) {
+    vocabulary_ = std::move(vocabulary);
+}
+
 void TokenStreamSimulator::load_tokens_from_file(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open token file: " + filepath);
+    MappedFile file = [&] {
+        try {
+            return MappedFile(filepath);
+        } catch (const std::runtime_error&) {
+            throw std::runtime_error("Failed to open token file: " + filepath);
+        }
+    }();
+    const std::string_view text = file.view();
+
+    auto source = std::make_unique<TokenSource>();
+    source->arena = std::make_unique<TokenArena>();
+    source->arena->reserve(0, text.size());
+    size_t pos = 0;
+    for (std::string_view tok = next_token(text, pos); !tok.empty(); tok = next_token(text, pos)) {
+        source->arena->append(tok);
     }
-    std::vector<std::string> tokens;
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string token;
-        while (iss >> token) tokens.push_back(token);
+    install_source(std::move(source));
+}
+
+void TokenStreamSimulator::stream_tokens_from_file(const std::string& filepath) {
+    auto source = std::make_unique<TokenSource>();
+    try {
+        source->mapped = std::make_unique<MappedFile>(filepath);
+    } catch (const std::runtime_error&) {
+        throw std::runtime_error("Failed to open token file: " + filepath);
     }
-    load_tokens_from_memory(tokens);
+    source->mapped->advise_sequential();
+    install_source(std::move(source));
+}
+
+void TokenStreamSimulator::replay_journal(const std::string& filepath) {
+    auto source = std::make_unique<TokenSource>();
+    source->journal = std::make_unique<TokenJournalReader>(filepath);
+    install_source(std::move(source));
 }
 
 void TokenStreamSimulator::load_tokens_from_memory(const std::vector<std::string>& tokens) {
-    {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        source_tokens_ = tokens;
+    auto source = std::make_unique<TokenSource>();
+    source->arena = std::make_unique<TokenArena>();
+    size_t bytes = 0;
+    for (const auto& t : tokens) bytes += t.size();
+    source->arena->reserve(tokens.size(), bytes);
+    for (const auto& t : tokens) source->arena->append(t);
+    install_source(std::move(source));
+}
+
+void TokenStreamSimulator::install_source(std::unique_ptr<TokenSource> source) {
+    if (source->arena) {
+        const TokenArena& arena = *source->arena;
+        source->ids.reserve(arena.size());
+        for (size_t i = 0; i < arena.size(); ++i) source->ids.push_back(vocabulary_->intern(arena.text(i)));
     }
-    // Pre-fill the ring buffer.
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    if (source_ && running_.load()) retired_sources_.push_back(std::move(source_));
+    source_ = std::move(source);
+    const uint64_t generation = source_generation_.fetch_add(1, std::memory_order_release) + 1;
+    // Only the worker pops, so while it runs only the worker may reset the
+    // ring; it does so when it sees the new generation.
+    if (running_.load()) return;
+    // Pre-fill the ring buffer; stream_worker refills as it drains.
     ring_buffer_.clear();
-    for (const auto& t : tokens) {
-        if (!ring_buffer_.try_push(t)) break;   // buffer full — stream_worker will refill
+    refill(config_.buffer_size);
+    ring_generation_ = generation;
+}
+
+size_t TokenStreamSimulator::refill(size_t max) {
+    if (!source_) return 0;
+    TokenSource& src = *source_;
+    size_t pushed = 0;
+
+    if (src.arena) {
+        const TokenArena& arena = *src.arena;
+        if (arena.empty()) return 0;
+        for (; pushed < max; ++pushed) {
+            const size_t i = src.next;
+            if (!ring_buffer_.try_push(Token(arena.text(i), 0, src.ids[i]))) break;
+            src.next = (i + 1 == arena.size()) ? 0 : i + 1;
+        }
+        return pushed;
+    }
+
+    if (src.journal) {
+        JournalRecord rec;
+        // Only this thread pushes, so a non-full ring accepts the next record.
+        while (pushed < max && !ring_buffer_.full() && src.journal->next(rec)) {
+            Token token(rec.text, rec.sequence, vocabulary_->intern(rec.text));
+            token.timestamp_ns = rec.receive_ns;
+            token.stream_id    = rec.stream_id;
+            ring_buffer_.try_push(token);
+            ++pushed;
+        }
+        return pushed;
     }
+
+    const std::string_view text = src.mapped->view();
+    while (pushed < max) {
+        size_t pos = src.next;
+        const std::string_view tok = next_token(text, pos);
+        if (tok.empty()) {
+            if (src.next == 0) break;   // no tokens in the whole file
+            src.next = src.released = 0;
+            continue;
+        }
+        if (!ring_buffer_.try_push(Token(tok, 0, vocabulary_->intern(tok)))) break;
+        src.next = pos;
+        ++pushed;
+    }
+    // Release pages far enough behind the scan that no queued view reaches them.
+    if (src.next > src.released + 2 * kStreamResidentBytes) {
+        const size_t upto = src.next - kStreamResidentBytes;
+        src.mapped->discard(src.released, upto - src.released);
+        src.released = upto;
+    }
+    return pushed;
+}
+
+void TokenStreamSimulator::pace_until(std::chrono::steady_clock::time_point deadline) const {
+    llmquant::pace_until(deadline, config_.pacing, config_.spin_window, running_);
 }
 
 void TokenStreamSimulator::stream_worker() {
-    size_t source_idx = 0;
+    using clock = std::chrono::steady_clock;
+    // A worker further behind schedule than this (stall, slow callback, idle
+    // ring) re-anchors instead of bursting to catch up.
+    constexpr auto kMaxLag = std::chrono::milliseconds(10);
+    constexpr auto kRateWindow = std::chrono::milliseconds(100);
+
+    // Journal replay clock: recorded time `replay_base_ns` maps to `replay_base_wall`.
+    uint64_t replay_generation = 0;
+    uint64_t replay_base_ns    = 0;
+    clock::time_point replay_base_wall;
+
+    // Non-journal tokens are due at absolute deadlines spaced token_interval
+    // (or the arrival process's gaps) apart, so wakeup overshoot never
+    // accumulates into rate drift.
+    clock::time_point next_deadline = clock::now();
+
+    uint64_t error_sum_ns  = 0;
+    uint64_t error_samples = 0;
+    uint64_t window_tokens = 0;
+    clock::time_point window_start = clock::now();
+
+    // Batch mode: released tokens accumulate here until the next one is not
+    // yet due, the ring runs dry, or the batch is full.
+    std::vector<Token> batch;
+    const size_t max_batch = std::max<size_t>(1, config_.buffer_size);
+    if (batch_callback_) batch.reserve(max_batch);
+
+    // Hand `n` released tokens to the consumer and account for them.
+    auto deliver = [&](const Token* tokens, size_t n) {
+        const auto start = clock::now();
+        if (batch_callback_) {
+            batch_callback_(std::span<const Token>(tokens, n));
+        } else if (callback_) {
+            callback_(*tokens);
+        }
+        const auto end = clock::now();
+        // Per-token callback cost; amortised over the batch in batch mode.
+        stats_.callback_latency.record((end - start) / n, n);
+        stats_.emission_rate.add(n, end);
+        stats_.tokens_emitted += n;
+
+        window_tokens += n;
+        if (end - window_start >= kRateWindow) {
+            const double secs = std::chrono::duration<double>(end - window_start).count();
+            stats_.achieved_rate_tps.store(static_cast<uint64_t>(static_cast<double>(window_tokens) / secs),
+                                           std::memory_order_relaxed);
+            window_tokens = 0;
+            window_start  = end;
+        }
+    };
+    auto flush = [&] {
+        if (batch.empty()) return;
+        deliver(batch.data(), batch.size());
+        batch.clear();
+    };
+
+    // Source generation the ring was last checked against.
+    uint64_t seen_generation = 0;
 
     while (running_.load()) {
-        std::string token_text;
+        Token token;
+
+        // A source installed while running: drop the old source's queued
+        // tokens and pre-fill from the new one.
+        if (source_generation_.load(std::memory_order_acquire) != seen_generation) {
+            std::lock_guard<std::mutex> lock(load_mutex_);
+            const uint64_t generation = source_generation_.load(std::memory_order_relaxed);
+            if (ring_generation_ != generation) {
+                ring_buffer_.clear();
+                refill(config_.buffer_size);
+                ring_generation_ = generation;
+            }
+            seen_generation = generation;
+        }
 
-        if (!ring_buffer_.try_pop(token_text)) {
-            // Ring empty: refill from source_tokens_ in a tight loop, then retry.
+        if (!ring_buffer_.try_pop(token)) {
+            // Ring empty: refill half of it from the source, then retry.
             {
                 std::lock_guard<std::mutex> lock(load_mutex_);
-                if (!source_tokens_.empty()) {
-                    for (size_t k = 0; k < config_.buffer_size / 2; ++k) {
-                        const std::string& t = source_tokens_[source_idx % source_tokens_.size()];
-                        if (!ring_buffer_.try_push(t)) {
-                            stats_.ring_buffer_drops++;
-                            break;
-                        }
-                        ++source_idx;
-                    }
-                }
+                refill(std::max<size_t>(1, config_.buffer_size / 2));
             }
-            // Still nothing — interval sleep and retry.
-            if (!ring_buffer_.try_pop(token_text)) {
+            // Still nothing — deliver what is pending, interval sleep and retry.
+            if (!ring_buffer_.try_pop(token)) {
+                flush();
                 std::this_thread::sleep_for(config_.token_interval);
                 continue;
             }
         }
 
-        uint64_t seq = current_sequence_.fetch_add(1);
-        Token token(std::move(token_text), seq);
-
-        if (callback_) {
-            auto start = std::chrono::high_resolution_clock::now();
-            callback_(token);
-            auto end   = std::chrono::high_resolution_clock::now();
-            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            stats_.avg_latency_us = latency.count();
-            stats_.max_latency_us = std::max(stats_.max_latency_us.load(),
-                                             static_cast<uint64_t>(latency.count()));
+        const bool replayed = token.timestamp_ns != 0;
+        bool paced = true;
+        clock::time_point deadline;
+        if (replayed) {
+            const uint64_t generation = source_generation_.load(std::memory_order_acquire);
+            if (generation != replay_generation || token.timestamp_ns < replay_base_ns) {
+                replay_generation = generation;
+                replay_base_ns    = token.timestamp_ns;
+                replay_base_wall  = clock::now();
+            }
+            paced = config_.replay_speed > 0.0;
+            if (paced) {
+                const double offset_ns = static_cast<double>(token.timestamp_ns - replay_base_ns) /
+                                         config_.replay_speed;
+                deadline = replay_base_wall + std::chrono::nanoseconds(static_cast<int64_t>(offset_ns));
+            }
+            current_sequence_.fetch_add(1);
+        } else {
+            if (clock::now() - next_deadline > kMaxLag) next_deadline = clock::now();
+            deadline = next_deadline;
+            next_deadline += arrival_ ? arrival_->next_gap()
+                                      : std::chrono::nanoseconds(config_.token_interval);
+            token.sequence_id = current_sequence_.fetch_add(1);
+        }
+
+        clock::time_point released;
+        if (paced) {
+            // A token that is not due yet ends the current batch.
+            if (!batch.empty() && clock::now() < deadline) flush();
+            pace_until(deadline);
+            if (!running_.load()) break;
+            released = clock::now();
+            const auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(released - deadline);
+            const uint64_t late_ns = static_cast<uint64_t>(std::max<int64_t>(0, late.count()));
+            error_sum_ns += late_ns;
+            ++error_samples;
+            stats_.pacing_error_avg_ns.store(error_sum_ns / error_samples, std::memory_order_relaxed);
+            if (late_ns > stats_.pacing_error_max_ns.load(std::memory_order_relaxed)) {
+                stats_.pacing_error_max_ns.store(late_ns, std::memory_order_relaxed);
+            }
+        } else {
+            released = clock::now();
         }
+        token.emit_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(released.time_since_epoch()).count());
 
-        stats_.tokens_emitted++;
-        std::this_thread::sleep_for(config_.token_interval);
+        if (batch_callback_) {
+            batch.push_back(token);
+            if (batch.size() == max_batch) flush();
+        } else {
+            deliver(&token, 1);
+        }
     }
+    flush();
 }
 
 } // namespace llmquant
@@ -0,0 +1,44 @@
+#include "TokenVocabulary.h"
+#include "TokenNormalizer.h"
+
+#include <mutex>
+
+namespace llmquant {
+
+TokenId TokenVocabulary::intern(std::string_view token) {
+    NormalizeBuffer buf;
+    const std::string_view key = normalize_token(token, buf);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // Another thread may have inserted the key while we waited.
+    auto it = index_.find(key);
+    if (it != index_.end()) return it->second;
+
+    const size_t next = size_.load(std::memory_order_relaxed);
+    if (next >= TokenIdTable<std::string>::kCapacity) {
+        throw std::length_error("TokenVocabulary: capacity exhausted");
+    }
+    const auto id = static_cast<TokenId>(next);
+    std::string& stored = strings_.ensure(id);
+    stored.assign(key);
+    index_.emplace(std::string_view(stored), id);
+    size_.store(next + 1, std::memory_order_release);
+    return id;
+}
+
+TokenId TokenVocabulary::find(std::string_view token) const {
+    NormalizeBuffer buf;
+    const std::string_view key = normalize_token(token, buf);
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = index_.find(key);
+    return it != index_.end() ? it->second : kInvalidTokenId;
+}
+
+} // namespace llmquant
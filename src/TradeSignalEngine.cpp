@@ -4,53 +4,103 @@
 
 namespace llmquant {
 
-TradeSignalEngine::TradeSignalEngine(const Config& config) 
-    : config_(config), last_signal_time_(std::chrono::high_resolution_clock::now()) {}
+namespace {
 
-void TradeSignalEngine::process_semantic_weight(const SemanticWeight& weight) {
+int64_t to_ns(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+} // namespace
+
+TradeSignalEngine::SignalStep::SignalStep(const Config& config)
+    : config_(config)
+    , accumulator_decay_(config.decay_time_constant)
+    , ewma_fast_decay_(config.ewma_fast)
+    , ewma_medium_decay_(config.ewma_medium)
+    , ewma_slow_decay_(config.ewma_slow) {}
+
+bool TradeSignalEngine::SignalStep::apply(SignalState& state, const SemanticWeight& weight,
+                                          Clock::time_point now, bool realtime,
+                                          TradeSignal& out) const noexcept {
     // Apply sensitivity scaling
-    double bias_contribution = weight.directional_bias * weight.confidence_score * config_.bias_sensitivity;
-    double vol_contribution = weight.volatility_score * weight.confidence_score * config_.volatility_sensitivity;
-    
+    const double bias_contribution = weight.directional_bias * weight.confidence_score * config_.bias_sensitivity;
+    const double vol_contribution = weight.volatility_score * weight.confidence_score * config_.volatility_sensitivity;
+
+    const int64_t now_ns = to_ns(now);
+    const int64_t dt_ns  = now_ns - state.last_update_ns;
+    state.last_update_ns = now_ns;
+
+    // Apply decay: by elapsed time when a time constant is set, else per token.
+    const double decay = accumulator_decay_.enabled() ? accumulator_decay_.factor(dt_ns)
+                                                      : config_.signal_decay_rate;
     // Accumulate signals with decay
-    double current_bias = accumulated_bias_.load();
-    double current_vol = accumulated_volatility_.load();
-    
-    // Apply decay
-    current_bias *= config_.signal_decay_rate;
-    current_vol *= config_.signal_decay_rate;
-    
-    // Add new contribution
-    current_bias += bias_contribution;
-    current_vol += vol_contribution;
-    
-    accumulated_bias_ = current_bias;
-    accumulated_volatility_ = current_vol;
-    
-    // Record latest confidence for use in emitted signals.
-    last_confidence_ = weight.confidence_score;
-
-    // Check if we should emit a signal
-    if (should_emit_signal()) {
-        TradeSignal signal;
-        signal.delta_bias_shift = current_bias;
-        signal.volatility_adjustment = current_vol;
-        
-        // Strategy selection logic
-        if (std::abs(current_bias) > 0.5) {
-            signal.strategy_toggle = (current_bias > 0) ? 1 : -1;
-        }
-        
-        signal.strategy_weight = std::min(1.0, weight.confidence_score * 2.0);
-        
-        emit_signal(signal);
-        
-        // Reset accumulators after significant signal
-        if (std::abs(current_bias) > 0.8 || std::abs(current_vol) > 0.8) {
-            accumulated_bias_ = current_bias * 0.5;
-            accumulated_volatility_ = current_vol * 0.5;
-        }
+    state.bias       = state.bias * decay + bias_contribution;
+    state.volatility = state.volatility * decay + vol_contribution;
+    state.confidence = weight.confidence_score;
+
+    // Time-weighted bias averages over three horizons.
+    const double fast   = ewma_fast_decay_.factor(dt_ns);
+    const double medium = ewma_medium_decay_.factor(dt_ns);
+    const double slow   = ewma_slow_decay_.factor(dt_ns);
+    state.ewma_fast   = state.ewma_fast   * fast   + bias_contribution * (1.0 - fast);
+    state.ewma_medium = state.ewma_medium * medium + bias_contribution * (1.0 - medium);
+    state.ewma_slow   = state.ewma_slow   * slow   + bias_contribution * (1.0 - slow);
+
+    // Realtime mode rate-limits signals; backtest mode emits on every token.
+    if (realtime && std::chrono::nanoseconds(now_ns - state.last_signal_ns) < config_.signal_cooldown) {
+        return false;
+    }
+
+    out.timestamp             = now;
+    out.timestamp_ns          = static_cast<uint64_t>(now_ns);
+    out.delta_bias_shift      = state.bias;
+    out.volatility_adjustment = state.volatility;
+    out.confidence            = state.confidence;
+    out.bias_ewma_fast        = state.ewma_fast;
+    out.bias_ewma_medium      = state.ewma_medium;
+    out.bias_ewma_slow        = state.ewma_slow;
+    out.strategy_weight       = std::min(1.0, weight.confidence_score * 2.0);
+
+    // Strategy selection logic
+    if (std::abs(state.bias) > 0.5) {
+        out.strategy_toggle = (state.bias > 0) ? 1 : -1;
+        out.spread_modifier = -0.1 * state.bias;
     }
+
+    // Reset accumulators after significant signal
+    if (std::abs(state.bias) > 0.8 || std::abs(state.volatility) > 0.8) {
+        state.bias       *= 0.5;
+        state.volatility *= 0.5;
+    }
+    return true;
+}
+
+TradeSignalEngine::TradeSignalEngine(const Config& config, std::shared_ptr<Clock> clock)
+    : step_(config)
+    , clock_(clock ? std::move(clock) : SystemClock::instance()) {
+    state_.last_update_ns = to_ns(clock_->now());
+    state_.last_signal_ns = state_.last_update_ns;
+}
+
+void TradeSignalEngine::process_semantic_weight(const SemanticWeight& weight) {
+    TradeSignal signal;
+    const bool due = step_.apply(state_, weight, clock_->now(), realtime_mode_.load(), signal);
+    ++weights_processed_;
+    if (due) emit_signal(signal);
+    publish();
+}
+
+void TradeSignalEngine::publish() {
+    snapshot_.write(Snapshot{
+        .accumulated_bias       = state_.bias,
+        .accumulated_volatility = state_.volatility,
+        .last_confidence        = state_.confidence,
+        .bias_ewma_fast         = state_.ewma_fast,
+        .bias_ewma_medium       = state_.ewma_medium,
+        .bias_ewma_slow         = state_.ewma_slow,
+        .timestamp_ns           = static_cast<uint64_t>(state_.last_update_ns),
+        .weights_processed      = weights_processed_,
+    });
 }
 
 void TradeSignalEngine::set_signal_callback(TradeSignalCallback callback) {
@@ -65,33 +115,13 @@ void TradeSignalEngine::set_backtest_mode(bool enabled) {
     realtime_mode_ = !enabled;
 }
 
-bool TradeSignalEngine::should_emit_signal() const {
-    if (!realtime_mode_.load()) return true; // Always emit in backtest mode
-    
-    auto now = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - last_signal_time_);
-    
-    return elapsed >= config_.signal_cooldown;
-}
-
-void TradeSignalEngine::emit_signal(const TradeSignal& signal_in) {
-    TradeSignal signal = signal_in;
-    auto now = std::chrono::high_resolution_clock::now();
-    signal.timestamp    = now;
-    signal.timestamp_ns = static_cast<uint64_t>(
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            now.time_since_epoch()).count());
-    signal.spread_modifier = (std::abs(signal.delta_bias_shift) > 0.5)
-                                 ? -0.1 * signal.delta_bias_shift
-                                 : 0.0;
-    signal.confidence = last_confidence_.load();
-
+void TradeSignalEngine::emit_signal(const TradeSignal& signal) {
     if (callback_) {
         callback_(signal);
         stats_.signals_generated++;
         stats_.avg_signal_strength =
             (stats_.avg_signal_strength.load() + std::abs(signal.delta_bias_shift)) / 2.0;
-        last_signal_time_ = now;
+        state_.last_signal_ns = static_cast<int64_t>(signal.timestamp_ns);
     } else {
         stats_.signals_suppressed++;
     }
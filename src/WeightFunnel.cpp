@@ -0,0 +1,43 @@
+#include "WeightFunnel.h"
+
+#include <chrono>
+
+namespace llmquant {
+
+WeightFunnel::WeightFunnel(TradeSignalEngine& engine, size_t capacity, OverflowPolicy policy)
+    : engine_(engine)
+    , queue_(capacity, policy)
+    , drainer_([this] { drain(); }) {}
+
+WeightFunnel::~WeightFunnel() {
+    close();
+}
+
+void WeightFunnel::close() {
+    closed_.store(true, std::memory_order_seq_cst);
+    queue_.close();   // releases producers blocked on a full queue
+    if (drainer_.joinable()) drainer_.join();
+}
+
+void WeightFunnel::drain() {
+    SemanticWeight batch[64];
+    uint32_t idle = 0;
+    while (true) {
+        const size_t n = queue_.pop_batch(batch);
+        for (size_t i = 0; i < n; ++i) engine_.process_semantic_weight(batch[i]);
+        if (n > 0) {
+            idle = 0;
+        } else if (closed_.load(std::memory_order_seq_cst) &&
+                   producers_.load(std::memory_order_acquire) == 0) {
+            // Every producer that saw the funnel open has finished pushing,
+            // so an empty queue now stays empty.
+            if (queue_.size_approx() == 0) break;
+        } else if (++idle < 64) {
+            cpu_relax();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+} // namespace llmquant
@@ -0,0 +1,196 @@
+#include "WeightKernels.h"
+
+#include <immintrin.h>  // SSE2/AVX2 intrinsics
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  #include <intrin.h>
+#endif
+
+// GCC/Clang only emit AVX2/FMA instructions inside functions that opt in;
+// MSVC allows the intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+  #define LLMQUANT_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#else
+  #define LLMQUANT_TARGET_AVX2_FMA
+#endif
+
+namespace llmquant {
+
+namespace {
+
+SimdLevel probe_simd_level() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2_FMA;
+    }
+#elif defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool fma     = (regs[2] & (1 << 12)) != 0;
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    __cpuidex(regs, 7, 0);
+    const bool avx2 = (regs[1] & (1 << 5)) != 0;
+    // The OS must also save the YMM state across context switches.
+    if (fma && avx2 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        return SimdLevel::AVX2_FMA;
+    }
+#endif
+    return SimdLevel::SSE2;
+}
+
+/// Add the scalar remainder [begin, n) onto already-folded lane sums.
+void accumulate_tail(const WeightColumns& w, size_t begin, WeightSums& r) {
+    for (size_t i = begin; i < w.n; ++i) {
+        const double c = w.confidence[i];
+        r.confidence += c;
+        r.sentiment  += w.sentiment[i]  * c;
+        r.volatility += w.volatility[i] * c;
+        r.bias       += w.bias[i]       * c;
+    }
+}
+
+/// Raw fixed-point sums {Σc, Σs·c, Σv·c, Σb·c} -> WeightSums.
+WeightSums scale_quantized(double c, double sc, double vc, double bc) {
+    constexpr double kInv  = 1.0 / kQuantScale;
+    constexpr double kInv2 = kInv * kInv;
+    return WeightSums{c * kInv, sc * kInv2, vc * kInv2, bc * kInv2};
+}
+
+/// Add the scalar remainder [begin, n) onto raw fixed-point sums.
+void accumulate_quantized_tail(const QuantizedWeight* w, size_t begin, size_t n,
+                               double& c, double& sc, double& vc, double& bc) {
+    for (size_t i = begin; i < n; ++i) {
+        const int32_t q = w[i].confidence;
+        c  += q;
+        sc += static_cast<double>(w[i].sentiment  * q);
+        vc += static_cast<double>(w[i].volatility * q);
+        bc += static_cast<double>(w[i].bias       * q);
+    }
+}
+
+inline double hsum128(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+LLMQUANT_TARGET_AVX2_FMA
+inline double hsum256(__m256d v) {
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+} // namespace
+
+SimdLevel detect_simd_level() {
+    static const SimdLevel level = probe_simd_level();
+    return level;
+}
+
+WeightSums accumulate_weights(const WeightColumns& cols) {
+    return detect_simd_level() == SimdLevel::AVX2_FMA ? accumulate_weights_avx2(cols)
+                                                      : accumulate_weights_sse2(cols);
+}
+
+WeightSums accumulate_quantized(const QuantizedWeight* weights, size_t n) {
+    return detect_simd_level() == SimdLevel::AVX2_FMA ? accumulate_quantized_avx2(weights, n)
+                                                      : accumulate_quantized_sse2(weights, n);
+}
+
+WeightSums accumulate_weights_sse2(const WeightColumns& w) {
+    __m128d acc_c = _mm_setzero_pd();
+    __m128d acc_s = _mm_setzero_pd();
+    __m128d acc_v = _mm_setzero_pd();
+    __m128d acc_b = _mm_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 2 <= w.n; i += 2) {
+        const __m128d c = _mm_loadu_pd(w.confidence + i);
+        acc_c = _mm_add_pd(acc_c, c);
+        acc_s = _mm_add_pd(acc_s, _mm_mul_pd(_mm_loadu_pd(w.sentiment  + i), c));
+        acc_v = _mm_add_pd(acc_v, _mm_mul_pd(_mm_loadu_pd(w.volatility + i), c));
+        acc_b = _mm_add_pd(acc_b, _mm_mul_pd(_mm_loadu_pd(w.bias       + i), c));
+    }
+
+    WeightSums r{hsum128(acc_c), hsum128(acc_s), hsum128(acc_v), hsum128(acc_b)};
+    accumulate_tail(w, i, r);
+    return r;
+}
+
+LLMQUANT_TARGET_AVX2_FMA
+WeightSums accumulate_weights_avx2(const WeightColumns& w) {
+    __m256d acc_c = _mm256_setzero_pd();
+    __m256d acc_s = _mm256_setzero_pd();
+    __m256d acc_v = _mm256_setzero_pd();
+    __m256d acc_b = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= w.n; i += 4) {
+        const __m256d c = _mm256_loadu_pd(w.confidence + i);
+        acc_c = _mm256_add_pd(acc_c, c);
+        acc_s = _mm256_fmadd_pd(_mm256_loadu_pd(w.sentiment  + i), c, acc_s);
+        acc_v = _mm256_fmadd_pd(_mm256_loadu_pd(w.volatility + i), c, acc_v);
+        acc_b = _mm256_fmadd_pd(_mm256_loadu_pd(w.bias       + i), c, acc_b);
+    }
+
+    WeightSums r{hsum256(acc_c), hsum256(acc_s), hsum256(acc_v), hsum256(acc_b)};
+    accumulate_tail(w, i, r);
+    return r;
+}
+
+WeightSums accumulate_quantized_sse2(const QuantizedWeight* w, size_t n) {
+    // Multiplier per weight is {c, 1, c, c}, so one 16x16->32 multiply yields
+    // {s*c, c, v*c, b*c}.  Products are exact in int32 and in double.
+    const __m128i lane1 = _mm_set_epi16(0, 0, -1, 0, 0, 0, -1, 0);
+    const __m128i ones  = _mm_set1_epi16(1);
+    __m128d acc_sc = _mm_setzero_pd();   // {Σs·c, Σc}
+    __m128d acc_vb = _mm_setzero_pd();   // {Σv·c, Σb·c}
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        const __m128i c = _mm_shufflehi_epi16(_mm_shufflelo_epi16(q, 0x55), 0x55);
+        const __m128i m = _mm_or_si128(_mm_andnot_si128(lane1, c), _mm_and_si128(lane1, ones));
+        const __m128i lo = _mm_mullo_epi16(q, m);
+        const __m128i hi = _mm_mulhi_epi16(q, m);
+        const __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+        const __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+        acc_sc = _mm_add_pd(acc_sc, _mm_add_pd(_mm_cvtepi32_pd(p0), _mm_cvtepi32_pd(p1)));
+        acc_vb = _mm_add_pd(acc_vb, _mm_add_pd(_mm_cvtepi32_pd(_mm_srli_si128(p0, 8)),
+                                               _mm_cvtepi32_pd(_mm_srli_si128(p1, 8))));
+    }
+
+    double c  = _mm_cvtsd_f64(_mm_unpackhi_pd(acc_sc, acc_sc));
+    double sc = _mm_cvtsd_f64(acc_sc);
+    double vc = _mm_cvtsd_f64(acc_vb);
+    double bc = _mm_cvtsd_f64(_mm_unpackhi_pd(acc_vb, acc_vb));
+    accumulate_quantized_tail(w, i, n, c, sc, vc, bc);
+    return scale_quantized(c, sc, vc, bc);
+}
+
+LLMQUANT_TARGET_AVX2_FMA
+WeightSums accumulate_quantized_avx2(const QuantizedWeight* w, size_t n) {
+    // Each weight widens to {s, c, v, b} in one register; multiplying by
+    // {c, 1, c, c} accumulates {s*c, c, v*c, b*c}.  Two chains hide FMA latency.
+    const __m256d ones = _mm256_set1_pd(1.0);
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128i q  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        const __m256d d0 = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(q));
+        const __m256d d1 = _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_unpackhi_epi64(q, q)));
+        const __m256d m0 = _mm256_blend_pd(_mm256_permute4x64_pd(d0, 0x55), ones, 0x2);
+        const __m256d m1 = _mm256_blend_pd(_mm256_permute4x64_pd(d1, 0x55), ones, 0x2);
+        acc0 = _mm256_fmadd_pd(d0, m0, acc0);
+        acc1 = _mm256_fmadd_pd(d1, m1, acc1);
+    }
+
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double c = lanes[1], sc = lanes[0], vc = lanes[2], bc = lanes[3];
+    accumulate_quantized_tail(w, i, n, c, sc, vc, bc);
+    return scale_quantized(c, sc, vc, bc);
+}
+
+} // namespace llmquant
@@ -1,15 +1,24 @@
 #include "TokenStreamSimulator.h"
 #include "TradeSignalEngine.h"
+#include "MultiSymbolSignalEngine.h"
+#include "TickerExtractor.h"
 #include "LatencyController.h"
 #include "LLMAdapter.h"
+#include "TokenVocabulary.h"
 #include "MetricsLogger.h"
 #include "Config.h"
 #include "OutputSinkImpl.h"
+#include "AsyncSinkDispatcher.h"
 #include "Deduplicator.h"
 #include "LLMStreamClient.h"
 #include "OmsAdapter.h"
 #include "RestOmsAdapter.h"
 #include "MockOmsAdapter.h"
+#include "TokenJournal.h"
+#include "MpmcQueue.h"
+#include "Clock.h"
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <iomanip>
 #include <memory>
@@ -36,6 +45,10 @@ int main(int argc, char* argv[]) {
     std::string stream_api_key;
     bool        no_color       = false;
     bool        debug_raw      = false;
+    std::string record_path;        // --record <file>: journal live stream tokens
+    std::string replay_path;        // --replay <file>: replay a journal in the simulator
+    double      replay_speed   = 1.0;
+    std::string backtest_path;      // --backtest <file>: replay a journal on journal time
     for (int i = 1; i < argc; ++i) {
         std::string arg(argv[i]);
         if (arg == "--stream" && i + 1 < argc) {
@@ -45,6 +58,14 @@ int main(int argc, char* argv[]) {
             no_color = true;
         } else if (arg == "--debug-raw") {
             debug_raw = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (arg == "--replay-speed" && i + 1 < argc) {
+            replay_speed = std::stod(argv[++i]);
+        } else if (arg == "--backtest" && i + 1 < argc) {
+            backtest_path = argv[++i];
         }
     }
 
@@ -59,10 +80,10 @@ int main(int argc, char* argv[]) {
         : "  \xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\xe2\x94\x80\n";
     const char* ARROW = no_color ? "->" : "\xe2\x86\x92";
 
-    // Load configuration (skip --stream / <key> args when looking for config path).
+    // Load configuration (skip --flag / <value> args when looking for config path).
     Config config;
     std::string config_file = "config.yaml";
-    if (argc > 1 && std::string(argv[1]) != "--stream") {
+    if (argc > 1 && argv[1][0] != '-') {
         config_file = argv[1];
     }
     bool config_loaded = config.load_from_file(config_file);
@@ -72,17 +93,23 @@ int main(int argc, char* argv[]) {
         config.get_mutable_config().token_stream.use_memory_stream = true;
     }
 
-    config.start_watching(config_file, [](const llmquant::SystemConfig& updated) {
-        std::cout << "\n[config] Hot-reloaded: bias_sensitivity="
-                  << updated.trading.bias_sensitivity << std::endl;
-    });
-
     const auto& sys_config = config.get_config();
 
-    // Deduplication layer: skip repeated tokens within a sliding TTL window.
-    auto dedup_backend = std::make_shared<llmquant::InProcessDeduplicator>();
+    // Backtests run every time-dependent component on journal time, so the
+    // replay is as fast as the CPU allows and identical from run to run.
+    std::shared_ptr<ManualClock> backtest_clock =
+        backtest_path.empty() ? nullptr : std::make_shared<ManualClock>();
+
+    // token_interval_us, when set, overrides token_interval_ms.
+    const auto token_interval = std::chrono::microseconds(
+        sys_config.token_stream.token_interval_us > 0 ? sys_config.token_stream.token_interval_us
+                                                      : sys_config.token_stream.token_interval_ms * 1000);
+
+    // Deduplication layer: skip repeated tokens within a sliding TTL window
+    // of ten token intervals.
+    auto dedup_backend = std::make_shared<llmquant::InProcessDeduplicator>(backtest_clock);
     llmquant::Deduplicator deduplicator(dedup_backend,
-        std::chrono::milliseconds(sys_config.token_stream.token_interval_ms * 10));
+        std::chrono::ceil<std::chrono::milliseconds>(token_interval * 10));
 
     // Initialize subsystem components.
     MetricsLogger logger({
@@ -105,18 +132,110 @@ int main(int argc, char* argv[]) {
     std::atomic<double>   sentiment_mean_accum{0.0};
     std::atomic<uint64_t> variance_n{0};
 
+    // One vocabulary for the whole pipeline: tokens are interned once at
+    // ingestion and flow downstream as dense IDs.
+    auto vocabulary = std::make_shared<llmquant::TokenVocabulary>();
+
     LLMAdapter llm_adapter;
+    llm_adapter.bind_vocabulary(vocabulary);
+
+    // Negation / intensifier context ("not bullish", "extremely bearish").
+    {
+        const auto& sw = sys_config.semantic_weights;
+        ContextRules rules;
+        rules.negators              = sw.negators;
+        rules.intensifiers.assign(sw.intensifiers.begin(), sw.intensifiers.end());
+        rules.window                = static_cast<size_t>(std::max(1, sw.context_window));
+        rules.bullish_multiplier    = sw.bullish_multiplier;
+        rules.bearish_multiplier    = sw.bearish_multiplier;
+        rules.volatility_multiplier = sw.volatility_multiplier;
+        llm_adapter.set_context_rules(rules);
+    }
 
-    TradeSignalEngine trade_engine({
+    // Optional dictionary file layered over the built-in weights.  Reloads
+    // are swapped in without pausing ingestion.
+    auto reload_dictionary = [&llm_adapter](const std::string& path) {
+        try {
+            if (path.empty()) {
+                llm_adapter.clear_sentiment_dictionary();
+                std::cout << "\n[config] Dictionary cleared" << std::endl;
+                return;
+            }
+            llm_adapter.reload_sentiment_dictionary(path);
+            std::cout << "\n[config] Dictionary loaded: " << path << std::endl;
+        } catch (const std::exception& ex) {
+            std::cerr << "\n[config] Dictionary load failed: " << ex.what() << std::endl;
+        }
+    };
+    if (!sys_config.semantic_weights.dictionary_path.empty()) {
+        reload_dictionary(sys_config.semantic_weights.dictionary_path);
+    }
+
+    config.set_dictionary_callback(reload_dictionary);
+    config.start_watching(config_file, [](const llmquant::SystemConfig& updated) {
+        std::cout << "\n[config] Hot-reloaded: bias_sensitivity="
+                  << updated.trading.bias_sensitivity << std::endl;
+    });
+
+    const TradeSignalEngine::Config engine_cfg{
         .bias_sensitivity = sys_config.trading.bias_sensitivity,
         .volatility_sensitivity = sys_config.trading.volatility_sensitivity,
         .signal_decay_rate = sys_config.trading.signal_decay_rate,
-        .signal_cooldown = std::chrono::microseconds(sys_config.trading.signal_cooldown_us)
-    });
+        .signal_cooldown = std::chrono::microseconds(sys_config.trading.signal_cooldown_us),
+        .decay_time_constant = std::chrono::microseconds(sys_config.trading.decay_time_constant_us),
+        .ewma_fast = std::chrono::milliseconds(sys_config.trading.ewma_fast_ms),
+        .ewma_medium = std::chrono::milliseconds(sys_config.trading.ewma_medium_ms),
+        .ewma_slow = std::chrono::milliseconds(sys_config.trading.ewma_slow_ms)
+    };
+    TradeSignalEngine trade_engine(engine_cfg, backtest_clock);
+
+    // Ticker extraction: with tickers configured, each token is attributed
+    // to the last ticker mentioned and sentiment is accumulated per symbol;
+    // unattributed tokens land on kMarketSymbol.
+    SymbolTable symbol_table;
+    TickerExtractor ticker_extractor;
+    {
+        TickerRules rules;
+        rules.tickers.assign(sys_config.symbols.tickers.begin(), sys_config.symbols.tickers.end());
+        rules.window = static_cast<uint32_t>(std::max(1, sys_config.symbols.attribution_window));
+        ticker_extractor.compile(rules, *vocabulary, symbol_table);
+    }
+    std::unique_ptr<MultiSymbolSignalEngine> symbol_engine;
+    if (ticker_extractor.active()) {
+        // One pipeline thread drives every symbol, so one shard suffices.
+        symbol_engine = std::make_unique<MultiSymbolSignalEngine>(
+            MultiSymbolSignalEngine::Config{.engine = engine_cfg, .shard_count = 1},
+            symbol_table.size(), backtest_clock);
+    }
+    auto signals_generated = [&]() -> uint64_t {
+        return symbol_engine ? symbol_engine->get_stats().signals_generated
+                             : trade_engine.get_stats().signals_generated.load();
+    };
+    auto signals_suppressed = [&]() -> uint64_t {
+        return symbol_engine ? symbol_engine->get_stats().signals_suppressed
+                             : trade_engine.get_stats().signals_suppressed.load();
+    };
 
     // Wire an in-memory sink for telemetry (signals accessible for inspection/export).
     auto memory_sink = std::make_shared<llmquant::MemoryOutputSink>();
-    trade_engine.add_output_sink(memory_sink);
+    std::vector<std::shared_ptr<OutputSink>> sinks{memory_sink};
+    const std::string& signal_path = sys_config.logging.signal_file_path;
+    if (!signal_path.empty()) {
+        if (signal_path.ends_with(".json")) {
+            sinks.push_back(std::make_shared<JsonOutputSink>(signal_path));
+        } else {
+            sinks.push_back(std::make_shared<CsvOutputSink>(signal_path));
+        }
+    }
+    // Sinks run on their own I/O thread, off token-to-signal latency.  A
+    // backtest must record every signal for its digest, so it always blocks.
+    auto sink_dispatcher = std::make_shared<AsyncSinkDispatcher>(sinks, AsyncSinkDispatcher::Config{
+        .ring_capacity = sys_config.logging.sink_ring_capacity,
+        .overflow      = backtest_clock ? AsyncSinkDispatcher::Overflow::Block
+                                        : parse_sink_overflow(sys_config.logging.sink_overflow)
+    });
+    trade_engine.add_output_sink(sink_dispatcher);
+    if (symbol_engine) symbol_engine->add_output_sink(sink_dispatcher);
 
     // Risk manager.
     llmquant::RiskManager::Config risk_cfg;
@@ -124,7 +243,8 @@ int main(int argc, char* argv[]) {
     risk_cfg.max_volatility_magnitude = 2.0;
     risk_cfg.max_signals_per_second  = 500;
     risk_cfg.max_drawdown            = 10.0;
-    llmquant::RiskManager risk_mgr(risk_cfg);
+    risk_cfg.symbol_capacity         = symbol_table.size();
+    llmquant::RiskManager risk_mgr(risk_cfg, backtest_clock);
 
     // OMS adapter: use MockOmsAdapter by default; REST if --oms <host:port> is passed.
     std::unique_ptr<llmquant::OmsAdapter> oms_adapter;
@@ -153,21 +273,51 @@ int main(int argc, char* argv[]) {
         risk_mgr.update_position(state);
     });
     // OMS alert callback wired after signal callback is registered (see below).
-    oms_adapter->start();
+    // The mock OMS pushes positions on a wall-clock timer, so backtests leave
+    // it stopped to keep the risk gates deterministic.
+    if (!backtest_clock) oms_adapter->start();
 
+    const std::string& pacing_name = sys_config.token_stream.pacing;
+    const TokenStreamSimulator::Pacing pacing = parse_pacing(pacing_name);
     TokenStreamSimulator token_sim({
-        .token_interval = std::chrono::microseconds(sys_config.token_stream.token_interval_ms * 1000),
+        .token_interval = token_interval,
         .buffer_size = sys_config.token_stream.buffer_size,
         .use_memory_stream = sys_config.token_stream.use_memory_stream,
-        .data_file_path = sys_config.token_stream.data_file_path
+        .data_file_path = sys_config.token_stream.data_file_path,
+        .replay_speed = replay_speed,
+        .pacing = pacing
     });
+    token_sim.set_vocabulary(vocabulary);
+
+    // Arrival process: metronome by default, or synthetic burst load.
+    const TokenStreamConfig& ts_cfg = sys_config.token_stream;
+    const double interval_tps = 1e6 / static_cast<double>(std::max<int64_t>(1, token_interval.count()));
+    if (ts_cfg.arrival_process == "poisson") {
+        token_sim.set_arrival_process(std::make_unique<PoissonArrivals>(interval_tps, ts_cfg.arrival_seed));
+    } else if (ts_cfg.arrival_process == "bursty") {
+        token_sim.set_arrival_process(std::make_unique<BurstyArrivals>(BurstyArrivals::Params{
+            .burst_rate_tps    = interval_tps,
+            .mean_burst_tokens = ts_cfg.burst_tokens,
+            .idle_period       = std::chrono::milliseconds(ts_cfg.burst_idle_ms)
+        }, ts_cfg.arrival_seed));
+    } else if (ts_cfg.arrival_process == "empirical") {
+        token_sim.set_arrival_process(std::make_unique<EmpiricalArrivals>(
+            EmpiricalArrivals::histogram_from_journal(ts_cfg.arrival_journal_path), ts_cfg.arrival_seed));
+    } else if (!ts_cfg.arrival_process.empty() && ts_cfg.arrival_process != "fixed") {
+        throw std::invalid_argument("Unknown arrival process: " + ts_cfg.arrival_process);
+    }
 
     // Shared token processing lambda used by both the simulator and the
     // LLMStreamClient paths.  Encapsulates dedup, latency, logging, and
     // semantic-weight pipeline so neither call site duplicates logic.
-    auto process_token = [&](const std::string& text, uint64_t seq_id) {
+    // Phrase-matching and negation context; only one token source is active per run.
+    LLMAdapter::StreamState stream_state;
+    TickerExtractor::State ticker_state;
+    auto process_token = [&](llmquant::TokenId token_id, uint64_t seq_id) {
+        const std::string_view text = vocabulary->text(token_id);
+
         // Skip duplicate tokens within the dedup window.
-        if (deduplicator.check(text) == llmquant::DedupResult::Duplicate) {
+        if (deduplicator.check(token_id, text) == llmquant::DedupResult::Duplicate) {
             return;
         }
 
@@ -175,9 +325,14 @@ int main(int argc, char* argv[]) {
 
         logger.log_token_received(text, seq_id);
 
-        auto weight = llm_adapter.map_token_to_weight(text);
+        const SymbolId symbol = ticker_extractor.attribute(ticker_state, token_id);
+        auto weight = llm_adapter.map_token_id(token_id, stream_state);
 
-        trade_engine.process_semantic_weight(weight);
+        if (symbol_engine) {
+            symbol_engine->process_semantic_weight(symbol, weight);
+        } else {
+            trade_engine.process_semantic_weight(weight);
+        }
 
         latency_ctrl.end_measurement();
 
@@ -201,9 +356,37 @@ int main(int argc, char* argv[]) {
         latency_ctrl.update_semantic_pressure(current_variance);
     };
 
+    // Every token source feeds one bounded queue; a single pipeline thread
+    // drains it, so process_token never runs concurrently with itself and
+    // the signal engines keep their single writer.
+    struct IngestItem {
+        TokenId  token_id{0};
+        uint64_t sequence_id{0};
+    };
+    MpmcQueue<IngestItem> ingest_queue(sys_config.token_stream.ingest_queue_capacity,
+                                       parse_overflow_policy(sys_config.token_stream.ingest_overflow));
+    // jthread: an exception unwinding main still stops and joins the drainer.
+    std::jthread pipeline_thread([&](std::stop_token stop) {
+        IngestItem items[64];
+        uint32_t idle = 0;
+        while (true) {
+            const size_t n = ingest_queue.pop_batch(items);
+            for (size_t i = 0; i < n; ++i) process_token(items[i].token_id, items[i].sequence_id);
+            if (n > 0) {
+                idle = 0;
+            } else if (ingest_queue.closed() || stop.stop_requested()) {
+                break;   // closed and drained
+            } else if (++idle < 64) {
+                cpu_relax();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    });
+
     // Set up simulator callback.
     token_sim.set_token_callback([&](const Token& token) {
-        process_token(token.text, token.sequence_id);
+        ingest_queue.push({token.token_id, token.sequence_id});
     });
 
     // Shared risk-block reason for display on the same line.
@@ -217,15 +400,20 @@ int main(int argc, char* argv[]) {
         last_block_reason = event;
     });
 
-    trade_engine.set_signal_callback([&](const TradeSignal& signal) {
+    auto on_signal = [&](const TradeSignal& signal) {
+        bool passed = risk_mgr.evaluate(signal);
+        if (backtest_clock) {
+            // Signal timestamps are journal time; there is no live latency to show.
+            if (passed) logger.log_signal_generated(signal.delta_bias_shift, signal.volatility_adjustment, 0);
+            return;
+        }
+
         auto ts_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                          signal.timestamp.time_since_epoch()).count();
         auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
                               std::chrono::high_resolution_clock::now() - signal.timestamp
                           ).count();
 
-        bool passed = risk_mgr.evaluate(signal);
-
         std::string gate_str;
         if (passed) {
             gate_str = std::string(" ") + C("\033[32m") + "PASS" + C("\033[0m");
@@ -244,8 +432,9 @@ int main(int argc, char* argv[]) {
                                    << signal.delta_bias_shift  << "  "
                   << std::setw(8)  << signal.volatility_adjustment << "  "
                   << std::setw(6)  << latency_us << "μs"
-                  << gate_str
-                  << std::flush;
+                  << gate_str;
+        if (signal.symbol != kMarketSymbol) std::cout << "  " << symbol_table.name(signal.symbol);
+        std::cout << std::flush;
 
         if (passed) {
             logger.log_signal_generated(
@@ -253,17 +442,67 @@ int main(int argc, char* argv[]) {
                 signal.volatility_adjustment,
                 static_cast<uint64_t>(latency_us));
         }
-    });
+    };
+    trade_engine.set_signal_callback(on_signal);
+    if (symbol_engine) symbol_engine->set_signal_callback(on_signal);
+
+    // Backtest: feed the journal straight through the pipeline on this
+    // thread, advancing the shared clock to each record's receive time.
+    if (backtest_clock) {
+        TokenJournalReader journal(backtest_path);
+        JournalRecord rec;
+        uint64_t records = 0;
+        uint64_t last_ns = journal.origin_ns();
+        const auto wall_start = std::chrono::steady_clock::now();
+        while (g_running && journal.next(rec)) {
+            backtest_clock->advance_to_ns(rec.receive_ns);
+            process_token(vocabulary->intern(rec.text), rec.sequence);
+            last_ns = rec.receive_ns;
+            ++records;
+        }
+        sink_dispatcher->close();
+        const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        const double journal_s = last_ns > journal.origin_ns()
+            ? static_cast<double>(last_ns - journal.origin_ns()) / 1e9 : 0.0;
+
+        // Order-sensitive digest of every emitted signal: equal digests mean
+        // bit-identical backtests.
+        uint64_t digest = 14695981039346656037ULL;
+        auto mix = [&digest](uint64_t v) {
+            for (int b = 0; b < 64; b += 8) {
+                digest ^= (v >> b) & 0xFF;
+                digest *= 1099511628211ULL;
+            }
+        };
+        for (const TradeSignal& s : memory_sink->get_signals()) {
+            mix(s.timestamp_ns);
+            mix(std::bit_cast<uint64_t>(s.delta_bias_shift));
+            mix(std::bit_cast<uint64_t>(s.volatility_adjustment));
+        }
+
+        config.stop_watching();
+        std::cout << "\n  BACKTEST " << backtest_path << "\n" << DIV1;
+        std::cout << "  Records replayed : " << records << "\n";
+        std::cout << "  Journal span     : " << std::fixed << std::setprecision(3) << journal_s << " s\n";
+        std::cout << "  Wall time        : " << wall_s << " s\n";
+        std::cout << "  Signals emitted  : " << signals_generated() << "\n";
+        std::cout << "  Signals passed   : " << risk_mgr.get_stats().signals_passed.load() << "\n";
+        std::cout << "  Duplicates       : " << dedup_backend->total_duplicates() << "\n";
+        std::cout << "  Result digest    : " << std::hex << digest << std::dec << "\n" << DIV1;
+        return 0;
+    }
 
     // Load test tokens for simulator path.
-    if (sys_config.token_stream.use_memory_stream) {
+    if (!replay_path.empty()) {
+        token_sim.replay_journal(replay_path);
+    } else if (sys_config.token_stream.use_memory_stream) {
         token_sim.load_tokens_from_memory({
             "crash", "panic", "inevitable", "guarantee", "bullish", "collapse",
             "volatile", "surge", "confident", "uncertain", "rally", "plunge",
             "breakout", "support", "resistance", "momentum"
         });
     } else {
-        token_sim.load_tokens_from_file(sys_config.token_stream.data_file_path);
+        token_sim.stream_tokens_from_file(sys_config.token_stream.data_file_path);
     }
 
     // Print banner.
@@ -274,9 +513,11 @@ int main(int argc, char* argv[]) {
         std::cout << "  MODE    : LIVE STREAM  (gpt-4o " << ARROW << " api.openai.com:443)\n";
         std::cout << "  PROMPT  : market sentiment / tickers / directional\n";
         std::cout << "  INTERVAL: 5s per request\n";
+    } else if (!replay_path.empty()) {
+        std::cout << "  MODE    : REPLAY  (" << replay_path << ", speed " << replay_speed << "x)\n";
     } else {
         std::cout << "  MODE    : SIMULATOR  (in-memory token loop)\n";
-        std::cout << "  INTERVAL: " << sys_config.token_stream.token_interval_ms << "ms/token\n";
+        std::cout << "  INTERVAL: " << token_interval.count() << "us/token (" << pacing_name << " pacing)\n";
     }
     std::cout << "  LATENCY : target p99 < " << sys_config.latency.target_latency_us << "us\n";
     std::cout << DIV1 << "\n";
@@ -305,8 +546,11 @@ int main(int argc, char* argv[]) {
 
         stream_client = std::make_unique<llmquant::LLMStreamClient>(stream_cfg);
         stream_client->set_token_callback([&](const std::string& text) {
-            process_token(text, 0);
+            ingest_queue.push({vocabulary->intern(text), 0});
         });
+        if (!record_path.empty()) {
+            stream_client->set_journal(std::make_shared<TokenJournalWriter>(record_path));
+        }
         stream_client->set_done_callback([](const std::string& err) {
             if (!err.empty())
                 std::cerr << "\n  [stream] " << err << std::endl;
@@ -328,12 +572,11 @@ int main(int argc, char* argv[]) {
         uint64_t tps = token_count_window.exchange(0);
         double   max_tps = stream_mode
                                ? 50.0   // gpt-4o emits ~10-30 tokens/s
-                               : static_cast<double>(1000000 / std::max(1, sys_config.token_stream.token_interval_ms));
+                               : interval_tps;
         latency_ctrl.update_ingestion_pressure(static_cast<double>(tps), max_tps);
 
         // Queue pressure via suppressed-signal count.
-        auto& eng_stats = trade_engine.get_stats();
-        latency_ctrl.update_queue_pressure(eng_stats.signals_suppressed.load(), 1024);
+        latency_ctrl.update_queue_pressure(signals_suppressed(), 1024);
 
         double backoff = latency_ctrl.get_backoff_multiplier();
 
@@ -362,15 +605,22 @@ int main(int argc, char* argv[]) {
                   << "  PRESS:" << press_colour
                                << std::fixed << std::setprecision(2)
                                << pressure.composite << C("\033[0m")
-                  << "  BKOF:" << std::setprecision(1) << backoff << "x"
+                  << "  BKOF:" << std::setprecision(1) << backoff << "x";
+        if (!symbol_engine) {
+            // Seqlock snapshot: consistent, and never stalls the pipeline thread.
+            std::cout << "  BIAS:" << std::showpos << std::setprecision(3)
+                      << trade_engine.snapshot().accumulated_bias << std::noshowpos;
+        }
+        std::cout
                   << "  DEDUP:" << dedup_backend->total_duplicates()
-                  << "  SIG-PASS:" << eng_stats.signals_generated.load()
-                  << "  BLOCK:"   << (eng_stats.signals_suppressed.load()
+                  << "  SIG-PASS:" << signals_generated()
+                  << "  BLOCK:"   << (signals_suppressed()
                                       + risk_mgr.get_stats().signals_blocked_magnitude.load()
                                       + risk_mgr.get_stats().signals_blocked_confidence.load()
                                       + risk_mgr.get_stats().signals_blocked_rate.load()
                                       + risk_mgr.get_stats().signals_blocked_drawdown.load()
-                                      + risk_mgr.get_stats().signals_blocked_position.load())
+                                      + risk_mgr.get_stats().signals_blocked_position.load()
+                                      + risk_mgr.get_stats().signals_blocked_symbol.load())
                   << std::flush;
 
         // Alert if P99 exceeds budget.
@@ -382,6 +632,9 @@ int main(int argc, char* argv[]) {
 
     token_sim.stop();
     if (stream_client) stream_client->stop();
+    ingest_queue.close();
+    pipeline_thread.join();
+    sink_dispatcher->close();
     oms_adapter->stop();
     config.stop_watching();
 
@@ -390,17 +643,32 @@ int main(int argc, char* argv[]) {
     std::cout << "  SESSION SUMMARY\n";
     std::cout << "  ---------------------------------------------------------\n";
     std::cout << "  Tokens processed : " << variance_n.load() << "\n";
-    std::cout << "  Signals emitted  : " << trade_engine.get_stats().signals_generated.load() << "\n";
+    std::cout << "  Signals emitted  : " << signals_generated() << "\n";
     std::cout << "  Signals blocked  : "
               << (risk_mgr.get_stats().signals_blocked_magnitude.load()
                   + risk_mgr.get_stats().signals_blocked_confidence.load()
                   + risk_mgr.get_stats().signals_blocked_rate.load()
                   + risk_mgr.get_stats().signals_blocked_drawdown.load()
-                  + risk_mgr.get_stats().signals_blocked_position.load()) << "\n";
+                  + risk_mgr.get_stats().signals_blocked_position.load()
+                  + risk_mgr.get_stats().signals_blocked_symbol.load()) << "\n";
     std::cout << "  Memory sink size : " << memory_sink->get_signals().size() << "\n";
+    for (size_t i = 0; i < sink_dispatcher->sink_count(); ++i) {
+        const AsyncSinkDispatcher::SinkStats ss = sink_dispatcher->stats(i);
+        std::cout << "  Sink " << i << "           : " << ss.written << " written  "
+                  << ss.dropped << " dropped  max lag " << ss.max_lag << "\n";
+    }
+    std::cout << "  Ingest drops     : " << ingest_queue.dropped() << "\n";
     std::cout << "  Avg latency      : " << final_stats.avg_latency.count() << "us\n";
     std::cout << "  P99 latency      : " << final_stats.p99_latency.count() << "us\n";
     std::cout << "  Max latency      : " << final_stats.max_latency.count() << "us\n";
+    if (!stream_mode) {
+        const auto& sim_stats = token_sim.get_stats();
+        const LatencyHistogram::Summary cb = sim_stats.callback_latency.summary();
+        std::cout << "  Sim callback     : p50 " << cb.p50_ns << "ns  p99 " << cb.p99_ns
+                  << "ns  p99.9 " << cb.p999_ns << "ns  max " << cb.max_ns << "ns\n";
+        std::cout << "  Sim rate (10 s)  : " << std::setprecision(0)
+                  << sim_stats.emission_rate.rate(std::chrono::seconds(10)) << " tokens/s\n";
+    }
     std::cout << "  ---------------------------------------------------------\n\n";
 
     logger.log_performance_summary();
@@ -222,11 +222,6 @@ TEST(ChaosIntegration, test_chaos_token_simulator_restart_under_load) {
         << "Simulator phase 1 must have emitted at least one token";
     EXPECT_GT(token_count_phase2.load(), 0u)
         << "Simulator must emit tokens after a stop()/start() restart";
-
-    // The ring-buffer-drops stat must not indicate an error condition beyond
-    // what a tiny interval would naturally produce.
-    // We merely assert no negative/wrapped value — stat is uint64_t so just read it.
-    EXPECT_GE(sim.get_stats().ring_buffer_drops.load(), 0u);
 }
 
 // ---------------------------------------------------------------------------
@@ -2,10 +2,25 @@
 #include "LLMAdapter.h"
 #include "LatencyController.h"
 #include "TradeSignalEngine.h"
+#include "WeightKernels.h"
+#include "TokenVocabulary.h"
+#include "LexiconFile.h"
+#include "LatencyHistogram.h"
+#include "MultiStreamSimulator.h"
+#include "TickerExtractor.h"
+#include "ExpDecay.h"
+#include "AsyncSinkDispatcher.h"
+#include "OutputSinkImpl.h"
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <numeric>
+#include <memory>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <iostream>
 
 using namespace llmquant;
@@ -105,7 +120,7 @@ TEST(PerformanceBench, bench_llm_adapter_1m_tokens_under_2s) {
 }
 
 // ============================================================
-// Bench 5: SIMD batch not slower than scalar (2x slack allowed)
+// Bench 5: SIMD batch faster than scalar
 // ============================================================
 TEST(PerformanceBench, bench_simd_batch_faster_than_scalar_for_large_sequence) {
     LLMAdapter adapter;
@@ -113,16 +128,345 @@ TEST(PerformanceBench, bench_simd_batch_faster_than_scalar_for_large_sequence) {
         "crash","panic","bullish","bearish","volatile","rally","surge","confident"
     };
     std::vector<std::string> tokens;
-    tokens.reserve(64);
-    for (size_t i = 0; i < 64; ++i) tokens.push_back(vocab[i % vocab.size()]);
+    tokens.reserve(1024);
+    for (size_t i = 0; i < 1024; ++i) tokens.push_back(vocab[i % vocab.size()]);
 
+    const char* level = detect_simd_level() == SimdLevel::AVX2_FMA ? "AVX2+FMA" : "SSE2";
     auto scalar_samples = measure_us([&]{ adapter.map_sequence_to_weight(tokens); }, 100, 1000);
     auto simd_samples   = measure_us([&]{ adapter.map_sequence_simd(tokens); },     100, 1000);
 
     double scalar_p50 = percentile(scalar_samples, 0.50);
     double simd_p50   = percentile(simd_samples,   0.50);
-    std::cout << "[bench] Scalar 64-token p50: " << scalar_p50 << " μs\n";
-    std::cout << "[bench] SIMD   64-token p50: " << simd_p50   << " μs\n";
-    // SIMD should not be slower than scalar (allow 2x slack for measurement overhead).
-    EXPECT_LT(simd_p50, scalar_p50 * 2.0);
+    std::cout << "[bench] Scalar 1024-token p50: " << scalar_p50 << " μs\n";
+    std::cout << "[bench] SIMD   1024-token p50: " << simd_p50   << " μs (" << level << ")\n";
+    EXPECT_LT(simd_p50, scalar_p50);
+}
+
+// ============================================================
+// Bench 6: 50k-entry dictionary — unordered_map vs compiled perfect hash
+// ============================================================
+TEST(PerformanceBench, bench_llm_adapter_compiled_lexicon_vs_map_50k_entries) {
+    const size_t dict_size = 50'000;
+    LLMAdapter map_adapter;
+    LLMAdapter mph_adapter;
+    for (size_t i = 0; i < dict_size; ++i) {
+        std::string token = "lex" + std::to_string(i * 7919);
+        SemanticWeight w{0.001 * static_cast<double>(i % 1000), 0.8, 0.2, 0.0};
+        map_adapter.add_token_mapping(token, w);
+        mph_adapter.add_token_mapping(token, w);
+    }
+    mph_adapter.freeze();
+
+    // 3 hits for every miss, spread over the whole dictionary.
+    std::vector<std::string> queries;
+    queries.reserve(4096);
+    for (size_t i = 0; i < 4096; ++i) {
+        queries.push_back(i % 4 == 3 ? "absent" + std::to_string(i)
+                                     : "lex" + std::to_string(((i * 12289) % dict_size) * 7919));
+    }
+
+    const size_t n = 1'000'000;
+    auto run = [&](const LLMAdapter& adapter) {
+        double checksum = 0.0;
+        auto t0 = high_resolution_clock::now();
+        for (size_t i = 0; i < n; ++i) {
+            checksum += adapter.map_token_to_weight(queries[i % queries.size()]).sentiment_score;
+        }
+        auto t1 = high_resolution_clock::now();
+        return std::make_pair(duration<double, std::nano>(t1 - t0).count() / static_cast<double>(n),
+                              checksum);
+    };
+
+    auto [map_ns, map_sum] = run(map_adapter);
+    auto [mph_ns, mph_sum] = run(mph_adapter);
+    std::cout << "[bench] 50k dict unordered_map lookup: " << map_ns << " ns/token\n";
+    std::cout << "[bench] 50k dict compiled MPH  lookup: " << mph_ns << " ns/token\n";
+
+    EXPECT_DOUBLE_EQ(map_sum, mph_sum) << "Both backends must resolve identical weights";
+    EXPECT_LT(mph_ns, map_ns) << "Compiled lexicon must beat the unordered_map probe";
+}
+
+// ============================================================
+// Bench 7: Interned token IDs vs text lookup
+// ============================================================
+TEST(PerformanceBench, bench_llm_adapter_token_id_faster_than_text_lookup) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+
+    const std::vector<std::string> texts{
+        "crash", "panic", "bullish", "bearish", "volatile", "rally", "surge",
+        "confident", "uncertain", "breakout", "support", "resistance"
+    };
+    std::vector<TokenId> ids;
+    for (const auto& t : texts) ids.push_back(vocab->intern(t));
+
+    const size_t n = 1'000'000;
+    double text_sum = 0.0, id_sum = 0.0;
+
+    auto t0 = high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i) text_sum += adapter.map_token_to_weight(texts[i % texts.size()]).sentiment_score;
+    auto t1 = high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i) id_sum += adapter.map_token_id(ids[i % ids.size()]).sentiment_score;
+    auto t2 = high_resolution_clock::now();
+
+    double text_ns = duration<double, std::nano>(t1 - t0).count() / static_cast<double>(n);
+    double id_ns   = duration<double, std::nano>(t2 - t1).count() / static_cast<double>(n);
+    std::cout << "[bench] text lookup: " << text_ns << " ns/token\n";
+    std::cout << "[bench] ID lookup  : " << id_ns   << " ns/token\n";
+
+    EXPECT_DOUBLE_EQ(text_sum, id_sum);
+    EXPECT_LT(id_ns, text_ns);
+}
+
+// ============================================================
+// Bench 8: Cold start — text dictionary parse vs mapped binary lexicon
+// ============================================================
+TEST(PerformanceBench, bench_binary_lexicon_cold_start_vs_text_loader) {
+    const size_t dict_size = 200'000;
+    const std::string text_path = "/tmp/llmquant_bench_lexicon.txt";
+    const std::string bin_path  = "/tmp/llmquant_bench_lexicon.lexb";
+    {
+        std::ofstream f(text_path);
+        for (size_t i = 0; i < dict_size; ++i) {
+            f << "lex" << i * 7919 << ' ' << 0.001 * static_cast<double>(i % 1000)
+              << " 0.8 0.2 0.0\n";
+        }
+    }
+    write_binary_lexicon(bin_path, read_text_dictionary(text_path));
+
+    auto load_ms = [](const std::string& path) {
+        LLMAdapter adapter;
+        auto t0 = high_resolution_clock::now();
+        adapter.reload_sentiment_dictionary(path);
+        auto t1 = high_resolution_clock::now();
+        const double probe = adapter.map_token_to_weight("lex" + std::to_string(1234 * 7919))
+                                 .sentiment_score;
+        return std::make_pair(duration<double, std::milli>(t1 - t0).count(), probe);
+    };
+
+    auto [text_ms, text_probe] = load_ms(text_path);
+    auto [bin_ms, bin_probe]   = load_ms(bin_path);
+    std::cout << "[bench] 200k dict text load  : " << text_ms << " ms\n";
+    std::cout << "[bench] 200k dict binary load: " << bin_ms  << " ms\n";
+
+    std::remove(text_path.c_str());
+    std::remove(bin_path.c_str());
+
+    EXPECT_DOUBLE_EQ(text_probe, bin_probe);
+    EXPECT_DOUBLE_EQ(bin_probe, 0.234);
+    EXPECT_LT(bin_ms * 5.0, text_ms) << "Mapped lexicon must load at least 5x faster than parsing";
+}
+
+// ============================================================
+// Bench 9: Int16 vs full per-ID weight storage on a lexicon larger than L2
+// ============================================================
+TEST(PerformanceBench, bench_quantized_weight_storage_accuracy_vs_throughput) {
+    const size_t dict_size = 500'000;   // full table ~20 MB, Int16 table ~5 MB
+    const std::string bin_path = "/tmp/llmquant_bench_quantized.lexb";
+    {
+        DictionaryEntries entries;
+        for (size_t i = 0; i < dict_size; ++i) {
+            const double x = static_cast<double>((i * 7919) % 2001) / 1000.0 - 1.0;
+            entries.tokens["lex" + std::to_string(i)] =
+                SemanticWeight{x, 0.2 + 0.8 * std::abs(x), std::abs(x) * 0.5, -x};
+        }
+        write_binary_lexicon(bin_path, entries);
+    }
+
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter full;
+    LLMAdapter compact(LLMAdapter::WeightStorage::Int16);
+    for (LLMAdapter* a : {&full, &compact}) {
+        a->bind_vocabulary(vocab);
+        a->reload_sentiment_dictionary(bin_path);
+    }
+    std::remove(bin_path.c_str());
+
+    std::vector<TokenId> all_ids;
+    all_ids.reserve(dict_size);
+    for (size_t i = 0; i < dict_size; ++i) all_ids.push_back(vocab->intern("lex" + std::to_string(i)));
+    full.map_id_sequence(all_ids);      // resolve every ID once
+    compact.map_id_sequence(all_ids);
+
+    // Random 256-token documents spread over the whole vocabulary.
+    std::vector<std::vector<TokenId>> docs(512);
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    for (auto& doc : docs) {
+        for (size_t j = 0; j < 256; ++j) {
+            rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+            doc.push_back(all_ids[rng % dict_size]);
+        }
+    }
+
+    double max_err = 0.0;
+    for (const auto& doc : docs) {
+        const SemanticWeight a = full.map_id_sequence(doc);
+        const SemanticWeight b = compact.map_id_sequence(doc);
+        max_err = std::max({max_err, std::abs(a.sentiment_score - b.sentiment_score),
+                            std::abs(a.confidence_score - b.confidence_score),
+                            std::abs(a.volatility_score - b.volatility_score),
+                            std::abs(a.directional_bias - b.directional_bias)});
+    }
+
+    const size_t rounds = 8;
+    auto run = [&](const LLMAdapter& adapter) {
+        double checksum = 0.0;
+        auto t0 = high_resolution_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (const auto& doc : docs) checksum += adapter.map_id_sequence(doc).sentiment_score;
+        }
+        auto t1 = high_resolution_clock::now();
+        const double tokens = static_cast<double>(rounds * docs.size() * docs[0].size());
+        return std::make_pair(duration<double, std::nano>(t1 - t0).count() / tokens, checksum);
+    };
+    auto [full_ns, full_sum]       = run(full);
+    auto [compact_ns, compact_sum] = run(compact);
+
+    std::cout << "[bench] 500k vocab full  (32 B/weight): " << full_ns    << " ns/token\n";
+    std::cout << "[bench] 500k vocab int16 ( 8 B/weight): " << compact_ns << " ns/token\n";
+    std::cout << "[bench] int16 max abs error per aggregate field: " << max_err << "\n";
+
+    EXPECT_LT(max_err, 1e-4);
+    EXPECT_NEAR(full_sum, compact_sum, 1e-4 * static_cast<double>(rounds * docs.size()));
+    EXPECT_LT(compact_ns, full_ns * 1.5) << "Int16 storage must not cost throughput";
+}
+
+// Aggregate emission rate of the multi-stream simulator with a trivial consumer.
+TEST(PerformanceBench, bench_multi_stream_simulator_aggregate_over_1m_tokens_per_sec) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count   = 64;
+    cfg.token_interval = nanoseconds{0};   // flat out: measures the emit path itself
+    MultiStreamSimulator sim(cfg);
+    std::vector<std::string> corpus;
+    for (int i = 0; i < 4096; ++i) corpus.push_back("tok" + std::to_string(i));
+    sim.load_tokens_from_memory(corpus);
+
+    std::atomic<uint64_t> checksum{0};
+    sim.set_token_callback([&](const Token& tok) {
+        if (tok.token_id == 0) checksum.fetch_add(1, std::memory_order_relaxed);
+    });
+    sim.start();
+    std::this_thread::sleep_for(milliseconds(300));
+    sim.stop();
+
+    const MultiStreamSimulator::Stats stats = sim.get_stats();
+    std::cout << "[bench] multi-stream: " << sim.worker_count() << " workers, "
+              << stats.achieved_rate_tps / 1e6 << " M tokens/s\n";
+    EXPECT_GT(stats.achieved_rate_tps, 1e6);
+}
+
+// Cost of one histogram record() on the simulator's callback-timing path.
+TEST(PerformanceBench, bench_latency_histogram_record_under_20ns) {
+    LatencyHistogram hist;
+    constexpr uint64_t kSamples = 10'000'000;
+    const auto t0 = steady_clock::now();
+    for (uint64_t i = 0; i < kSamples; ++i) hist.record((i * 2654435761u) & 0xFFFFF);
+    const auto t1 = steady_clock::now();
+
+    const double ns_per_record = duration<double, std::nano>(t1 - t0).count() / kSamples;
+    std::cout << "[bench] LatencyHistogram record: " << ns_per_record << " ns\n";
+    EXPECT_EQ(hist.count(), kSamples);
+#ifdef NDEBUG
+    EXPECT_LT(ns_per_record, 20.0) << "record() must stay under 20 ns";
+#else
+    EXPECT_LT(ns_per_record, 100.0) << "unoptimised build: std::atomic calls are not inlined";
+#endif
+}
+
+// Ticker attribution on the pipeline thread: one table load per token.
+TEST(PerformanceBench, bench_ticker_attribution_under_20ns) {
+    TokenVocabulary vocab;
+    SymbolTable symbols;
+    TickerExtractor extractor;
+    TickerRules rules;
+    for (const char* t : {"NVDA", "TSLA", "AAPL", "MSFT", "AMZN", "META", "GOOG", "SPX"}) {
+        rules.tickers.push_back({t, {}});
+    }
+    extractor.compile(rules, vocab, symbols);
+
+    // Mostly ordinary words with a ticker every ~20 tokens.
+    std::vector<TokenId> stream;
+    for (int i = 0; i < 4096; ++i) {
+        stream.push_back(i % 20 == 0 ? vocab.find(rules.tickers[i % 8].first)
+                                     : vocab.intern("word" + std::to_string(i % 500)));
+    }
+
+    constexpr int kPasses = 2000;
+    TickerExtractor::State state;
+    uint64_t attributed = 0;
+    const auto t0 = steady_clock::now();
+    for (int p = 0; p < kPasses; ++p) {
+        for (TokenId id : stream) attributed += extractor.attribute(state, id) != kMarketSymbol;
+    }
+    const auto t1 = steady_clock::now();
+
+    const double ns_per_token =
+        duration<double, std::nano>(t1 - t0).count() / (static_cast<double>(kPasses) * stream.size());
+    std::cout << "[bench] Ticker attribution: " << ns_per_token << " ns/token\n";
+    EXPECT_GT(attributed, 0u);
+#ifdef NDEBUG
+    EXPECT_LT(ns_per_token, 20.0) << "attribute() must stay a constant-time table lookup";
+#else
+    EXPECT_LT(ns_per_token, 100.0) << "unoptimised build";
+#endif
+}
+
+// Elapsed-time decay factor: paid four times per token by TradeSignalEngine.
+TEST(PerformanceBench, bench_exp_decay_factor_under_10ns) {
+    const ExpDecay decay(std::chrono::milliseconds{650});
+    constexpr int64_t kSamples = 10'000'000;
+    double sink = 0.0;
+    const auto t0 = steady_clock::now();
+    for (int64_t i = 0; i < kSamples; ++i) sink += decay.factor((i * 2654435761LL) & 0x3FFFFFFF);
+    const auto t1 = steady_clock::now();
+
+    const double ns_per_call = duration<double, std::nano>(t1 - t0).count() / kSamples;
+    std::cout << "[bench] ExpDecay factor: " << ns_per_call << " ns (sum " << sink << ")\n";
+    EXPECT_GT(sink, 0.0);
+#ifdef NDEBUG
+    EXPECT_LT(ns_per_call, 10.0) << "factor() must stay a table load and a cubic";
+#else
+    EXPECT_LT(ns_per_call, 100.0) << "unoptimised build";
+#endif
+}
+
+// Sink cost on the signal path: direct CsvOutputSink formatting vs handing
+// the signal to AsyncSinkDispatcher's ring.
+TEST(PerformanceBench, bench_async_sink_emit_cheaper_than_csv) {
+    constexpr int kSignals = 50'000;
+    TradeSignal sig;
+    sig.delta_bias_shift = 0.123456;
+    sig.volatility_adjustment = 0.654321;
+
+    const std::string direct_path = "bench_sink_direct.csv";
+    const std::string async_path  = "bench_sink_async.csv";
+    double direct_ns = 0.0;
+    {
+        CsvOutputSink csv(direct_path);
+        const auto t0 = steady_clock::now();
+        for (int i = 0; i < kSignals; ++i) {
+            sig.timestamp_ns = static_cast<uint64_t>(i);
+            csv.emit(sig);
+        }
+        direct_ns = duration<double, std::nano>(steady_clock::now() - t0).count() / kSignals;
+    }
+    double async_ns = 0.0;
+    {
+        AsyncSinkDispatcher dispatcher({std::make_shared<CsvOutputSink>(async_path)},
+                                       AsyncSinkDispatcher::Config{.ring_capacity = kSignals});
+        const auto t0 = steady_clock::now();
+        for (int i = 0; i < kSignals; ++i) {
+            sig.timestamp_ns = static_cast<uint64_t>(i);
+            dispatcher.emit(sig);
+        }
+        async_ns = duration<double, std::nano>(steady_clock::now() - t0).count() / kSignals;
+        dispatcher.close();
+        EXPECT_EQ(dispatcher.stats(0).written, static_cast<uint64_t>(kSignals));
+    }
+    std::remove(direct_path.c_str());
+    std::remove(async_path.c_str());
+
+    std::cout << "[bench] Sink emit: direct CSV " << direct_ns << " ns, async " << async_ns << " ns\n";
+    EXPECT_LT(async_ns, direct_ns) << "dispatch must be cheaper than formatting on the signal path";
 }
@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include "ArrivalProcess.h"
+#include "TokenJournal.h"
+#include "TokenStreamSimulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+using std::chrono::nanoseconds;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<int64_t> draw(ArrivalProcess& process, size_t n) {
+    std::vector<int64_t> gaps;
+    gaps.reserve(n);
+    for (size_t i = 0; i < n; ++i) gaps.push_back(process.next_gap().count());
+    return gaps;
+}
+
+static double mean(const std::vector<int64_t>& v) {
+    double sum = 0.0;
+    for (int64_t x : v) sum += static_cast<double>(x);
+    return sum / static_cast<double>(v.size());
+}
+
+// ---------------------------------------------------------------------------
+// Poisson
+// ---------------------------------------------------------------------------
+
+TEST(ArrivalProcessTest, test_poisson_arrivals_mean_gap_matches_rate) {
+    PoissonArrivals poisson(10000.0, 7);   // mean gap 100 us
+    const std::vector<int64_t> gaps = draw(poisson, 200000);
+    EXPECT_NEAR(mean(gaps), 100000.0, 1500.0);
+    for (int64_t g : gaps) ASSERT_GE(g, 0);
+}
+
+TEST(ArrivalProcessTest, test_poisson_arrivals_seed_is_deterministic) {
+    PoissonArrivals a(500.0, 1234);
+    PoissonArrivals b(500.0, 1234);
+    PoissonArrivals c(500.0, 1235);
+    const std::vector<int64_t> ga = draw(a, 1000);
+    EXPECT_EQ(ga, draw(b, 1000));
+    EXPECT_NE(ga, draw(c, 1000));
+
+    a.reset();
+    EXPECT_EQ(ga, draw(a, 1000));
+}
+
+TEST(ArrivalProcessTest, test_poisson_arrivals_rejects_non_positive_rate) {
+    EXPECT_THROW(PoissonArrivals(0.0, 1), std::invalid_argument);
+    EXPECT_THROW(PoissonArrivals(-5.0, 1), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Bursty on/off
+// ---------------------------------------------------------------------------
+
+TEST(ArrivalProcessTest, test_bursty_arrivals_alternate_bursts_and_idle_periods) {
+    BurstyArrivals::Params params;
+    params.burst_rate_tps    = 1000.0;   // 1 ms mean gap inside a burst
+    params.mean_burst_tokens = 50.0;
+    params.idle_period       = std::chrono::seconds(5);
+    BurstyArrivals bursty(params, 99);
+
+    const std::vector<int64_t> gaps = draw(bursty, 100000);
+    size_t idles = 0;
+    for (int64_t g : gaps) {
+        if (g >= 5'000'000'000) ++idles;
+    }
+    // ~1 idle per 50 tokens.
+    EXPECT_GT(idles, 1700u);
+    EXPECT_LT(idles, 2300u);
+
+    BurstyArrivals again(params, 99);
+    EXPECT_EQ(gaps, draw(again, 100000));
+}
+
+TEST(ArrivalProcessTest, test_bursty_arrivals_rejects_bad_params) {
+    BurstyArrivals::Params params;
+    params.burst_rate_tps = 0.0;
+    EXPECT_THROW(BurstyArrivals(params, 1), std::invalid_argument);
+    params.burst_rate_tps    = 10.0;
+    params.mean_burst_tokens = 0.5;
+    EXPECT_THROW(BurstyArrivals(params, 1), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Empirical histogram
+// ---------------------------------------------------------------------------
+
+TEST(ArrivalProcessTest, test_empirical_arrivals_follow_histogram_weights) {
+    EmpiricalArrivals empirical({{nanoseconds(1000), 3.0},      // [0, 1 us): 75%
+                                 {nanoseconds(1000000), 0.0},   // never
+                                 {nanoseconds(2000000), 1.0}},  // [1, 2 ms): 25%
+                                5);
+    const std::vector<int64_t> gaps = draw(empirical, 40000);
+    size_t short_gaps = 0;
+    for (int64_t g : gaps) {
+        if (g < 1000) {
+            ++short_gaps;
+        } else {
+            ASSERT_GE(g, 1000000);
+            ASSERT_LE(g, 2000000);
+        }
+    }
+    EXPECT_NEAR(static_cast<double>(short_gaps) / 40000.0, 0.75, 0.02);
+}
+
+TEST(ArrivalProcessTest, test_empirical_arrivals_rejects_bad_histogram) {
+    EXPECT_THROW(EmpiricalArrivals({}, 1), std::invalid_argument);
+    EXPECT_THROW(EmpiricalArrivals({{nanoseconds(10), 1.0}, {nanoseconds(5), 1.0}}, 1),
+                 std::invalid_argument);
+    EXPECT_THROW(EmpiricalArrivals({{nanoseconds(10), 0.0}}, 1), std::invalid_argument);
+}
+
+TEST(ArrivalProcessTest, test_empirical_histogram_from_journal_buckets_per_stream_gaps) {
+    const std::string path = ::testing::TempDir() + "arrival_histogram.bin";
+    {
+        TokenJournalWriter writer(path);
+        // Stream 0: gaps of 1000 ns; stream 1 interleaved: gaps of 3000 ns.
+        for (uint64_t i = 0; i < 4; ++i) {
+            writer.record(0, "a", 10000 + i * 1000);
+            writer.record(1, "b", 10000 + i * 3000);
+        }
+    }
+    const std::vector<EmpiricalArrivals::Bin> bins = EmpiricalArrivals::histogram_from_journal(path);
+    std::remove(path.c_str());
+
+    // 1000 lies in [512, 1024) -> bin 10; 3000 in [2048, 4096) -> bin 12.
+    ASSERT_EQ(bins.size(), 13u);
+    EXPECT_EQ(bins[10].upper.count(), 1024);
+    EXPECT_DOUBLE_EQ(bins[10].weight, 3.0);
+    EXPECT_DOUBLE_EQ(bins[11].weight, 0.0);
+    EXPECT_DOUBLE_EQ(bins[12].weight, 3.0);
+    EXPECT_NO_THROW(EmpiricalArrivals(bins, 1));
+}
+
+// ---------------------------------------------------------------------------
+// Simulator integration
+// ---------------------------------------------------------------------------
+
+TEST(ArrivalProcessTest, test_simulator_uses_arrival_process_gaps) {
+    TokenStreamSimulator::Config cfg;
+    cfg.token_interval    = std::chrono::microseconds{100};   // ignored once a process is set
+    cfg.buffer_size       = 64;
+    cfg.use_memory_stream = true;
+    TokenStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory({"alpha", "beta"});
+    sim.set_arrival_process(std::make_unique<FixedArrivals>(std::chrono::milliseconds(5)));
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sim.stop();
+
+    // 5 ms gaps over 100 ms: ~20 tokens, far fewer than the 1000 at 100 us.
+    const uint64_t emitted = sim.get_stats().tokens_emitted.load();
+    EXPECT_GE(emitted, 15u);
+    EXPECT_LE(emitted, 22u);
+}
+
+} // namespace
+} // namespace llmquant
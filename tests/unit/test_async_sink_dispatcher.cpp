@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+#include "AsyncSinkDispatcher.h"
+#include "OutputSinkImpl.h"
+#include "TradeSignalEngine.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static TradeSignal numbered_signal(uint64_t n) {
+    TradeSignal s;
+    s.timestamp_ns     = n;
+    s.delta_bias_shift = 0.001 * static_cast<double>(n);
+    return s;
+}
+
+/// Sink that records signals and the thread they arrive on, and can be
+/// stalled or slowed to simulate slow I/O.
+class RecordingSink : public OutputSink {
+public:
+    void emit(const TradeSignal& sig) override {
+        while (stalled.load(std::memory_order_acquire)) std::this_thread::yield();
+        if (delay.count() > 0) std::this_thread::sleep_for(delay);
+        signals.push_back(sig.timestamp_ns);
+        thread = std::this_thread::get_id();
+    }
+    void flush() override { flushes.fetch_add(1); }
+
+    std::atomic<bool>     stalled{false};
+    std::chrono::microseconds delay{0};
+    std::atomic<int>      flushes{0};
+    std::vector<uint64_t> signals;
+    std::thread::id       thread;
+};
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST(AsyncSinkDispatcherTest, test_invalid_construction_throws) {
+    auto sink = std::make_shared<RecordingSink>();
+    EXPECT_THROW(AsyncSinkDispatcher({nullptr}), std::invalid_argument);
+    EXPECT_THROW(AsyncSinkDispatcher({sink}, AsyncSinkDispatcher::Config{.ring_capacity = 0}),
+                 std::invalid_argument);
+    EXPECT_THROW(AsyncSinkDispatcher({sink}, AsyncSinkDispatcher::Config{.batch_size = 0}),
+                 std::invalid_argument);
+    EXPECT_EQ(parse_sink_overflow("block"), AsyncSinkDispatcher::Overflow::Block);
+    EXPECT_THROW(parse_sink_overflow("drop_oldest"), std::invalid_argument);
+}
+
+TEST(AsyncSinkDispatcherTest, test_signals_reach_every_sink_in_order_on_io_thread) {
+    auto a = std::make_shared<RecordingSink>();
+    auto b = std::make_shared<RecordingSink>();
+    AsyncSinkDispatcher dispatcher({a, b}, AsyncSinkDispatcher::Config{
+        .ring_capacity = 64, .batch_size = 16, .overflow = AsyncSinkDispatcher::Overflow::Block});
+
+    for (uint64_t i = 0; i < 1000; ++i) dispatcher.emit(numbered_signal(i));
+    dispatcher.flush();
+
+    for (const auto& sink : {a, b}) {
+        ASSERT_EQ(sink->signals.size(), 1000u);
+        for (uint64_t i = 0; i < 1000; ++i) EXPECT_EQ(sink->signals[i], i);
+        EXPECT_NE(sink->thread, std::this_thread::get_id());
+        EXPECT_GE(sink->flushes.load(), 1);
+    }
+    const AsyncSinkDispatcher::SinkStats s = dispatcher.stats(1);
+    EXPECT_EQ(s.enqueued, 1000u);
+    EXPECT_EQ(s.written, 1000u);
+    EXPECT_EQ(s.dropped, 0u);
+    EXPECT_EQ(s.lag, 0u);
+    EXPECT_GE(s.max_lag, 1u);
+    EXPECT_THROW(dispatcher.stats(2), std::out_of_range);
+}
+
+TEST(AsyncSinkDispatcherTest, test_drop_policy_never_waits_for_a_slow_sink) {
+    auto fast = std::make_shared<RecordingSink>();
+    auto slow = std::make_shared<RecordingSink>();
+    slow->delay = std::chrono::microseconds(500);
+    AsyncSinkDispatcher dispatcher({fast, slow}, AsyncSinkDispatcher::Config{
+        .ring_capacity = 16, .batch_size = 4, .overflow = AsyncSinkDispatcher::Overflow::Drop});
+
+    // 200 signals would take the slow sink >= 100 ms; emitting must not.
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < 200; ++i) dispatcher.emit(numbered_signal(i));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(50));
+
+    const AsyncSinkDispatcher::SinkStats slow_stats = dispatcher.stats(1);
+    EXPECT_GT(slow_stats.dropped, 0u);
+    EXPECT_EQ(slow_stats.enqueued + slow_stats.dropped, 200u);
+    EXPECT_LE(slow_stats.max_lag, 16u);
+
+    dispatcher.close();
+    // Everything accepted is written; drops are accounted per sink.
+    for (size_t i = 0; i < 2; ++i) {
+        const AsyncSinkDispatcher::SinkStats s = dispatcher.stats(i);
+        EXPECT_EQ(s.written, s.enqueued);
+        EXPECT_EQ(s.enqueued + s.dropped, 200u);
+        EXPECT_EQ(s.lag, 0u);
+    }
+    EXPECT_EQ(slow->signals.size(), slow_stats.enqueued);
+}
+
+TEST(AsyncSinkDispatcherTest, test_block_policy_waits_for_a_slow_sink_and_loses_nothing) {
+    auto slow = std::make_shared<RecordingSink>();
+    slow->stalled = true;
+    AsyncSinkDispatcher dispatcher({slow}, AsyncSinkDispatcher::Config{
+        .ring_capacity = 8, .batch_size = 4, .overflow = AsyncSinkDispatcher::Overflow::Block});
+
+    std::atomic<uint64_t> emitted{0};
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < 100; ++i) {
+            dispatcher.emit(numbered_signal(i));
+            emitted.fetch_add(1);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_LE(emitted.load(), 9u);   // ring (8) plus the batch the I/O thread holds is the limit
+    slow->stalled = false;
+    producer.join();
+    dispatcher.close();
+
+    ASSERT_EQ(slow->signals.size(), 100u);
+    EXPECT_EQ(dispatcher.stats(0).dropped, 0u);
+}
+
+TEST(AsyncSinkDispatcherTest, test_engine_signals_reach_csv_file_via_dispatcher) {
+    const std::string path = "test_async_sink.csv";
+    {
+        TradeSignalEngine engine(TradeSignalEngine::Config{});
+        engine.set_backtest_mode(true);
+        engine.set_signal_callback([](const TradeSignal&) {});
+        auto dispatcher = std::make_shared<AsyncSinkDispatcher>(
+            std::vector<std::shared_ptr<OutputSink>>{std::make_shared<CsvOutputSink>(path)});
+        engine.add_output_sink(dispatcher);
+
+        for (int i = 0; i < 50; ++i) engine.process_semantic_weight(SemanticWeight{0.3, 0.8, 0.1, 0.3});
+        dispatcher->flush();
+
+        std::ifstream in(path);
+        int lines = 0;
+        for (std::string line; std::getline(in, line);) ++lines;
+        EXPECT_EQ(lines, 51);   // header + one row per signal
+    }
+    std::remove(path.c_str());
+}
+
+TEST(AsyncSinkDispatcherTest, test_emit_after_close_is_counted_as_dropped) {
+    auto sink = std::make_shared<RecordingSink>();
+    AsyncSinkDispatcher dispatcher({sink});
+    dispatcher.emit(numbered_signal(1));
+    dispatcher.close();
+    dispatcher.close();   // idempotent
+    dispatcher.emit(numbered_signal(2));
+    dispatcher.flush();   // returns immediately once closed
+
+    EXPECT_EQ(sink->signals.size(), 1u);
+    EXPECT_EQ(dispatcher.stats(0).dropped, 1u);
+}
+
+} // namespace
+} // namespace llmquant
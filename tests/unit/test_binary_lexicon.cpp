@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include "LexiconFile.h"
+#include "LLMAdapter.h"
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static void write_file(const std::string& path, const std::string& content) {
+    std::ofstream f(path, std::ios::binary);
+    f << content;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+}
+
+static DictionaryEntries make_entries(size_t n) {
+    DictionaryEntries entries;
+    for (size_t i = 0; i < n; ++i) {
+        double x = static_cast<double>(i) / static_cast<double>(n);
+        entries.tokens["tok" + std::to_string(i)] = SemanticWeight{x, 0.5, x / 2.0, -x};
+    }
+    entries.tokens[std::string(CompiledLexicon::kInlineKeyBytes + 8, 'q')] =
+        SemanticWeight{0.25, 0.5, 0.75, 1.0};
+    entries.phrases.push_back({{"rate", "cut"}, SemanticWeight{0.5, 0.9, 0.3, 0.6}});
+    return entries;
+}
+
+// ---------------------------------------------------------------------------
+// MappedFile
+// ---------------------------------------------------------------------------
+
+TEST(BinaryLexiconTest, test_mapped_file_exposes_contents) {
+    const std::string path = "/tmp/llmquant_test_mapped_file.bin";
+    write_file(path, "hello mapped world");
+    {
+        MappedFile f(path);
+        EXPECT_EQ(f.view(), "hello mapped world");
+    }
+    write_file(path, "");
+    {
+        MappedFile f(path);
+        EXPECT_EQ(f.size(), 0u);
+        EXPECT_EQ(f.data(), nullptr);
+    }
+    std::remove(path.c_str());
+    EXPECT_THROW(MappedFile("/tmp/llmquant_no_such_file.bin"), std::runtime_error);
+}
+
+// ---------------------------------------------------------------------------
+// Round trip
+// ---------------------------------------------------------------------------
+
+TEST(BinaryLexiconTest, test_binary_lexicon_roundtrip) {
+    const std::string path = "/tmp/llmquant_test_roundtrip.lexb";
+    const DictionaryEntries entries = make_entries(5000);
+    write_binary_lexicon(path, entries);
+    ASSERT_TRUE(is_binary_lexicon(path));
+
+    const BinaryLexicon lex = open_binary_lexicon(path);
+    ASSERT_EQ(lex.tokens.size(), entries.tokens.size());
+    for (const auto& [key, weight] : entries.tokens) {
+        const SemanticWeight* w = lex.tokens.find(key);
+        ASSERT_NE(w, nullptr) << key;
+        EXPECT_DOUBLE_EQ(w->sentiment_score, weight.sentiment_score) << key;
+        EXPECT_DOUBLE_EQ(w->directional_bias, weight.directional_bias) << key;
+    }
+    EXPECT_EQ(lex.tokens.find("tok5000"), nullptr);
+
+    ASSERT_EQ(lex.phrases.size(), 1u);
+    EXPECT_EQ(lex.phrases[0].first, (std::vector<std::string>{"rate", "cut"}));
+    EXPECT_DOUBLE_EQ(lex.phrases[0].second.directional_bias, 0.6);
+    std::remove(path.c_str());
+}
+
+TEST(BinaryLexiconTest, test_binary_lexicon_outlives_file_removal) {
+    const std::string path = "/tmp/llmquant_test_unlinked.lexb";
+    write_binary_lexicon(path, make_entries(100));
+    const BinaryLexicon lex = open_binary_lexicon(path);
+    std::remove(path.c_str());
+    ASSERT_NE(lex.tokens.find("tok42"), nullptr);
+}
+
+TEST(BinaryLexiconTest, test_empty_dictionary_roundtrip) {
+    const std::string path = "/tmp/llmquant_test_empty.lexb";
+    write_binary_lexicon(path, DictionaryEntries{});
+    const BinaryLexicon lex = open_binary_lexicon(path);
+    EXPECT_TRUE(lex.tokens.empty());
+    EXPECT_TRUE(lex.phrases.empty());
+    EXPECT_EQ(lex.tokens.find("crash"), nullptr);
+    std::remove(path.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Rejection
+// ---------------------------------------------------------------------------
+
+TEST(BinaryLexiconTest, test_text_file_is_not_binary) {
+    const std::string path = "/tmp/llmquant_test_not_binary.txt";
+    write_file(path, "moonshot 0.9 0.9 0.5 0.9\n");
+    EXPECT_FALSE(is_binary_lexicon(path));
+    EXPECT_THROW(open_binary_lexicon(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_FALSE(is_binary_lexicon(path));
+}
+
+TEST(BinaryLexiconTest, test_stale_version_rejected) {
+    const std::string path = "/tmp/llmquant_test_stale.lexb";
+    write_binary_lexicon(path, make_entries(100));
+    std::string bytes = read_file(path);
+    bytes[8] = static_cast<char>(kBinaryLexiconVersion + 1);   // version field
+    write_file(path, bytes);
+    EXPECT_THROW(open_binary_lexicon(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(BinaryLexiconTest, test_corrupt_payload_rejected) {
+    const std::string path = "/tmp/llmquant_test_corrupt.lexb";
+    write_binary_lexicon(path, make_entries(100));
+    std::string bytes = read_file(path);
+    bytes[bytes.size() / 2] ^= 0x40;
+    write_file(path, bytes);
+    EXPECT_THROW(open_binary_lexicon(path), std::runtime_error);
+
+    write_binary_lexicon(path, make_entries(100));
+    bytes = read_file(path);
+    write_file(path, bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(open_binary_lexicon(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// LLMAdapter integration
+// ---------------------------------------------------------------------------
+
+TEST(BinaryLexiconTest, test_adapter_reload_from_binary_matches_text) {
+    const std::string text_path = "/tmp/llmquant_test_adapter_dict.txt";
+    const std::string bin_path  = "/tmp/llmquant_test_adapter_dict.lexb";
+    write_file(text_path,
+               "moonshot 0.9 0.9 0.5 0.9\n"
+               "crash 0.1 0.2 0.3 0.4\n"
+               "\"rate cut\" 0.5 0.9 0.3 0.6\n");
+    write_binary_lexicon(bin_path, read_text_dictionary(text_path));
+
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter from_text, from_binary;
+    from_text.bind_vocabulary(vocab);
+    from_binary.bind_vocabulary(vocab);
+    from_text.reload_sentiment_dictionary(text_path);
+    from_binary.reload_sentiment_dictionary(bin_path);
+
+    for (const char* tok : {"moonshot", "crash", "bullish", "unknown_token"}) {
+        const SemanticWeight a = from_text.map_token_to_weight(tok);
+        const SemanticWeight b = from_binary.map_token_to_weight(tok);
+        EXPECT_DOUBLE_EQ(a.sentiment_score, b.sentiment_score) << tok;
+        EXPECT_DOUBLE_EQ(a.directional_bias, b.directional_bias) << tok;
+        EXPECT_DOUBLE_EQ(from_binary.map_token_id(vocab->intern(tok)).sentiment_score,
+                         b.sentiment_score) << tok;
+    }
+    // The file overrides the built-in "crash" entry.
+    EXPECT_DOUBLE_EQ(from_binary.map_token_to_weight("crash").sentiment_score, 0.1);
+    EXPECT_EQ(from_binary.phrase_count(), from_text.phrase_count());
+
+    LLMAdapter::StreamState stream;
+    from_binary.map_token_id(vocab->intern("rate"), stream);
+    EXPECT_DOUBLE_EQ(from_binary.map_token_id(vocab->intern("cut"), stream).directional_bias, 0.6);
+
+    std::remove(text_path.c_str());
+    std::remove(bin_path.c_str());
+}
+
+TEST(BinaryLexiconTest, test_adapter_keeps_dictionary_on_rejected_binary) {
+    const std::string path = "/tmp/llmquant_test_adapter_bad.lexb";
+    DictionaryEntries entries;
+    entries.tokens["moonshot"] = SemanticWeight{0.9, 0.9, 0.5, 0.9};
+    write_binary_lexicon(path, entries);
+
+    LLMAdapter adapter;
+    adapter.reload_sentiment_dictionary(path);
+    ASSERT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").sentiment_score, 0.9);
+
+    std::string bytes = read_file(path);
+    bytes.back() ^= 0x01;
+    write_file(path, bytes);
+    EXPECT_THROW(adapter.reload_sentiment_dictionary(path), std::runtime_error);
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").sentiment_score, 0.9);
+    std::remove(path.c_str());
+}
+
+} // namespace
+} // namespace llmquant
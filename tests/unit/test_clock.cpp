@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+#include "Clock.h"
+#include "Deduplicator.h"
+#include "RiskManager.h"
+#include "TradeSignalEngine.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+using namespace std::chrono_literals;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static TradeSignalEngine::Config cooldown_config(std::chrono::microseconds cooldown) {
+    TradeSignalEngine::Config cfg;
+    cfg.signal_cooldown = cooldown;
+    return cfg;
+}
+
+static TradeSignal passing_signal() {
+    TradeSignal s;
+    s.delta_bias_shift = 0.1;
+    s.confidence       = 0.9;
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// ManualClock
+// ---------------------------------------------------------------------------
+
+TEST(ClockTest, test_manual_clock_moves_only_when_told) {
+    ManualClock clock;
+    const auto t0 = clock.now();
+    std::this_thread::sleep_for(2ms);
+    EXPECT_EQ(clock.now(), t0);
+
+    clock.advance(5ms);
+    EXPECT_EQ(clock.now() - t0, 5ms);
+    clock.set_ns(1'000'000'000);
+    EXPECT_EQ(clock.now().time_since_epoch(), 1s);
+
+    clock.advance_to_ns(999'000'000);   // earlier: ignored
+    EXPECT_EQ(clock.now().time_since_epoch(), 1s);
+    clock.advance_to_ns(2'000'000'000);
+    EXPECT_EQ(clock.now().time_since_epoch(), 2s);
+}
+
+TEST(ClockTest, test_system_clock_instance_is_shared_and_advances) {
+    EXPECT_EQ(SystemClock::instance(), SystemClock::instance());
+    const auto a = SystemClock::instance()->now();
+    std::this_thread::sleep_for(1ms);
+    EXPECT_GT(SystemClock::instance()->now(), a);
+}
+
+// ---------------------------------------------------------------------------
+// Components on an injected clock
+// ---------------------------------------------------------------------------
+
+TEST(ClockTest, test_signal_cooldown_follows_injected_clock) {
+    auto clock = std::make_shared<ManualClock>();
+    TradeSignalEngine engine(cooldown_config(1000us), clock);
+    std::vector<TradeSignal> signals;
+    engine.set_signal_callback([&](const TradeSignal& s) { signals.push_back(s); });
+
+    const SemanticWeight w{0.5, 0.9, 0.2, 0.5};
+    engine.process_semantic_weight(w);   // cooldown not yet elapsed since construction
+    EXPECT_TRUE(signals.empty());
+
+    clock->advance(1ms);
+    engine.process_semantic_weight(w);
+    ASSERT_EQ(signals.size(), 1u);
+    EXPECT_EQ(signals[0].timestamp_ns, 1'000'000u);   // stamped with clock time
+
+    // However long the wall clock takes, no time passes on the injected clock.
+    std::this_thread::sleep_for(2ms);
+    engine.process_semantic_weight(w);
+    EXPECT_EQ(signals.size(), 1u);
+    clock->advance(999us);
+    engine.process_semantic_weight(w);
+    EXPECT_EQ(signals.size(), 1u);
+    clock->advance(1us);
+    engine.process_semantic_weight(w);
+    EXPECT_EQ(signals.size(), 2u);
+}
+
+TEST(ClockTest, test_risk_rate_window_follows_injected_clock) {
+    auto clock = std::make_shared<ManualClock>();
+    RiskManager::Config cfg;
+    cfg.max_signals_per_second = 2;
+    RiskManager rm(cfg, clock);
+
+    EXPECT_TRUE(rm.evaluate(passing_signal()));
+    EXPECT_TRUE(rm.evaluate(passing_signal()));
+    EXPECT_FALSE(rm.evaluate(passing_signal()));   // third within the same second
+    clock->advance(999ms);
+    EXPECT_FALSE(rm.evaluate(passing_signal()));
+    clock->advance(1ms);
+    EXPECT_TRUE(rm.evaluate(passing_signal()));    // window rolled over on clock time
+    EXPECT_EQ(rm.get_stats().signals_blocked_rate.load(), 2u);
+}
+
+TEST(ClockTest, test_risk_drawdown_window_follows_injected_clock) {
+    auto clock = std::make_shared<ManualClock>();
+    RiskManager::Config cfg;
+    cfg.max_drawdown    = 0.25;
+    cfg.drawdown_window = 60s;
+    RiskManager rm(cfg, clock);
+
+    EXPECT_TRUE(rm.evaluate(passing_signal()));
+    EXPECT_TRUE(rm.evaluate(passing_signal()));
+    EXPECT_FALSE(rm.evaluate(passing_signal()));   // 0.3 > 0.25
+    clock->advance(60s);
+    EXPECT_TRUE(rm.evaluate(passing_signal()));    // drawdown reset on clock time
+}
+
+TEST(ClockTest, test_dedup_ttl_follows_injected_clock) {
+    auto clock = std::make_shared<ManualClock>(ManualClock::time_point(1s));
+    InProcessDeduplicator dedup(clock);
+
+    EXPECT_EQ(dedup.check_and_register_id(7, "crash", 100ms), DedupResult::Novel);
+    std::this_thread::sleep_for(2ms);
+    EXPECT_EQ(dedup.check_and_register_id(7, "crash", 1ms), DedupResult::Duplicate);
+    clock->advance(100ms);
+    EXPECT_EQ(dedup.check_and_register_id(7, "crash", 100ms), DedupResult::Novel);
+
+    const DedupKey key = DedupKey::from_token("crash");
+    EXPECT_EQ(dedup.check_and_register(key, 10ms), DedupResult::Novel);
+    clock->advance(10ms);
+    dedup.purge_expired();
+    EXPECT_EQ(dedup.size(), 1u);   // only the ID entry (expires at +200 ms) remains
+}
+
+TEST(ClockTest, test_clocked_pipeline_is_bit_identical_across_runs) {
+    // A recorded tape: (receive time in ns, weight).  Gaps straddle the
+    // cooldown and the risk rate window.
+    struct Tick { uint64_t ns; SemanticWeight w; };
+    std::vector<Tick> tape;
+    for (uint64_t i = 0; i < 2000; ++i) {
+        const double sign = (i % 3 == 0) ? -1.0 : 1.0;
+        tape.push_back({i * 370'000 + (i % 7) * 90'000,
+                        SemanticWeight{0.4 * sign, 0.8, 0.1 * static_cast<double>(i % 5), 0.6 * sign}});
+    }
+
+    auto run = [&tape] {
+        auto clock = std::make_shared<ManualClock>();
+        TradeSignalEngine engine(cooldown_config(1000us), clock);
+        RiskManager::Config rcfg;
+        rcfg.max_bias_magnitude       = 10.0;
+        rcfg.max_volatility_magnitude = 10.0;
+        rcfg.max_spread_magnitude     = 10.0;
+        rcfg.max_signals_per_second   = 200;
+        rcfg.max_drawdown             = 40.0;
+        rcfg.drawdown_window          = 1s;
+        RiskManager rm(rcfg, clock);
+
+        std::vector<TradeSignal> passed;
+        engine.set_signal_callback([&](const TradeSignal& s) {
+            if (rm.evaluate(s)) passed.push_back(s);
+        });
+        for (const Tick& t : tape) {
+            clock->advance_to_ns(t.ns);
+            engine.process_semantic_weight(t.w);
+            // Wall time between ticks must not matter.
+            if (t.ns % 11 == 0) std::this_thread::yield();
+        }
+        return passed;
+    };
+
+    const std::vector<TradeSignal> a = run();
+    const std::vector<TradeSignal> b = run();
+    ASSERT_GT(a.size(), 10u);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].timestamp_ns, b[i].timestamp_ns);
+        EXPECT_EQ(a[i].delta_bias_shift, b[i].delta_bias_shift);
+        EXPECT_EQ(a[i].volatility_adjustment, b[i].volatility_adjustment);
+    }
+}
+
+} // namespace
+} // namespace llmquant
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "CompiledLexicon.h"
+#include "LLMAdapter.h"
+
+#include <string>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static TokenWeightMap make_entries(size_t n) {
+    TokenWeightMap entries;
+    for (size_t i = 0; i < n; ++i) {
+        double x = static_cast<double>(i) / static_cast<double>(n);
+        entries["tok" + std::to_string(i)] = SemanticWeight{x, 0.5, x / 2.0, -x};
+    }
+    return entries;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST(CompiledLexiconTest, test_compiled_lexicon_empty_finds_nothing) {
+    CompiledLexicon lex;
+    EXPECT_TRUE(lex.empty());
+    EXPECT_EQ(lex.find("crash"), nullptr);
+    EXPECT_EQ(lex.find(""), nullptr);
+}
+
+TEST(CompiledLexiconTest, test_compiled_lexicon_single_entry_roundtrip) {
+    CompiledLexicon lex({{"crash", SemanticWeight{-0.9, 0.9, 0.8, -0.7}}});
+    ASSERT_EQ(lex.size(), 1u);
+    const SemanticWeight* w = lex.find("crash");
+    ASSERT_NE(w, nullptr);
+    EXPECT_DOUBLE_EQ(w->sentiment_score, -0.9);
+    EXPECT_DOUBLE_EQ(w->directional_bias, -0.7);
+    EXPECT_EQ(lex.find("crash "), nullptr);
+    EXPECT_EQ(lex.find("cras"), nullptr);
+}
+
+TEST(CompiledLexiconTest, test_compiled_lexicon_every_key_resolves_to_its_weight) {
+    auto entries = make_entries(20000);
+    CompiledLexicon lex(entries);
+    ASSERT_EQ(lex.size(), entries.size());
+    for (const auto& [key, weight] : entries) {
+        const SemanticWeight* w = lex.find(key);
+        ASSERT_NE(w, nullptr) << "missing key " << key;
+        EXPECT_DOUBLE_EQ(w->sentiment_score, weight.sentiment_score) << key;
+        EXPECT_DOUBLE_EQ(w->volatility_score, weight.volatility_score) << key;
+    }
+}
+
+TEST(CompiledLexiconTest, test_compiled_lexicon_absent_keys_miss) {
+    CompiledLexicon lex(make_entries(5000));
+    for (size_t i = 5000; i < 10000; ++i) {
+        EXPECT_EQ(lex.find("tok" + std::to_string(i)), nullptr);
+    }
+    EXPECT_EQ(lex.find("bullish"), nullptr);
+}
+
+TEST(CompiledLexiconTest, test_compiled_lexicon_long_keys_use_pool) {
+    const std::string long_a(CompiledLexicon::kInlineKeyBytes + 1, 'a');
+    const std::string long_b = std::string(40, 'b') + "_suffix";
+    CompiledLexicon lex({
+        {long_a, SemanticWeight{0.1, 0.9, 0.0, 0.1}},
+        {long_b, SemanticWeight{0.2, 0.9, 0.0, 0.2}},
+        {"short", SemanticWeight{0.3, 0.9, 0.0, 0.3}},
+    });
+    ASSERT_NE(lex.find(long_a), nullptr);
+    ASSERT_NE(lex.find(long_b), nullptr);
+    EXPECT_DOUBLE_EQ(lex.find(long_a)->directional_bias, 0.1);
+    EXPECT_DOUBLE_EQ(lex.find(long_b)->directional_bias, 0.2);
+    // Same length as long_a, different bytes.
+    EXPECT_EQ(lex.find(std::string(CompiledLexicon::kInlineKeyBytes + 1, 'z')), nullptr);
+}
+
+TEST(CompiledLexiconTest, test_llm_adapter_freeze_preserves_lookups) {
+    LLMAdapter thawed;
+    thawed.add_token_mapping("zz_thaw", SemanticWeight{});
+    ASSERT_FALSE(thawed.is_frozen());
+    LLMAdapter frozen;
+    ASSERT_TRUE(frozen.is_frozen());
+
+    for (const char* tok : {"crash", "Bullish", " rally ", "the", "xyzzy_unknown"}) {
+        SemanticWeight a = thawed.map_token_to_weight(tok);
+        SemanticWeight b = frozen.map_token_to_weight(tok);
+        EXPECT_DOUBLE_EQ(a.sentiment_score,  b.sentiment_score)  << tok;
+        EXPECT_DOUBLE_EQ(a.confidence_score, b.confidence_score) << tok;
+        EXPECT_DOUBLE_EQ(a.volatility_score, b.volatility_score) << tok;
+        EXPECT_DOUBLE_EQ(a.directional_bias, b.directional_bias) << tok;
+    }
+}
+
+TEST(CompiledLexiconTest, test_llm_adapter_mutation_after_freeze_thaws) {
+    LLMAdapter adapter;
+    adapter.freeze();
+    adapter.add_token_mapping("squeeze", SemanticWeight{0.6, 0.8, 0.9, 0.7});
+    EXPECT_FALSE(adapter.is_frozen());
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("squeeze").directional_bias, 0.7);
+
+    adapter.freeze();
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("squeeze").directional_bias, 0.7);
+}
+
+} // namespace
+} // namespace llmquant
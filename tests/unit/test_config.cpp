@@ -26,6 +26,8 @@ trading:
   volatility_sensitivity: 1.5
   signal_decay_rate: 0.80
   signal_cooldown_us: 500
+  decay_time_constant_us: 250000
+  ewma_fast_ms: 20
 latency:
   target_latency_us: 8
   sample_window: 500
@@ -59,6 +61,9 @@ TEST(ConfigTest, test_config_load_from_yaml_string_valid_yaml_parses_all_fields)
     EXPECT_DOUBLE_EQ(sc.trading.volatility_sensitivity, 1.5);
     EXPECT_DOUBLE_EQ(sc.trading.signal_decay_rate,      0.80);
     EXPECT_EQ(sc.trading.signal_cooldown_us,            500);
+    EXPECT_EQ(sc.trading.decay_time_constant_us,        250000);
+    EXPECT_EQ(sc.trading.ewma_fast_ms,                  20);
+    EXPECT_EQ(sc.trading.ewma_slow_ms,                  10000);   // default kept
 
     // latency
     EXPECT_EQ(sc.latency.target_latency_us, 8);
@@ -185,7 +185,8 @@ TEST(Invariants, test_invariant_risk_manager_passed_plus_blocked_equals_total) {
         st.signals_blocked_confidence.load() +
         st.signals_blocked_rate.load()      +
         st.signals_blocked_drawdown.load()  +
-        st.signals_blocked_position.load();
+        st.signals_blocked_position.load()  +
+        st.signals_blocked_symbol.load();
 
     EXPECT_EQ(total_accounted, total_calls)
         << "passed + all blocked counters must equal total calls to evaluate()";
@@ -109,7 +109,7 @@ TEST(LatencyControllerTest, test_latency_controller_start_end_measurement_record
     lc.start_measurement();
     // Spin briefly so the timer has something to measure.
     volatile int sink = 0;
-    for (int i = 0; i < 10000; ++i) { sink += i; }
+    for (int i = 0; i < 10000; ++i) { sink = sink + i; }
     (void)sink;
     lc.end_measurement();
 
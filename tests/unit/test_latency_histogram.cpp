@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include "LatencyHistogram.h"
+#include "TokenStreamSimulator.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+using namespace std::chrono_literals;
+
+// ---------------------------------------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------------------------------------
+
+TEST(LatencyHistogramTest, test_latency_histogram_buckets_are_contiguous) {
+    // Every bucket's upper edge is one below the next bucket's first value.
+    for (size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+        const uint64_t upper = LatencyHistogram::bucket_upper(i);
+        ASSERT_EQ(LatencyHistogram::bucket_of(upper), i);
+        ASSERT_EQ(LatencyHistogram::bucket_of(upper + 1), i + 1);
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_of(std::numeric_limits<uint64_t>::max()),
+              LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, test_latency_histogram_percentiles_within_bucket_error) {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100000; ++v) h.record(v);
+
+    EXPECT_EQ(h.count(), 100000u);
+    EXPECT_EQ(h.max(), 100000u);
+    const LatencyHistogram::Summary s = h.summary();
+    const auto near = [](uint64_t got, double want) {
+        return static_cast<double>(got) >= want && static_cast<double>(got) <= want * 1.04;
+    };
+    EXPECT_TRUE(near(s.p50_ns, 50000.0)) << s.p50_ns;
+    EXPECT_TRUE(near(s.p99_ns, 99000.0)) << s.p99_ns;
+    EXPECT_TRUE(near(s.p999_ns, 99900.0)) << s.p999_ns;
+    EXPECT_EQ(s.max_ns, 100000u);
+    EXPECT_EQ(h.percentile(0.5), s.p50_ns);
+    EXPECT_EQ(h.percentile(1.0), 100000u);
+}
+
+TEST(LatencyHistogramTest, test_latency_histogram_small_values_exact_and_reset) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.99), 0u);   // empty
+
+    h.record(7, 99);
+    h.record(20ns);
+    h.record(-5ns);                      // clock skew clamps to 0
+    EXPECT_EQ(h.count(), 101u);
+    EXPECT_EQ(h.percentile(0.5), 7u);
+    EXPECT_EQ(h.percentile(1.0), 20u);
+
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.max(), 0u);
+}
+
+TEST(LatencyHistogramTest, test_latency_histogram_concurrent_record_loses_nothing) {
+    LatencyHistogram h;
+    constexpr int kThreads = 4;
+    constexpr uint64_t kPerThread = 50000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (uint64_t i = 0; i < kPerThread; ++i) h.record(100 * static_cast<uint64_t>(t + 1) + i % 7);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(h.count(), kThreads * kPerThread);
+    EXPECT_EQ(h.max(), 100u * kThreads + 6);
+}
+
+// ---------------------------------------------------------------------------
+// WindowedRate
+// ---------------------------------------------------------------------------
+
+TEST(WindowedRateTest, test_windowed_rate_averages_completed_slots) {
+    WindowedRate r;
+    const auto t0 = WindowedRate::clock::time_point(std::chrono::hours(1));
+    // 50 events per 100 ms slot for 20 s = 500 events/s.
+    for (int slot = 0; slot < 200; ++slot) r.add(50, t0 + slot * WindowedRate::kSlotWidth);
+    // A partly filled current slot does not count.
+    const auto now = t0 + 200 * WindowedRate::kSlotWidth;
+    r.add(1000, now);
+
+    EXPECT_DOUBLE_EQ(r.rate(1s, now), 500.0);
+    EXPECT_DOUBLE_EQ(r.rate(10s, now), 500.0);
+    // Only 20 s of history: the 60 s window averages in 40 s of silence.
+    EXPECT_NEAR(r.rate(60s, now), 500.0 / 3.0, 1e-9);
+}
+
+TEST(WindowedRateTest, test_windowed_rate_forgets_stale_slots) {
+    WindowedRate r;
+    const auto t0 = WindowedRate::clock::time_point(std::chrono::hours(1));
+    r.add(100, t0);
+    EXPECT_DOUBLE_EQ(r.rate(1s, t0 + 1s), 100.0);
+
+    // 601 slots later the ring reuses t0's slot; its old count must be dropped.
+    const auto wrapped = t0 + 601 * WindowedRate::kSlotWidth;
+    r.add(6, wrapped);
+    const auto now = wrapped + WindowedRate::kSlotWidth;
+    EXPECT_DOUBLE_EQ(r.rate(60s, now), 0.1);
+    EXPECT_DOUBLE_EQ(r.rate(60s, now + 61s), 0.0);
+}
+
+// ---------------------------------------------------------------------------
+// Simulator integration
+// ---------------------------------------------------------------------------
+
+TEST(LatencyHistogramTest, test_simulator_records_callback_latency_per_token) {
+    TokenStreamSimulator::Config cfg;
+    cfg.token_interval = std::chrono::microseconds(100);
+    TokenStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory({"a", "b", "c"});
+    sim.set_token_callback([](const Token&) { std::this_thread::sleep_for(std::chrono::microseconds(200)); });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    sim.stop();
+
+    const auto& stats = sim.get_stats();
+    const LatencyHistogram::Summary s = stats.callback_latency.summary();
+    EXPECT_EQ(s.count, stats.tokens_emitted.load());
+    EXPECT_GE(s.p50_ns, 200000u);        // the callback sleeps at least 200 us
+    EXPECT_GE(s.max_ns, s.p99_ns);
+    EXPECT_GT(stats.emission_rate.rate(std::chrono::milliseconds(200)), 0.0);
+}
+
+} // namespace
+} // namespace llmquant
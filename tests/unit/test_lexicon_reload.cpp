@@ -0,0 +1,258 @@
+#include "gtest/gtest.h"
+#include "Rcu.h"
+#include "LLMAdapter.h"
+#include "Config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static void write_file(const std::string& path, const std::string& content) {
+    std::ofstream f(path);
+    f << content;
+}
+
+// ---------------------------------------------------------------------------
+// RcuPtr / EpochGuard
+// ---------------------------------------------------------------------------
+
+TEST(LexiconReloadTest, test_rcu_store_waits_for_pinned_reader) {
+    RcuPtr<int> ptr(std::make_unique<int>(1));
+    std::atomic<bool> pinned{false}, release{false}, stored{false};
+    std::atomic<int> seen{0};
+
+    std::thread reader([&] {
+        EpochGuard guard;
+        const int* p = ptr.load();
+        pinned = true;
+        while (!release.load()) std::this_thread::yield();
+        seen = *p;   // must still be alive
+    });
+    while (!pinned.load()) std::this_thread::yield();
+
+    std::thread writer([&] {
+        ptr.store(std::make_unique<int>(2));
+        stored = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(stored.load()) << "store() must wait for the pinned reader";
+
+    release = true;
+    reader.join();
+    writer.join();
+    EXPECT_EQ(seen.load(), 1);
+    EXPECT_TRUE(stored.load());
+    EpochGuard guard;
+    EXPECT_EQ(*ptr.load(), 2);
+}
+
+TEST(LexiconReloadTest, test_rcu_guards_nest) {
+    RcuPtr<int> ptr(std::make_unique<int>(1));
+    {
+        EpochGuard outer;
+        { EpochGuard inner; }
+        EXPECT_EQ(*ptr.load(), 1);
+    }
+    // Not pinned any more, so this must not block.
+    ptr.store(std::make_unique<int>(3));
+    EpochGuard guard;
+    EXPECT_EQ(*ptr.load(), 3);
+}
+
+// ---------------------------------------------------------------------------
+// LLMAdapter::reload_sentiment_dictionary
+// ---------------------------------------------------------------------------
+
+TEST(LexiconReloadTest, test_reload_replaces_file_layer_and_keeps_base) {
+    const std::string path = "/tmp/llmquant_test_reload_dict.txt";
+    LLMAdapter adapter;
+    adapter.add_token_mapping("programmatic", {0.1, 0.9, 0.1, 0.3});
+
+    write_file(path, "moonshot 0.9 0.9 0.5 0.9\n");
+    adapter.reload_sentiment_dictionary(path);
+    EXPECT_TRUE(adapter.is_frozen());
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").directional_bias, 0.9);
+
+    write_file(path, "rugpull -0.9 0.9 0.9 -0.9\n");
+    adapter.reload_sentiment_dictionary(path);
+    std::remove(path.c_str());
+
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").directional_bias, 0.0);
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("rugpull").directional_bias, -0.9);
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("programmatic").directional_bias, 0.3);
+    EXPECT_LT(adapter.map_token_to_weight("crash").directional_bias, 0.0);
+}
+
+TEST(LexiconReloadTest, test_reload_missing_file_throws_and_keeps_current) {
+    LLMAdapter adapter;
+    EXPECT_THROW(adapter.reload_sentiment_dictionary("/nonexistent/llmquant_dict.txt"),
+                 std::runtime_error);
+    EXPECT_LT(adapter.map_token_to_weight("crash").directional_bias, 0.0);
+}
+
+TEST(LexiconReloadTest, test_reload_updates_id_weights_and_restarts_phrases) {
+    const std::string path = "/tmp/llmquant_test_reload_phrases.txt";
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    const TokenId rate = vocab->intern("rate");
+    const TokenId cut  = vocab->intern("cut");
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(cut).directional_bias, 0.0);
+
+    LLMAdapter::StreamState stream;
+    adapter.map_token_id(rate, stream);
+
+    write_file(path, "cut -0.2 0.8 0.3 -0.1\n\"rate cut\" 0.5 0.9 0.3 0.6\n");
+    adapter.reload_sentiment_dictionary(path);
+    std::remove(path.c_str());
+
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(cut).directional_bias, -0.1);
+    // The "rate" seen before the swap does not count towards the new phrase.
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(cut, stream).directional_bias, -0.1);
+    adapter.map_token_id(rate, stream);
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(cut, stream).directional_bias, 0.6);
+}
+
+TEST(LexiconReloadTest, test_reload_while_readers_are_streaming) {
+    const std::string path_a = "/tmp/llmquant_test_reload_a.txt";
+    const std::string path_b = "/tmp/llmquant_test_reload_b.txt";
+    write_file(path_a, "flipper 0.5 0.9 0.2 0.5\n");
+    write_file(path_b, "flipper -0.5 0.9 0.2 -0.5\n");
+
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    adapter.reload_sentiment_dictionary(path_a);
+    const TokenId flipper = vocab->intern("flipper");
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> bad{0}, reads{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            LLMAdapter::StreamState stream;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const double by_text = adapter.map_token_to_weight("flipper").directional_bias;
+                const double by_id   = adapter.map_token_id(flipper, stream).directional_bias;
+                if (by_text != 0.5 && by_text != -0.5) bad++;
+                if (by_id   != 0.5 && by_id   != -0.5) bad++;
+                reads++;
+            }
+        });
+    }
+    for (int i = 0; i < 40; ++i) {
+        adapter.reload_sentiment_dictionary(i % 2 ? path_a : path_b);
+    }
+    stop = true;
+    for (auto& th : readers) th.join();
+    std::remove(path_a.c_str());
+    std::remove(path_b.c_str());
+
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(bad.load(), 0u);
+}
+
+// ---------------------------------------------------------------------------
+// Config wiring
+// ---------------------------------------------------------------------------
+
+TEST(LexiconReloadTest, test_config_parses_dictionary_path) {
+    Config cfg;
+    ASSERT_TRUE(cfg.load_from_yaml_string("semantic_weights:\n  dictionary_path: dict.txt\n"));
+    EXPECT_EQ(cfg.get_config().semantic_weights.dictionary_path, "dict.txt");
+}
+
+TEST(LexiconReloadTest, test_config_watcher_reports_dictionary_change) {
+    const std::string cfg_path  = "/tmp/llmquant_test_dict_watch.yaml";
+    const std::string dict_path = "/tmp/llmquant_test_dict_watch.txt";
+    write_file(cfg_path, "semantic_weights:\n  dictionary_path: " + dict_path + "\n");
+    write_file(dict_path, "moonshot 0.9 0.9 0.5 0.9\n");
+
+    Config cfg;
+    ASSERT_TRUE(cfg.load_from_file(cfg_path));
+    LLMAdapter adapter;
+    std::atomic<int> reloads{0};
+    cfg.set_dictionary_callback([&](const std::string& path) {
+        adapter.reload_sentiment_dictionary(path);
+        reloads++;
+    });
+    cfg.start_watching(cfg_path, [](const SystemConfig&) {}, /*poll_interval_ms=*/50);
+
+    // Let the watcher capture the initial mtime, then change the dictionary.
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    write_file(dict_path, "moonshot -0.9 0.9 0.5 -0.9\n");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1500);
+    while (reloads.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    cfg.stop_watching();
+    std::remove(cfg_path.c_str());
+    std::remove(dict_path.c_str());
+
+    ASSERT_GT(reloads.load(), 0);
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").directional_bias, -0.9);
+}
+
+TEST(LexiconReloadTest, test_clear_drops_file_layer_and_keeps_base) {
+    const std::string path = "/tmp/llmquant_test_clear_dict.txt";
+    LLMAdapter adapter;
+    adapter.add_token_mapping("programmatic", {0.1, 0.9, 0.1, 0.3});
+    write_file(path, "moonshot 0.9 0.9 0.5 0.9\n");
+    adapter.reload_sentiment_dictionary(path);
+    std::remove(path.c_str());
+
+    adapter.clear_sentiment_dictionary();
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").directional_bias, 0.0);
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("programmatic").directional_bias, 0.3);
+    EXPECT_LT(adapter.map_token_to_weight("crash").directional_bias, 0.0);
+}
+
+TEST(LexiconReloadTest, test_config_watcher_reports_cleared_dictionary_path) {
+    const std::string cfg_path  = "/tmp/llmquant_test_dict_unset.yaml";
+    const std::string dict_path = "/tmp/llmquant_test_dict_unset.txt";
+    write_file(cfg_path, "semantic_weights:\n  dictionary_path: " + dict_path + "\n");
+    write_file(dict_path, "moonshot 0.9 0.9 0.5 0.9\n");
+
+    Config cfg;
+    ASSERT_TRUE(cfg.load_from_file(cfg_path));
+    LLMAdapter adapter;
+    adapter.reload_sentiment_dictionary(dict_path);
+    std::atomic<bool> cleared{false};
+    cfg.set_dictionary_callback([&](const std::string& path) {
+        if (!path.empty()) return;
+        adapter.clear_sentiment_dictionary();
+        cleared = true;
+    });
+    cfg.start_watching(cfg_path, [](const SystemConfig&) {}, /*poll_interval_ms=*/50);
+
+    // Let the watcher capture the initial mtime, then unset the dictionary.
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    write_file(cfg_path, "semantic_weights:\n  dictionary_path: \"\"\n");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1500);
+    while (!cleared.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    cfg.stop_watching();
+    std::remove(cfg_path.c_str());
+    std::remove(dict_path.c_str());
+
+    ASSERT_TRUE(cleared.load());
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").directional_bias, 0.0);
+}
+
+} // namespace
+} // namespace llmquant
@@ -3,6 +3,7 @@
 
 #include <cmath>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace llmquant {
@@ -85,9 +86,6 @@ TEST(LLMAdapterTest, test_llm_adapter_add_token_mapping_overrides_default) {
 }
 
 TEST(LLMAdapterTest, test_llm_adapter_cache_stats_track_hits_and_misses) {
-    // We cannot inspect private stats_ directly, but we can verify via
-    // observable behaviour: map a known token (hit) and an unknown token
-    // (miss) and confirm the adapter still functions correctly.
     LLMAdapter adapter;
 
     // Known token -> should be found (cache hit)
@@ -98,6 +96,39 @@ TEST(LLMAdapterTest, test_llm_adapter_cache_stats_track_hits_and_misses) {
     SemanticWeight miss = adapter.map_token_to_weight("nonexistent_abc");
     EXPECT_DOUBLE_EQ(miss.directional_bias, 0.0);
     EXPECT_DOUBLE_EQ(miss.confidence_score, 0.5);
+
+#ifndef LLMQUANT_DISABLE_ADAPTER_STATS
+    const LLMAdapter::Stats stats = adapter.get_stats();
+    EXPECT_EQ(stats.tokens_processed, 2u);
+    EXPECT_EQ(stats.cache_hits,       1u);
+    EXPECT_EQ(stats.cache_misses,     1u);
+#endif
+}
+
+TEST(LLMAdapterTest, test_llm_adapter_stats_merge_across_threads) {
+    LLMAdapter adapter;
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kPerThread; ++i) {
+                adapter.map_token_to_weight(i % 2 ? "bullish" : "not_a_token");
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    adapter.map_sequence_simd({"crash", "panic", "zzz"});
+
+#ifndef LLMQUANT_DISABLE_ADAPTER_STATS
+    const LLMAdapter::Stats stats = adapter.get_stats();
+    EXPECT_EQ(stats.tokens_processed, uint64_t{kThreads * kPerThread} + 3);
+    EXPECT_EQ(stats.cache_hits,       uint64_t{kThreads * kPerThread / 2} + 2);
+    EXPECT_EQ(stats.cache_misses,     uint64_t{kThreads * kPerThread / 2} + 1);
+#else
+    EXPECT_EQ(adapter.get_stats().tokens_processed, 0u);
+#endif
 }
 
 TEST(LLMAdapterTest, test_llm_adapter_simd_empty_returns_zero) {
@@ -1,9 +1,22 @@
 #include "gtest/gtest.h"
 #include "LLMStreamClient.h"
+#include "TokenJournal.h"
 
 #include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#  include <arpa/inet.h>
+#  include <netinet/in.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
 
 using namespace llmquant;
 
@@ -19,6 +32,74 @@ static LLMStreamClient::Config refused_config() {
     return cfg;
 }
 
+#ifndef _WIN32
+// ---------------------------------------------------------------------------
+// Helper: loopback server that answers one request with a canned SSE body,
+// written in a single send() so the client sees it in one read.
+// ---------------------------------------------------------------------------
+class OneShotSseServer {
+public:
+    explicit OneShotSseServer(std::string body) : body_(std::move(body)) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port        = 0;
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 1);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~OneShotSseServer() {
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        if (thread_.joinable()) thread_.join();
+    }
+
+    uint16_t port() const { return port_; }
+
+private:
+    void serve() {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) return;
+        std::string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            request.append(buf, static_cast<size_t>(n));
+        }
+        const std::string response =
+            "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n\r\n" + body_;
+        ::send(fd, response.data(), response.size(), 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ::close(fd);
+    }
+
+    std::string body_;
+    int         listen_fd_{-1};
+    uint16_t    port_{0};
+    std::thread thread_;
+};
+
+static std::string sse_delta(const std::string& content) {
+    return "data: {\"choices\":[{\"delta\":{\"content\":\"" + content + "\"}}]}\n\n";
+}
+
+static LLMStreamClient::Config loopback_config(uint16_t port) {
+    LLMStreamClient::Config cfg;
+    cfg.host          = "127.0.0.1";
+    cfg.port          = port;
+    cfg.use_tls       = false;
+    cfg.api_key       = "test-key";
+    cfg.loop_interval = std::chrono::seconds(60);   // one request per test
+    return cfg;
+}
+#endif
+
 // ---------------------------------------------------------------------------
 // Tests
 // ---------------------------------------------------------------------------
@@ -73,3 +154,69 @@ TEST(LLMStreamClientTest, test_stream_client_done_callback_fires_on_failed_conne
     // never set up — that outcome is also acceptable.
     SUCCEED();
 }
+
+#ifndef _WIN32
+TEST(LLMStreamClientTest, test_stream_client_batch_callback_delivers_one_read_per_call) {
+    OneShotSseServer server(sse_delta("Bullish") + sse_delta(" breakout") + "data: [DONE]\n\n");
+
+    std::mutex mu;
+    std::vector<std::vector<std::string>> batches;
+    std::vector<uint64_t> stamps;
+    std::atomic<bool> single_fired{false};
+
+    LLMStreamClient client(loopback_config(server.port()));
+    client.set_token_callback([&](const std::string&) { single_fired = true; });
+    client.set_batch_callback([&](std::span<const LLMStreamClient::ReceivedToken> tokens) {
+        std::lock_guard<std::mutex> lk(mu);
+        batches.emplace_back();
+        for (const auto& t : tokens) {
+            batches.back().emplace_back(t.text);
+            stamps.push_back(t.receive_ns);
+        }
+    });
+    const uint64_t before = monotonic_ns();
+    ASSERT_TRUE(client.connect());
+    for (int i = 0; i < 100; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lk(mu);
+        if (!batches.empty()) break;
+    }
+    client.stop();
+
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0], (std::vector<std::string>{"Bullish", " breakout"}));
+    ASSERT_EQ(stamps.size(), 2u);
+    EXPECT_GE(stamps[0], before);
+    EXPECT_FALSE(single_fired.load());   // the batch callback replaces it
+}
+
+TEST(LLMStreamClientTest, test_stream_client_journal_records_received_tokens) {
+    OneShotSseServer server(sse_delta("crash") + sse_delta("rally") + "data: [DONE]\n\n");
+    const std::string path = ::testing::TempDir() + "stream_client_journal.bin";
+
+    std::atomic<int> tokens{0};
+    {
+        auto journal = std::make_shared<TokenJournalWriter>(path);
+        LLMStreamClient client(loopback_config(server.port()));
+        client.set_journal(journal, 5);
+        client.set_token_callback([&](const std::string&) { ++tokens; });
+        ASSERT_TRUE(client.connect());
+        for (int i = 0; i < 100 && tokens.load() < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        client.stop();
+    }
+
+    TokenJournalReader reader(path);
+    JournalRecord rec;
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, "crash");
+    EXPECT_EQ(rec.stream_id, 5u);
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, "rally");
+    EXPECT_EQ(rec.sequence, 1u);
+    EXPECT_FALSE(reader.next(rec));
+    std::remove(path.c_str());
+}
+#endif
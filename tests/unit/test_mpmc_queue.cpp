@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+#include "MpmcQueue.h"
+#include "TokenStreamSimulator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Single-threaded semantics
+// ---------------------------------------------------------------------------
+
+TEST(MpmcQueueTest, test_mpmc_queue_fifo_and_capacity_rounding) {
+    MpmcQueue<int> q(5);
+    EXPECT_EQ(q.capacity(), 8u);
+    int out = 0;
+    EXPECT_FALSE(q.try_pop(out));
+
+    for (int i = 0; i < 8; ++i) EXPECT_TRUE(q.try_push(i));
+    EXPECT_FALSE(q.try_push(99));                 // full; try_push never counts
+    EXPECT_EQ(q.dropped(), 0u);
+    EXPECT_EQ(q.size_approx(), 8u);
+
+    std::array<int, 5> batch{};
+    EXPECT_EQ(q.pop_batch(batch), 5u);
+    EXPECT_EQ(batch, (std::array<int, 5>{0, 1, 2, 3, 4}));
+    // Wrap around the ring.
+    for (int i = 8; i < 13; ++i) EXPECT_TRUE(q.try_push(i));
+    for (int want = 5; want < 13; ++want) {
+        ASSERT_TRUE(q.try_pop(out));
+        EXPECT_EQ(out, want);
+    }
+    EXPECT_FALSE(q.try_pop(out));
+
+    EXPECT_THROW(MpmcQueue<int>(0), std::invalid_argument);
+}
+
+TEST(MpmcQueueTest, test_mpmc_queue_drop_newest_keeps_oldest) {
+    MpmcQueue<int> q(4, OverflowPolicy::DropNewest);
+    for (int i = 0; i < 10; ++i) q.push(i);
+    EXPECT_EQ(q.dropped_newest(), 6u);
+    EXPECT_EQ(q.dropped_oldest(), 0u);
+    int out = 0;
+    for (int want = 0; want < 4; ++want) {
+        ASSERT_TRUE(q.try_pop(out));
+        EXPECT_EQ(out, want);
+    }
+}
+
+TEST(MpmcQueueTest, test_mpmc_queue_drop_oldest_keeps_newest) {
+    MpmcQueue<int> q(4, OverflowPolicy::DropOldest);
+    for (int i = 0; i < 10; ++i) EXPECT_TRUE(q.push(i));
+    EXPECT_EQ(q.dropped_oldest(), 6u);
+    EXPECT_EQ(q.dropped_newest(), 0u);
+    int out = 0;
+    for (int want = 6; want < 10; ++want) {
+        ASSERT_TRUE(q.try_pop(out));
+        EXPECT_EQ(out, want);
+    }
+}
+
+TEST(MpmcQueueTest, test_mpmc_queue_block_waits_for_room_and_close_releases) {
+    MpmcQueue<int> q(2, OverflowPolicy::Block);
+    ASSERT_TRUE(q.push(1));
+    ASSERT_TRUE(q.push(2));
+
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] { pushed = q.push(3); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed.load());                  // still waiting for room
+    int out = 0;
+    ASSERT_TRUE(q.try_pop(out));
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(q.dropped(), 0u);
+
+    // A producer blocked on a full queue returns false once it is closed.
+    std::atomic<int> result{-1};
+    std::thread blocked([&] { result = q.push(4) ? 1 : 0; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.close();
+    blocked.join();
+    EXPECT_EQ(result.load(), 0);
+    EXPECT_FALSE(q.push(5));
+    ASSERT_TRUE(q.try_pop(out));                  // queued items still drain
+    EXPECT_EQ(out, 2);
+}
+
+TEST(MpmcQueueTest, test_mpmc_queue_parse_overflow_policy) {
+    EXPECT_EQ(parse_overflow_policy("block"), OverflowPolicy::Block);
+    EXPECT_EQ(parse_overflow_policy("drop_oldest"), OverflowPolicy::DropOldest);
+    EXPECT_EQ(parse_overflow_policy("drop_newest"), OverflowPolicy::DropNewest);
+    EXPECT_THROW(parse_overflow_policy("lossy"), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Concurrency
+// ---------------------------------------------------------------------------
+
+TEST(MpmcQueueTest, test_mpmc_queue_many_producers_one_consumer_lossless) {
+    constexpr uint32_t kProducers = 4;
+    constexpr uint64_t kPerProducer = 20000;
+    MpmcQueue<Token> q(64, OverflowPolicy::Block);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                Token tok("t", i, 0);
+                tok.stream_id = p;
+                ASSERT_TRUE(q.push(tok));
+            }
+        });
+    }
+
+    // Per-producer order must survive the merge.
+    std::vector<uint64_t> next(kProducers, 0);
+    uint64_t received = 0;
+    Token tok;
+    while (received < kProducers * kPerProducer) {
+        if (!q.try_pop(tok)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_LT(tok.stream_id, kProducers);
+        EXPECT_EQ(tok.sequence_id, next[tok.stream_id]);
+        next[tok.stream_id] = tok.sequence_id + 1;
+        ++received;
+    }
+    for (auto& t : producers) t.join();
+    EXPECT_FALSE(q.try_pop(tok));
+    EXPECT_EQ(q.dropped(), 0u);
+}
+
+TEST(MpmcQueueTest, test_mpmc_queue_drop_policies_account_for_every_push) {
+    for (OverflowPolicy policy : {OverflowPolicy::DropNewest, OverflowPolicy::DropOldest}) {
+        constexpr uint32_t kProducers = 3;
+        constexpr uint64_t kPerProducer = 20000;
+        MpmcQueue<uint64_t> q(16, policy);
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> popped{0};
+
+        std::thread consumer([&] {
+            uint64_t v = 0;
+            while (!done.load() || q.size_approx() > 0) {
+                if (q.try_pop(v)) {
+                    popped.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        std::vector<std::thread> producers;
+        for (uint32_t p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&] {
+                for (uint64_t i = 0; i < kPerProducer; ++i) q.push(i);
+            });
+        }
+        for (auto& t : producers) t.join();
+        done = true;
+        consumer.join();
+
+        EXPECT_EQ(popped.load() + q.dropped(), kProducers * kPerProducer)
+            << "policy " << static_cast<int>(policy);
+    }
+}
+
+} // namespace
+} // namespace llmquant
@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+#include "MultiStreamSimulator.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<std::string> numbered_corpus(size_t n) {
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < n; ++i) tokens.push_back("tok" + std::to_string(i));
+    return tokens;
+}
+
+/// Emissions recorded per stream, in order.
+struct Recorder {
+    std::mutex mu;
+    std::vector<std::vector<std::string>> text;
+    std::vector<std::vector<uint64_t>> sequence;
+
+    explicit Recorder(size_t streams) : text(streams), sequence(streams) {}
+
+    void operator()(const Token& tok) {
+        std::lock_guard<std::mutex> lk(mu);
+        text.at(tok.stream_id).emplace_back(tok.text);
+        sequence.at(tok.stream_id).push_back(tok.sequence_id);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST(MultiStreamSimulatorTest, test_multi_stream_streams_start_at_corpus_offsets) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count   = 4;
+    cfg.worker_count   = 2;
+    cfg.token_interval = std::chrono::microseconds{200};
+    MultiStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory(numbered_corpus(100));
+
+    Recorder rec(4);
+    sim.set_token_callback([&](const Token& tok) { rec(tok); });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    sim.stop();
+
+    for (uint32_t id = 0; id < 4; ++id) {
+        ASSERT_GE(rec.text[id].size(), 3u) << "stream " << id;
+        const size_t offset = id * 25;
+        for (size_t k = 0; k < rec.text[id].size(); ++k) {
+            EXPECT_EQ(rec.text[id][k], "tok" + std::to_string((offset + k) % 100));
+            EXPECT_EQ(rec.sequence[id][k], k);   // per-stream, gap-free sequence
+        }
+    }
+}
+
+TEST(MultiStreamSimulatorTest, test_multi_stream_stats_match_callback_counts) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count   = 6;
+    cfg.worker_count   = 3;
+    cfg.token_interval = std::chrono::nanoseconds{0};   // flat out
+    MultiStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory(numbered_corpus(10));
+
+    std::atomic<uint64_t> calls{0};
+    sim.set_token_callback([&](const Token& tok) {
+        EXPECT_EQ(sim.vocabulary()->text(tok.token_id), tok.text);
+        calls.fetch_add(1, std::memory_order_relaxed);
+    });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    sim.stop();
+
+    const MultiStreamSimulator::Stats stats = sim.get_stats();
+    EXPECT_EQ(stats.tokens_emitted, calls.load());
+    ASSERT_EQ(stats.per_stream.size(), 6u);
+    for (uint64_t n : stats.per_stream) EXPECT_GT(n, 0u);
+    EXPECT_GT(stats.achieved_rate_tps, 0.0);
+    EXPECT_EQ(sim.worker_count(), 3u);
+}
+
+TEST(MultiStreamSimulatorTest, test_multi_stream_interval_paces_each_stream) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count   = 4;
+    cfg.worker_count   = 1;   // one worker interleaves all four schedules
+    cfg.token_interval = std::chrono::milliseconds{2};
+    MultiStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory({"a", "b"});
+    const auto started = std::chrono::steady_clock::now();
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sim.stop();
+    const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    const uint64_t scheduled = static_cast<uint64_t>(elapsed_ms) / 2 + 1;
+    for (uint64_t n : sim.get_stats().per_stream) {
+        EXPECT_GE(n, scheduled * 8 / 10);
+        EXPECT_LE(n, scheduled);
+    }
+}
+
+TEST(MultiStreamSimulatorTest, test_multi_stream_arrival_factory_is_per_stream) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count = 2;
+    cfg.worker_count = 2;
+    MultiStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory({"a"});
+    std::vector<uint32_t> created;
+    sim.set_arrival_factory([&](uint32_t id) -> std::unique_ptr<ArrivalProcess> {
+        created.push_back(id);
+        // Stream 1 runs five times faster than stream 0.
+        return std::make_unique<FixedArrivals>(id == 0 ? std::chrono::milliseconds(5)
+                                                       : std::chrono::milliseconds(1));
+    });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sim.stop();
+
+    EXPECT_EQ(created, (std::vector<uint32_t>{0, 1}));
+    const MultiStreamSimulator::Stats stats = sim.get_stats();
+    EXPECT_GT(stats.per_stream[1], 3 * stats.per_stream[0]);
+}
+
+TEST(MultiStreamSimulatorTest, test_multi_stream_rejects_bad_usage) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count = 0;
+    EXPECT_THROW(MultiStreamSimulator{cfg}, std::invalid_argument);
+
+    cfg.stream_count = 2;
+    cfg.worker_count = 8;
+    MultiStreamSimulator sim(cfg);
+    EXPECT_EQ(sim.worker_count(), 2u);   // never more workers than streams
+    sim.load_tokens_from_memory({"a"});
+    sim.start();
+    EXPECT_THROW(sim.load_tokens_from_memory({"b"}), std::runtime_error);
+    sim.stop();
+    EXPECT_NO_THROW(sim.load_tokens_from_memory({"b"}));
+    EXPECT_THROW(sim.load_tokens_from_file("/nonexistent/tokens.txt"), std::runtime_error);
+}
+
+TEST(MultiStreamSimulatorTest, test_multi_stream_empty_corpus_idles) {
+    MultiStreamSimulator::Config cfg;
+    cfg.stream_count = 3;
+    MultiStreamSimulator sim(cfg);
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    sim.stop();
+    EXPECT_EQ(sim.get_stats().tokens_emitted, 0u);
+}
+
+} // namespace
+} // namespace llmquant
@@ -0,0 +1,212 @@
+#include "gtest/gtest.h"
+#include "Clock.h"
+#include "MultiSymbolSignalEngine.h"
+#include "OutputSinkImpl.h"
+#include "RiskManager.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+using namespace std::chrono_literals;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static MultiSymbolSignalEngine::Config make_config(size_t shards) {
+    MultiSymbolSignalEngine::Config cfg;
+    cfg.shard_count = shards;
+    return cfg;
+}
+
+// ---------------------------------------------------------------------------
+// SymbolTable
+// ---------------------------------------------------------------------------
+
+TEST(SymbolTableTest, test_symbol_table_assigns_dense_case_insensitive_ids) {
+    SymbolTable table;
+    EXPECT_EQ(table.size(), 1u);   // kMarketSymbol
+    EXPECT_EQ(table.name(kMarketSymbol), "");
+
+    const SymbolId nvda = table.add("NVDA");
+    const SymbolId tsla = table.add("tsla");
+    EXPECT_EQ(nvda, 1u);
+    EXPECT_EQ(tsla, 2u);
+    EXPECT_EQ(table.add("nvda"), nvda);
+    EXPECT_EQ(table.find("Tsla"), tsla);
+    EXPECT_EQ(table.find("AAPL"), kInvalidSymbolId);
+    EXPECT_EQ(table.name(tsla), "TSLA");
+    EXPECT_EQ(table.size(), 3u);
+    EXPECT_THROW(table.add(""), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// MultiSymbolSignalEngine
+// ---------------------------------------------------------------------------
+
+TEST(MultiSymbolSignalEngineTest, test_invalid_construction_and_symbol_throw) {
+    EXPECT_THROW(MultiSymbolSignalEngine(make_config(0), 4), std::invalid_argument);
+    EXPECT_THROW(MultiSymbolSignalEngine(make_config(1), 0), std::invalid_argument);
+
+    MultiSymbolSignalEngine engine(make_config(2), 4);
+    EXPECT_THROW(engine.process_semantic_weight(4, SemanticWeight{}), std::out_of_range);
+}
+
+TEST(MultiSymbolSignalEngineTest, test_symbols_accumulate_independently) {
+    SymbolTable table;
+    const SymbolId nvda = table.add("NVDA");
+    const SymbolId tsla = table.add("TSLA");
+
+    MultiSymbolSignalEngine engine(make_config(2), table.size());
+    engine.set_backtest_mode(true);
+    std::vector<TradeSignal> signals;
+    engine.set_signal_callback([&](const TradeSignal& s) { signals.push_back(s); });
+
+    engine.process_semantic_weight(nvda, SemanticWeight{0.6, 0.9, 0.1, 0.6});
+    for (int i = 0; i < 5; ++i) engine.process_semantic_weight(tsla, SemanticWeight{-0.7, 0.9, 0.4, -0.7});
+
+    // Bearish TSLA news leaves NVDA's accumulator where it was.
+    EXPECT_DOUBLE_EQ(engine.bias(nvda), 0.6 * 0.9);
+    EXPECT_LT(engine.bias(tsla), 0.0);
+    EXPECT_DOUBLE_EQ(engine.bias(kMarketSymbol), 0.0);
+
+    ASSERT_EQ(signals.size(), 6u);
+    EXPECT_EQ(signals[0].symbol, nvda);
+    EXPECT_GT(signals[0].delta_bias_shift, 0.0);
+    for (size_t i = 1; i < signals.size(); ++i) {
+        EXPECT_EQ(signals[i].symbol, tsla);
+        EXPECT_LT(signals[i].delta_bias_shift, 0.0);
+    }
+    EXPECT_EQ(engine.get_stats().weights_processed, 6u);
+    EXPECT_EQ(engine.get_stats().signals_generated, 6u);
+}
+
+TEST(MultiSymbolSignalEngineTest, test_cooldown_is_per_symbol) {
+    auto clock = std::make_shared<ManualClock>();
+    MultiSymbolSignalEngine::Config cfg = make_config(1);
+    cfg.engine.signal_cooldown = 1000us;
+    MultiSymbolSignalEngine engine(cfg, 3, clock);
+    std::vector<TradeSignal> signals;
+    engine.set_signal_callback([&](const TradeSignal& s) { signals.push_back(s); });
+
+    const SemanticWeight w{0.5, 0.9, 0.2, 0.5};
+    clock->advance(1ms);
+    engine.process_semantic_weight(1, w);
+    engine.process_semantic_weight(1, w);   // symbol 1 now cooling down
+    engine.process_semantic_weight(2, w);   // symbol 2 is not
+    ASSERT_EQ(signals.size(), 2u);
+    EXPECT_EQ(signals[0].symbol, 1u);
+    EXPECT_EQ(signals[1].symbol, 2u);
+}
+
+TEST(MultiSymbolSignalEngineTest, test_shards_on_separate_threads_lose_no_updates) {
+    constexpr size_t kShards   = 4;
+    constexpr size_t kSymbols  = 64;
+    constexpr int    kPerSymbol = 500;
+
+    MultiSymbolSignalEngine::Config cfg = make_config(kShards);
+    cfg.engine.signal_decay_rate = 1.0;   // pure sum, so the result is exact
+    MultiSymbolSignalEngine engine(cfg, kSymbols);
+    // No callback: every weight is processed but nothing halves the accumulators.
+
+    std::vector<std::thread> workers;
+    for (size_t shard = 0; shard < kShards; ++shard) {
+        workers.emplace_back([&engine, shard] {
+            for (int i = 0; i < kPerSymbol; ++i) {
+                for (SymbolId s = 0; s < kSymbols; ++s) {
+                    if (engine.shard_of(s) != shard) continue;
+                    engine.process_semantic_weight(s, SemanticWeight{0.0, 1.0, 0.0, 0.001});
+                }
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+
+    for (SymbolId s = 0; s < kSymbols; ++s) {
+        EXPECT_NEAR(engine.bias(s), 0.001 * kPerSymbol, 1e-9) << "symbol " << s;
+    }
+    EXPECT_EQ(engine.get_stats().weights_processed, kSymbols * kPerSymbol);
+}
+
+TEST(MultiSymbolSignalEngineTest, test_symbol_reaches_csv_sink) {
+    const std::string path = "test_multi_symbol_sink.csv";
+    {
+        MultiSymbolSignalEngine engine(make_config(2), 8);
+        engine.set_backtest_mode(true);
+        auto sink = std::make_shared<CsvOutputSink>(path);
+        engine.add_output_sink(sink);
+        engine.process_semantic_weight(5, SemanticWeight{0.5, 0.9, 0.1, 0.5});
+        sink->flush();
+    }
+    auto split = [](const std::string& line) {
+        std::vector<std::string> out;
+        std::stringstream ss(line);
+        for (std::string field; std::getline(ss, field, ',');) out.push_back(field);
+        return out;
+    };
+    std::ifstream in(path);
+    std::string header, row;
+    std::getline(in, header);
+    std::getline(in, row);
+    const std::vector<std::string> names  = split(header);
+    const std::vector<std::string> values = split(row);
+    ASSERT_EQ(names.size(), values.size());
+    const auto col = std::find(names.begin(), names.end(), "symbol");
+    ASSERT_NE(col, names.end());
+    EXPECT_EQ(values[static_cast<size_t>(col - names.begin())], "5");
+    std::remove(path.c_str());
+}
+
+TEST(MultiSymbolSignalEngineTest, test_risk_drawdown_is_tracked_per_symbol) {
+    RiskManager::Config cfg;
+    cfg.max_drawdown    = 0.25;
+    cfg.symbol_capacity = 3;
+    RiskManager rm(cfg);
+
+    TradeSignal nvda;
+    nvda.symbol           = 1;
+    nvda.delta_bias_shift = 0.1;
+    nvda.confidence       = 0.9;
+    TradeSignal tsla = nvda;
+    tsla.symbol      = 2;
+
+    EXPECT_TRUE(rm.evaluate(nvda));
+    EXPECT_TRUE(rm.evaluate(nvda));
+    EXPECT_FALSE(rm.evaluate(nvda));   // NVDA at its limit...
+    EXPECT_TRUE(rm.evaluate(tsla));    // ...TSLA unaffected
+    EXPECT_TRUE(rm.evaluate(tsla));
+
+    rm.reset();
+    EXPECT_TRUE(rm.evaluate(nvda));
+}
+
+TEST(MultiSymbolSignalEngineTest, test_risk_blocks_symbols_beyond_capacity) {
+    RiskManager::Config cfg;
+    cfg.symbol_capacity = 2;
+    RiskManager rm(cfg);
+
+    TradeSignal signal;
+    signal.delta_bias_shift = 0.1;
+    signal.confidence       = 0.9;
+    signal.symbol           = 1;
+    EXPECT_TRUE(rm.evaluate(signal));
+    signal.symbol = 2;
+    EXPECT_FALSE(rm.evaluate(signal));
+    signal.symbol = kInvalidSymbolId;
+    EXPECT_FALSE(rm.evaluate(signal));
+    EXPECT_EQ(rm.get_stats().signals_blocked_symbol.load(), 2u);
+}
+
+} // namespace
+} // namespace llmquant
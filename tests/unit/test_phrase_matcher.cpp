@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+#include "PhraseMatcher.h"
+#include "LLMAdapter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static SemanticWeight tagged(double tag) { return SemanticWeight{tag, 0.5, 0.0, 0.0}; }
+
+/// Reference: longest phrase that is a suffix of `history`, by brute force.
+static const PhraseMatcher::Phrase* reference_match(
+        const std::vector<PhraseMatcher::Phrase>& phrases, const std::vector<TokenId>& history) {
+    const PhraseMatcher::Phrase* best = nullptr;
+    for (const auto& p : phrases) {
+        if (p.tokens.size() > history.size()) continue;
+        if (!std::equal(p.tokens.rbegin(), p.tokens.rend(), history.rbegin())) continue;
+        if (!best || p.tokens.size() > best->tokens.size()) best = &p;
+    }
+    return best;
+}
+
+// ---------------------------------------------------------------------------
+// PhraseMatcher
+// ---------------------------------------------------------------------------
+
+TEST(PhraseMatcherTest, test_phrase_matcher_empty_never_matches) {
+    PhraseMatcher m;
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    EXPECT_EQ(m.advance(s, 0), nullptr);
+    EXPECT_EQ(m.advance(s, 12345), nullptr);
+    EXPECT_EQ(m.phrase_count(), 0u);
+}
+
+TEST(PhraseMatcherTest, test_phrase_matcher_matches_two_token_phrase) {
+    PhraseMatcher m({{{1, 2}, tagged(0.7)}});
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    EXPECT_EQ(m.advance(s, 1), nullptr);
+    const auto* hit = m.advance(s, 2);
+    ASSERT_NE(hit, nullptr);
+    EXPECT_DOUBLE_EQ(hit->weight.sentiment_score, 0.7);
+    EXPECT_EQ(hit->length, 2u);
+    // An unrelated token in between breaks the phrase.
+    EXPECT_EQ(m.advance(s, 1), nullptr);
+    EXPECT_EQ(m.advance(s, 99), nullptr);
+    EXPECT_EQ(m.advance(s, 2), nullptr);
+}
+
+TEST(PhraseMatcherTest, test_phrase_matcher_recovers_after_partial_prefix) {
+    // "1 1 2" must match "1 2" even though the first 1 started a prefix.
+    PhraseMatcher m({{{1, 2}, tagged(0.1)}, {{1, 3, 4}, tagged(0.2)}});
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    m.advance(s, 1);
+    m.advance(s, 1);
+    ASSERT_NE(m.advance(s, 2), nullptr);
+}
+
+TEST(PhraseMatcherTest, test_phrase_matcher_prefers_longest_overlapping_phrase) {
+    PhraseMatcher m({{{5}, tagged(0.1)}, {{4, 5}, tagged(0.2)}, {{3, 4, 5}, tagged(0.3)}});
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    m.advance(s, 4);
+    EXPECT_DOUBLE_EQ(m.advance(s, 5)->weight.sentiment_score, 0.2);
+    s = PhraseMatcher::kRoot;
+    m.advance(s, 3);
+    m.advance(s, 4);
+    EXPECT_DOUBLE_EQ(m.advance(s, 5)->weight.sentiment_score, 0.3);
+    s = PhraseMatcher::kRoot;
+    EXPECT_DOUBLE_EQ(m.advance(s, 5)->weight.sentiment_score, 0.1);
+}
+
+TEST(PhraseMatcherTest, test_phrase_matcher_duplicate_phrase_last_weight_wins) {
+    PhraseMatcher m({{{1, 2}, tagged(0.1)}, {{1, 2}, tagged(0.9)}});
+    EXPECT_EQ(m.phrase_count(), 1u);
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    m.advance(s, 1);
+    EXPECT_DOUBLE_EQ(m.advance(s, 2)->weight.sentiment_score, 0.9);
+}
+
+TEST(PhraseMatcherTest, test_phrase_matcher_agrees_with_brute_force_on_random_stream) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<TokenId> tok(0, 7);
+    std::uniform_int_distribution<size_t> len(1, 4);
+
+    std::vector<PhraseMatcher::Phrase> phrases;
+    for (int i = 0; i < 25; ++i) {
+        PhraseMatcher::Phrase p{{}, tagged(i)};
+        for (size_t k = len(rng); k > 0; --k) p.tokens.push_back(tok(rng));
+        // Keep token sequences unique so the reference has one answer.
+        bool dup = false;
+        for (const auto& q : phrases) dup |= q.tokens == p.tokens;
+        if (!dup) phrases.push_back(p);
+    }
+    PhraseMatcher m(phrases);
+
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    std::vector<TokenId> history;
+    for (int i = 0; i < 5000; ++i) {
+        const TokenId id = tok(rng) + (i % 17 == 0 ? 100 : 0);   // sprinkle unknown IDs
+        history.push_back(id);
+        const auto* got = m.advance(s, id);
+        const auto* want = reference_match(phrases, history);
+        ASSERT_EQ(got != nullptr, want != nullptr) << "step " << i;
+        if (got) {
+            EXPECT_DOUBLE_EQ(got->weight.sentiment_score, want->weight.sentiment_score);
+            EXPECT_EQ(got->length, want->tokens.size());
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// LLMAdapter integration
+// ---------------------------------------------------------------------------
+
+TEST(PhraseMatcherTest, test_phrase_matcher_large_phrase_set_stays_sparse) {
+    // 5000 four-token phrases over 20000 distinct tokens: a dense
+    // states x alphabet table would need ~1.6 GB.
+    constexpr TokenId kPhrases = 5000;
+    std::vector<PhraseMatcher::Phrase> phrases;
+    for (TokenId p = 0; p < kPhrases; ++p) {
+        phrases.push_back({{4 * p, 4 * p + 1, 4 * p + 2, 4 * p + 3}, tagged(static_cast<double>(p))});
+    }
+    const PhraseMatcher m(phrases);
+    EXPECT_EQ(m.phrase_count(), kPhrases);
+    EXPECT_EQ(m.state_count(), 1 + 4 * kPhrases);
+
+    PhraseMatcher::State s = PhraseMatcher::kRoot;
+    for (TokenId p : {TokenId{0}, TokenId{1234}, kPhrases - 1}) {
+        EXPECT_EQ(m.advance(s, 4 * p), nullptr);
+        EXPECT_EQ(m.advance(s, 4 * p + 1), nullptr);
+        EXPECT_EQ(m.advance(s, 4 * p + 2), nullptr);
+        const PhraseMatcher::Match* hit = m.advance(s, 4 * p + 3);
+        ASSERT_NE(hit, nullptr);
+        EXPECT_EQ(hit->weight.sentiment_score, static_cast<double>(p));
+        EXPECT_EQ(hit->length, 4u);
+    }
+}
+
+TEST(PhraseMatcherTest, test_llm_adapter_default_phrase_overrides_completing_token) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    EXPECT_GT(adapter.phrase_count(), 0u);
+
+    LLMAdapter::StreamState stream;
+    // "short" alone is bearish...
+    EXPECT_LT(adapter.map_token_id(vocab->intern("short"), stream).directional_bias, 0.0);
+    // ...but "short squeeze" is bullish.
+    EXPECT_GT(adapter.map_token_id(vocab->intern(" Squeeze"), stream).directional_bias, 0.0);
+}
+
+TEST(PhraseMatcherTest, test_llm_adapter_streams_have_independent_state) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    adapter.add_phrase_mapping("rate cut", {0.5, 0.9, 0.3, 0.6});
+
+    LLMAdapter::StreamState a, b;
+    adapter.map_token_id(vocab->intern("rate"), a);
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(vocab->intern("cut"), b).directional_bias, 0.0);
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(vocab->intern("cut"), a).directional_bias, 0.6);
+}
+
+TEST(PhraseMatcherTest, test_llm_adapter_phrases_added_before_binding_compile_on_bind) {
+    LLMAdapter adapter;
+    adapter.add_phrase_mapping("rate hike", {-0.5, 0.9, 0.4, -0.6});
+    auto vocab = std::make_shared<TokenVocabulary>();
+    adapter.bind_vocabulary(vocab);
+
+    LLMAdapter::StreamState s;
+    adapter.map_token_id(vocab->intern("rate"), s);
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(vocab->intern("hike"), s).directional_bias, -0.6);
+}
+
+TEST(PhraseMatcherTest, test_llm_adapter_loads_quoted_phrases_from_dictionary_file) {
+    const std::string path = "/tmp/llmquant_test_phrase_dict.txt";
+    {
+        std::ofstream f(path);
+        f << "moonshot 0.9 0.9 0.5 0.9\n";
+        f << "\"dead cat bounce\" -0.4 0.8 0.6 -0.5\n";
+    }
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    const size_t before = adapter.phrase_count();
+    adapter.load_sentiment_dictionary(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(adapter.phrase_count(), before + 1);
+    EXPECT_DOUBLE_EQ(adapter.map_token_to_weight("moonshot").directional_bias, 0.9);
+
+    LLMAdapter::StreamState s;
+    adapter.map_token_id(vocab->intern("dead"), s);
+    adapter.map_token_id(vocab->intern("cat"), s);
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(vocab->intern("bounce"), s).directional_bias, -0.5);
+}
+
+} // namespace
+} // namespace llmquant
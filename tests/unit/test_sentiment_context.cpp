@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+#include "SentimentContext.h"
+#include "LLMAdapter.h"
+#include "Config.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static ContextRules default_rules() {
+    ContextRules r;
+    r.negators     = {"not", "never"};
+    r.intensifiers = {{"extremely", 1.5}, {"slightly", 0.5}};
+    r.window       = 3;
+    return r;
+}
+
+/// Feed `words` through the adapter as one stream and return the last weight.
+static SemanticWeight score_stream(const LLMAdapter& adapter, TokenVocabulary& vocab,
+                                   const std::vector<std::string>& words) {
+    LLMAdapter::StreamState stream;
+    SemanticWeight w;
+    for (const auto& word : words) w = adapter.map_token_id(vocab.intern(word), stream);
+    return w;
+}
+
+// ---------------------------------------------------------------------------
+// SentimentContext
+// ---------------------------------------------------------------------------
+
+TEST(SentimentContextTest, test_sentiment_context_inactive_passes_weights_through) {
+    SentimentContext ctx;
+    SentimentContext::State s;
+    const SemanticWeight w{0.7, 0.9, 0.4, 0.8};
+    const SemanticWeight out = ctx.apply(s, 0, w);
+    EXPECT_DOUBLE_EQ(out.sentiment_score,  0.7);
+    EXPECT_DOUBLE_EQ(out.directional_bias, 0.8);
+    EXPECT_FALSE(ctx.active());
+}
+
+TEST(SentimentContextTest, test_sentiment_context_negator_flips_next_sentiment_token) {
+    TokenVocabulary vocab;
+    SentimentContext ctx;
+    ctx.compile(default_rules(), vocab);
+    SentimentContext::State s;
+
+    const SemanticWeight neutral{0.0, 0.5, 0.1, 0.0};
+    const SemanticWeight bullish{0.7, 0.9, 0.4, 0.8};
+    ctx.apply(s, vocab.intern("not"), neutral);
+    const SemanticWeight out = ctx.apply(s, vocab.intern("bullish"), bullish);
+    EXPECT_DOUBLE_EQ(out.sentiment_score,  -0.7);
+    EXPECT_DOUBLE_EQ(out.directional_bias, -0.8);
+    EXPECT_DOUBLE_EQ(out.confidence_score,  0.9);
+    EXPECT_DOUBLE_EQ(out.volatility_score,  0.4);
+
+    // The negator was consumed; the next sentiment token is unaffected.
+    const SemanticWeight again = ctx.apply(s, vocab.intern("bullish"), bullish);
+    EXPECT_DOUBLE_EQ(again.directional_bias, 0.8);
+}
+
+TEST(SentimentContextTest, test_sentiment_context_double_negation_cancels) {
+    TokenVocabulary vocab;
+    SentimentContext ctx;
+    ctx.compile(default_rules(), vocab);
+    SentimentContext::State s;
+
+    const SemanticWeight neutral{0.0, 0.5, 0.1, 0.0};
+    ctx.apply(s, vocab.intern("not"), neutral);
+    ctx.apply(s, vocab.intern("never"), neutral);
+    const SemanticWeight out = ctx.apply(s, vocab.intern("bearish"), {-0.7, 0.9, 0.4, -0.8});
+    EXPECT_DOUBLE_EQ(out.directional_bias, -0.8);
+}
+
+TEST(SentimentContextTest, test_sentiment_context_modifier_expires_outside_window) {
+    TokenVocabulary vocab;
+    SentimentContext ctx;
+    ctx.compile(default_rules(), vocab);
+    SentimentContext::State s;
+
+    const SemanticWeight neutral{0.0, 0.1, 0.0, 0.0};
+    ctx.apply(s, vocab.intern("not"), neutral);
+    ctx.apply(s, vocab.intern("the"), neutral);
+    ctx.apply(s, vocab.intern("a"), neutral);
+    ctx.apply(s, vocab.intern("of"), neutral);   // "not" falls out of a window of 3
+    const SemanticWeight out = ctx.apply(s, vocab.intern("bullish"), {0.7, 0.9, 0.4, 0.8});
+    EXPECT_DOUBLE_EQ(out.directional_bias, 0.8);
+}
+
+TEST(SentimentContextTest, test_sentiment_context_intensifier_scales_and_clamps) {
+    TokenVocabulary vocab;
+    SentimentContext ctx;
+    ctx.compile(default_rules(), vocab);
+    SentimentContext::State s;
+
+    const SemanticWeight neutral{0.0, 0.5, 0.1, 0.0};
+    ctx.apply(s, vocab.intern("slightly"), neutral);
+    SemanticWeight out = ctx.apply(s, vocab.intern("bearish"), {-0.7, 0.9, 0.4, -0.8});
+    EXPECT_DOUBLE_EQ(out.sentiment_score,  -0.35);
+    EXPECT_DOUBLE_EQ(out.directional_bias, -0.4);
+    EXPECT_DOUBLE_EQ(out.volatility_score,  0.2);
+
+    ctx.apply(s, vocab.intern("extremely"), neutral);
+    out = ctx.apply(s, vocab.intern("crash"), {-0.9, 0.9, 0.8, -0.7});
+    EXPECT_DOUBLE_EQ(out.sentiment_score,  -1.0);   // -1.35 clamped
+    EXPECT_DOUBLE_EQ(out.volatility_score,  1.0);   //  1.2 clamped
+    EXPECT_DOUBLE_EQ(out.directional_bias, -1.0);   // -1.05 clamped
+}
+
+TEST(SentimentContextTest, test_sentiment_context_direction_multiplier_follows_negation) {
+    TokenVocabulary vocab;
+    ContextRules rules = default_rules();
+    rules.bearish_multiplier = 0.5;
+    SentimentContext ctx;
+    ctx.compile(rules, vocab);
+    SentimentContext::State s;
+
+    // "not bullish" is bearish after negation, so the bearish scale applies.
+    ctx.apply(s, vocab.intern("not"), {0.0, 0.5, 0.1, 0.0});
+    const SemanticWeight out = ctx.apply(s, vocab.intern("bullish"), {0.6, 0.9, 0.4, 0.8});
+    EXPECT_DOUBLE_EQ(out.sentiment_score,  -0.3);
+    EXPECT_DOUBLE_EQ(out.directional_bias, -0.4);
+}
+
+// ---------------------------------------------------------------------------
+// LLMAdapter integration
+// ---------------------------------------------------------------------------
+
+TEST(SentimentContextTest, test_llm_adapter_not_bullish_scores_bearish) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    adapter.set_context_rules(default_rules());
+
+    const SemanticWeight plain   = score_stream(adapter, *vocab, {"bullish"});
+    const SemanticWeight negated = score_stream(adapter, *vocab, {"not", "bullish"});
+    const SemanticWeight strong  = score_stream(adapter, *vocab, {"Extremely", " bearish"});
+    EXPECT_GT(plain.directional_bias, 0.0);
+    EXPECT_DOUBLE_EQ(negated.directional_bias, -plain.directional_bias);
+    EXPECT_LT(strong.sentiment_score, adapter.map_token_to_weight("bearish").sentiment_score);
+}
+
+TEST(SentimentContextTest, test_llm_adapter_context_rules_compiled_on_later_bind) {
+    LLMAdapter adapter;
+    adapter.set_context_rules(default_rules());   // no vocabulary yet
+    auto vocab = std::make_shared<TokenVocabulary>();
+    adapter.bind_vocabulary(vocab);
+
+    const SemanticWeight negated = score_stream(adapter, *vocab, {"not", "rally"});
+    EXPECT_LT(negated.directional_bias, 0.0);
+}
+
+TEST(SentimentContextTest, test_config_parses_context_rules) {
+    Config cfg;
+    ASSERT_TRUE(cfg.load_from_yaml_string(R"yaml(
+semantic_weights:
+  bearish_multiplier: 1.2
+  context_window: 4
+  negators: ["not", "no"]
+  intensifiers:
+    very: 1.3
+    slightly: 0.5
+)yaml"));
+    const SemanticWeightsConfig& sw = cfg.get_config().semantic_weights;
+    EXPECT_DOUBLE_EQ(sw.bearish_multiplier, 1.2);
+    EXPECT_DOUBLE_EQ(sw.bullish_multiplier, 1.0);
+    EXPECT_EQ(sw.context_window, 4);
+    EXPECT_EQ(sw.negators, (std::vector<std::string>{"not", "no"}));
+    ASSERT_EQ(sw.intensifiers.size(), 2u);
+    EXPECT_DOUBLE_EQ(sw.intensifiers.at("very"), 1.3);
+}
+
+} // namespace
+} // namespace llmquant
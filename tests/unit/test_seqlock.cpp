@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+#include "SeqLock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// Five words, so a torn read would mix fields from different writes.
+struct Payload {
+    uint64_t n{0};
+    uint64_t twice{0};
+    uint64_t inverted{~uint64_t{0}};
+    double   half{0.0};
+    uint32_t low{0};
+};
+
+static Payload make_payload(uint64_t n) {
+    return Payload{n, n * 2, ~n, static_cast<double>(n) / 2.0, static_cast<uint32_t>(n)};
+}
+
+static bool consistent(const Payload& p) {
+    return p.twice == p.n * 2 && p.inverted == ~p.n &&
+           p.half == static_cast<double>(p.n) / 2.0 && p.low == static_cast<uint32_t>(p.n);
+}
+
+TEST(SeqLockTest, test_seqlock_default_value_and_sequential_writes) {
+    SeqLock<Payload> lock;
+    EXPECT_TRUE(consistent(lock.read()));
+    EXPECT_EQ(lock.read().n, 0u);
+    EXPECT_EQ(lock.sequence(), 0u);
+
+    lock.write(make_payload(7));
+    lock.write(make_payload(9));
+    EXPECT_EQ(lock.read().n, 9u);
+    EXPECT_TRUE(consistent(lock.read()));
+    EXPECT_EQ(lock.sequence(), 2u);
+}
+
+TEST(SeqLockTest, test_seqlock_readers_never_observe_torn_values) {
+    SeqLock<Payload> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> went_backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const Payload p = lock.read();
+                if (!consistent(p)) torn.fetch_add(1);
+                if (p.n < last) went_backwards.fetch_add(1);
+                last = p.n;
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    constexpr uint64_t kWrites = 200'000;
+    for (uint64_t i = 1; i <= kWrites; ++i) lock.write(make_payload(i));
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(went_backwards.load(), 0u);
+    EXPECT_EQ(lock.read().n, kWrites);
+    EXPECT_EQ(lock.sequence(), kWrites);
+}
+
+} // namespace
+} // namespace llmquant
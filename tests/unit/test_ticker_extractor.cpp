@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include "TickerExtractor.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+struct Fixture {
+    TokenVocabulary vocab;
+    SymbolTable     symbols;
+    TickerExtractor extractor;
+
+    explicit Fixture(uint32_t window = 3) {
+        TickerRules rules;
+        rules.tickers = {{"NVDA", {"nvidia"}}, {"TSLA", {}}, {"SPX", {"s&p"}}};
+        rules.window  = window;
+        extractor.compile(rules, vocab, symbols);
+    }
+
+    /// Attribute each whitespace-separated word of `text` in one stream.
+    std::vector<SymbolId> run(const std::string& text) {
+        TickerExtractor::State state;
+        std::vector<SymbolId> out;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find(' ', pos);
+            if (end == std::string::npos) end = text.size();
+            out.push_back(extractor.attribute(state, vocab.intern(text.substr(pos, end - pos))));
+            pos = end + 1;
+        }
+        return out;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Recognition
+// ---------------------------------------------------------------------------
+
+TEST(TickerExtractorTest, test_inactive_extractor_attributes_everything_to_market) {
+    TokenVocabulary vocab;
+    TickerExtractor extractor;
+    TickerExtractor::State state;
+    EXPECT_FALSE(extractor.active());
+    EXPECT_EQ(extractor.attribute(state, vocab.intern("NVDA")), kMarketSymbol);
+}
+
+TEST(TickerExtractorTest, test_names_cashtags_and_aliases_are_recognised) {
+    Fixture f;
+    const SymbolId nvda = f.symbols.find("NVDA");
+    const SymbolId spx  = f.symbols.find("SPX");
+    ASSERT_NE(nvda, kInvalidSymbolId);
+    EXPECT_TRUE(f.extractor.active());
+
+    for (const char* word : {"NVDA", "nvda", " Nvda", "$NVDA", "Nvidia"}) {
+        TickerExtractor::State state;
+        EXPECT_EQ(f.extractor.attribute(state, f.vocab.intern(word)), nvda) << word;
+    }
+    TickerExtractor::State state;
+    EXPECT_EQ(f.extractor.attribute(state, f.vocab.intern("S&P")), spx);
+    EXPECT_EQ(f.extractor.attribute(state = {}, f.vocab.intern("AAPL")), kMarketSymbol);
+}
+
+TEST(TickerExtractorTest, test_compile_rejects_empty_ticker_name) {
+    TokenVocabulary vocab;
+    SymbolTable symbols;
+    TickerExtractor extractor;
+    TickerRules rules;
+    rules.tickers = {{"", {}}};
+    EXPECT_THROW(extractor.compile(rules, vocab, symbols), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Attribution window
+// ---------------------------------------------------------------------------
+
+TEST(TickerExtractorTest, test_sentiment_after_mention_is_attributed_within_window) {
+    Fixture f(3);
+    const SymbolId m    = kMarketSymbol;
+    const SymbolId nvda = f.symbols.find("NVDA");
+    const SymbolId tsla = f.symbols.find("TSLA");
+
+    // "crash" precedes any ticker; three tokens after NVDA stay on NVDA;
+    // the fourth falls back to the market; TSLA takes over on mention.
+    const std::vector<SymbolId> expected{m, nvda, nvda, nvda, nvda, m, tsla, tsla};
+    EXPECT_EQ(f.run("crash $NVDA looks very bullish today TSLA bearish"), expected);
+}
+
+TEST(TickerExtractorTest, test_new_mention_restarts_window) {
+    Fixture f(2);
+    const SymbolId nvda = f.symbols.find("NVDA");
+    const std::vector<SymbolId> expected{nvda, nvda, nvda, nvda, nvda, kMarketSymbol};
+    EXPECT_EQ(f.run("NVDA up nvidia again strong still"), expected);
+}
+
+TEST(TickerExtractorTest, test_streams_keep_independent_state) {
+    Fixture f;
+    const SymbolId tsla = f.symbols.find("TSLA");
+    TickerExtractor::State a, b;
+    EXPECT_EQ(f.extractor.attribute(a, f.vocab.intern("TSLA")), tsla);
+    EXPECT_EQ(f.extractor.attribute(b, f.vocab.intern("bearish")), kMarketSymbol);
+    EXPECT_EQ(f.extractor.attribute(a, f.vocab.intern("bearish")), tsla);
+}
+
+TEST(TickerExtractorTest, test_recompile_replaces_tickers) {
+    Fixture f;
+    TickerRules rules;
+    rules.tickers = {{"AAPL", {}}};
+    f.extractor.compile(rules, f.vocab, f.symbols);
+
+    TickerExtractor::State state;
+    EXPECT_EQ(f.extractor.attribute(state, f.vocab.intern("NVDA")), kMarketSymbol);
+    EXPECT_EQ(f.extractor.attribute(state, f.vocab.intern("AAPL")), f.symbols.find("AAPL"));
+}
+
+} // namespace
+} // namespace llmquant
@@ -0,0 +1,200 @@
+#include "gtest/gtest.h"
+#include "TokenJournal.h"
+#include "TokenStreamSimulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+constexpr uint64_t kMs = 1000000;   // nanoseconds per millisecond
+
+/// Emitted token with its wall-clock arrival, for pacing checks.
+struct Arrival {
+    std::string text;
+    uint64_t sequence{0};
+    uint32_t stream_id{0};
+    std::chrono::steady_clock::time_point at;
+};
+
+/// Replay `path` at `speed` until `expected` tokens arrive (or 2 s pass).
+static std::vector<Arrival> replay(const std::string& path, double speed, size_t expected) {
+    TokenStreamSimulator::Config cfg;
+    cfg.token_interval = std::chrono::microseconds{100};
+    cfg.buffer_size    = 4;   // smaller than the journal: forces refills
+    cfg.replay_speed   = speed;
+    TokenStreamSimulator sim(cfg);
+    sim.replay_journal(path);
+
+    std::mutex mu;
+    std::vector<Arrival> arrivals;
+    sim.set_token_callback([&](const Token& tok) {
+        std::lock_guard<std::mutex> lk(mu);
+        arrivals.push_back({std::string(tok.text), tok.sequence_id, tok.stream_id,
+                            std::chrono::steady_clock::now()});
+    });
+    sim.start();
+    for (int i = 0; i < 400; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::lock_guard<std::mutex> lk(mu);
+        if (arrivals.size() >= expected) break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));   // would-be extra emissions
+    sim.stop();
+    return arrivals;
+}
+
+static double elapsed_ms(const Arrival& from, const Arrival& to) {
+    return std::chrono::duration<double, std::milli>(to.at - from.at).count();
+}
+
+// ---------------------------------------------------------------------------
+// Writer / reader
+// ---------------------------------------------------------------------------
+
+TEST(TokenJournalTest, test_token_journal_round_trips_records) {
+    const std::string path = ::testing::TempDir() + "journal_roundtrip.bin";
+    {
+        TokenJournalWriter writer(path);
+        writer.record(0, "bullish", 100);
+        writer.record(7, " crash", 250);
+        writer.record(0, "", 300);
+        EXPECT_EQ(writer.records_written(), 3u);
+    }
+
+    TokenJournalReader reader(path);
+    JournalRecord rec;
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, "bullish");
+    EXPECT_EQ(rec.receive_ns, 100u);
+    EXPECT_EQ(rec.stream_id, 0u);
+    EXPECT_EQ(rec.sequence, 0u);
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, " crash");
+    EXPECT_EQ(rec.stream_id, 7u);
+    EXPECT_EQ(rec.sequence, 0u);   // sequences are per stream
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, "");
+    EXPECT_EQ(rec.sequence, 1u);
+    EXPECT_FALSE(reader.next(rec));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, "bullish");
+    std::remove(path.c_str());
+}
+
+TEST(TokenJournalTest, test_token_journal_default_timestamp_is_monotonic_now) {
+    const std::string path = ::testing::TempDir() + "journal_now.bin";
+    const uint64_t before = monotonic_ns();
+    {
+        TokenJournalWriter writer(path);
+        writer.record(1, "surge");
+    }
+    const uint64_t after = monotonic_ns();
+
+    TokenJournalReader reader(path);
+    JournalRecord rec;
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_GE(rec.receive_ns, before);
+    EXPECT_LE(rec.receive_ns, after);
+    EXPECT_GE(reader.origin_ns(), before);
+    std::remove(path.c_str());
+}
+
+TEST(TokenJournalTest, test_token_journal_rejects_non_journal_file) {
+    const std::string path = ::testing::TempDir() + "journal_bogus.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "this is a plain token file, not a journal";
+    }
+    EXPECT_THROW(TokenJournalReader{path}, std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(TokenJournalReader{path}, std::runtime_error);   // missing
+}
+
+TEST(TokenJournalTest, test_token_journal_torn_tail_ends_journal) {
+    const std::string path = ::testing::TempDir() + "journal_torn.bin";
+    {
+        TokenJournalWriter writer(path);
+        writer.record(0, "rally", 1);
+        writer.record(0, "plunge", 2);
+    }
+    {
+        // Chop the last record mid-text, as a crash during flush would.
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 3));
+    }
+
+    TokenJournalReader reader(path);
+    JournalRecord rec;
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ(rec.text, "rally");
+    EXPECT_FALSE(reader.next(rec));
+    std::remove(path.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Simulator replay
+// ---------------------------------------------------------------------------
+
+TEST(TokenJournalTest, test_simulator_replay_preserves_records_and_plays_once) {
+    const std::string path = ::testing::TempDir() + "journal_replay_once.bin";
+    {
+        TokenJournalWriter writer(path);
+        for (int i = 0; i < 10; ++i) writer.record(i % 2 ? 3u : 9u, "tok" + std::to_string(i), 1000 + i);
+    }
+
+    const std::vector<Arrival> got = replay(path, 0.0, 10);
+    std::remove(path.c_str());
+
+    ASSERT_EQ(got.size(), 10u);
+    for (size_t i = 0; i < got.size(); ++i) {
+        EXPECT_EQ(got[i].text, "tok" + std::to_string(i));
+        EXPECT_EQ(got[i].stream_id, i % 2 ? 3u : 9u);
+        EXPECT_EQ(got[i].sequence, i / 2);
+    }
+}
+
+TEST(TokenJournalTest, test_simulator_replay_reproduces_recorded_gaps) {
+    const std::string path = ::testing::TempDir() + "journal_replay_gaps.bin";
+    {
+        // A burst of three, a 40 ms pause, then a second burst.
+        TokenJournalWriter writer(path);
+        const uint64_t t0 = 5 * kMs;
+        for (uint64_t i = 0; i < 3; ++i) writer.record(0, "a", t0 + i * 100);
+        for (uint64_t i = 0; i < 3; ++i) writer.record(0, "b", t0 + 40 * kMs + i * 100);
+    }
+
+    const std::vector<Arrival> real_time = replay(path, 1.0, 6);
+    ASSERT_EQ(real_time.size(), 6u);
+    EXPECT_LT(elapsed_ms(real_time[0], real_time[2]), 20.0);   // burst stays a burst
+    EXPECT_GE(elapsed_ms(real_time[0], real_time[3]), 39.0);
+    EXPECT_LT(elapsed_ms(real_time[3], real_time[5]), 20.0);
+
+    const std::vector<Arrival> double_speed = replay(path, 2.0, 6);
+    ASSERT_EQ(double_speed.size(), 6u);
+    EXPECT_GE(elapsed_ms(double_speed[0], double_speed[3]), 19.0);
+
+    const std::vector<Arrival> flat_out = replay(path, 0.0, 6);
+    std::remove(path.c_str());
+    ASSERT_EQ(flat_out.size(), 6u);
+    EXPECT_LT(elapsed_ms(flat_out[0], flat_out[5]), 30.0);
+}
+
+} // namespace
+} // namespace llmquant
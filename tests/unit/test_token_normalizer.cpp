@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include "TokenNormalizer.h"
+#include "LLMAdapter.h"
+
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/// Reference implementation: the scalar isspace()/tolower() loop the
+/// vectorised kernel replaces.
+static std::string reference_normalize(const std::string& token) {
+    size_t start = 0;
+    while (start < token.size() && std::isspace(static_cast<unsigned char>(token[start]))) ++start;
+    size_t end = token.size();
+    while (end > start && std::isspace(static_cast<unsigned char>(token[end - 1]))) --end;
+    std::string norm;
+    for (size_t i = start; i < end; ++i)
+        norm += static_cast<char>(std::tolower(static_cast<unsigned char>(token[i])));
+    return norm;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST(TokenNormalizerTest, test_token_normalizer_trims_and_lowercases) {
+    NormalizeBuffer buf;
+    EXPECT_EQ(normalize_token(" Bullish", buf), "bullish");
+    EXPECT_EQ(normalize_token("CRASH\n", buf), "crash");
+    EXPECT_EQ(normalize_token("\t\r rally \v\f", buf), "rally");
+    EXPECT_EQ(normalize_token("already", buf), "already");
+}
+
+TEST(TokenNormalizerTest, test_token_normalizer_empty_and_all_whitespace) {
+    NormalizeBuffer buf;
+    EXPECT_EQ(normalize_token("", buf), "");
+    EXPECT_EQ(normalize_token("   ", buf), "");
+    EXPECT_EQ(normalize_token(std::string(40, ' '), buf), "");
+}
+
+TEST(TokenNormalizerTest, test_token_normalizer_preserves_inner_whitespace_and_symbols) {
+    NormalizeBuffer buf;
+    EXPECT_EQ(normalize_token("  Short Squeeze ", buf), "short squeeze");
+    EXPECT_EQ(normalize_token("$NVDA", buf), "$nvda");
+    EXPECT_EQ(normalize_token("S&P-500", buf), "s&p-500");
+}
+
+TEST(TokenNormalizerTest, test_token_normalizer_non_ascii_bytes_pass_through) {
+    NormalizeBuffer buf;
+    // UTF-8 for "ÉTÉ" — only the ASCII 'T' is lowercased.
+    const std::string utf8 = "\xC3\x89T\xC3\x89";
+    EXPECT_EQ(normalize_token(utf8, buf), "\xC3\x89t\xC3\x89");
+}
+
+TEST(TokenNormalizerTest, test_token_normalizer_matches_reference_across_lengths) {
+    // Cover every tail length around the 16/32-byte vector widths.
+    for (size_t len = 0; len < 80; ++len) {
+        std::string token;
+        for (size_t i = 0; i < len; ++i) token += static_cast<char>('A' + (i * 7) % 58);
+        for (const std::string& padded : {token, "  " + token, token + " \n", "\t" + token + "\t"}) {
+            NormalizeBuffer buf;
+            EXPECT_EQ(normalize_token(padded, buf), reference_normalize(padded))
+                << "len=" << len;
+        }
+    }
+}
+
+TEST(TokenNormalizerTest, test_token_normalizer_oversize_token_spills_to_overflow) {
+    const std::string big = "  " + std::string(NormalizeBuffer::kCapacity + 10, 'Q') + " ";
+    NormalizeBuffer buf;
+    std::string_view out = normalize_token(big, buf);
+    EXPECT_EQ(out, std::string(NormalizeBuffer::kCapacity + 10, 'q'));
+    EXPECT_EQ(out.data(), buf.overflow.data());
+}
+
+TEST(TokenNormalizerTest, test_next_token_matches_reference_split) {
+    // Tokens of every length around the 16/32-byte vector widths, separated
+    // by runs of mixed whitespace, with no trailing delimiter.
+    std::string text;
+    std::vector<std::string> expected;
+    const char* gaps[] = {" ", "\t\n", "   \r\n ", "\v\f"};
+    for (size_t len = 1; len <= 70; ++len) {
+        std::string tok;
+        for (size_t i = 0; i < len; ++i) tok += static_cast<char>('a' + (len + i) % 26);
+        text += gaps[len % 4];
+        text += tok;
+        expected.push_back(tok);
+    }
+
+    // Copy into an exactly sized heap buffer so any over-read trips ASan.
+    std::unique_ptr<char[]> exact(new char[text.size()]);
+    std::memcpy(exact.get(), text.data(), text.size());
+    const std::string_view view(exact.get(), text.size());
+
+    std::vector<std::string> got;
+    size_t pos = 0;
+    for (std::string_view tok = next_token(view, pos); !tok.empty(); tok = next_token(view, pos)) {
+        got.emplace_back(tok);
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_EQ(pos, view.size());
+}
+
+TEST(TokenNormalizerTest, test_next_token_empty_and_whitespace_only) {
+    size_t pos = 0;
+    EXPECT_TRUE(next_token("", pos).empty());
+    pos = 0;
+    EXPECT_TRUE(next_token(" \t\n  ", pos).empty());
+    EXPECT_EQ(pos, 5u);
+}
+
+TEST(TokenNormalizerTest, test_llm_adapter_lookup_accepts_string_view) {
+    LLMAdapter adapter;
+    const std::string stream = "xx Bearish yy";
+    std::string_view token = std::string_view(stream).substr(2, 9);  // " Bearish "
+    EXPECT_LT(adapter.map_token_to_weight(token).directional_bias, 0.0);
+
+    // The unfrozen map path uses heterogeneous lookup on the same view.
+    adapter.add_token_mapping("thaw", SemanticWeight{});
+    ASSERT_FALSE(adapter.is_frozen());
+    EXPECT_LT(adapter.map_token_to_weight(token).directional_bias, 0.0);
+}
+
+} // namespace
+} // namespace llmquant
@@ -1,8 +1,13 @@
 #include "gtest/gtest.h"
 #include "TokenStreamSimulator.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
@@ -145,7 +150,7 @@ TEST(TokenStreamSimulatorTest, test_ring_buffer_fills_and_cycles_source) {
     std::mutex rx_mutex;
     sim.set_token_callback([&](const llmquant::Token& tok) {
         std::lock_guard<std::mutex> lk(rx_mutex);
-        received.push_back(tok.text);
+        received.emplace_back(tok.text);
     });
     sim.start();
     std::this_thread::sleep_for(std::chrono::milliseconds(30));
@@ -159,5 +164,247 @@ TEST(TokenStreamSimulatorTest, test_ring_buffer_fills_and_cycles_source) {
     EXPECT_FALSE(received.empty());
 }
 
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_tokens_view_one_arena_copy) {
+    TokenStreamSimulator sim(make_config(100));
+    sim.load_tokens_from_memory({"alpha", "beta"});
+
+    std::mutex mu;
+    std::vector<std::string_view> views;
+    sim.set_token_callback([&](const Token& tok) {
+        std::lock_guard<std::mutex> lk(mu);
+        views.push_back(tok.text);
+    });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    sim.stop();
+
+    // Every emission of the same source token views the same arena bytes,
+    // and the two tokens are stored back to back.
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_GE(views.size(), 3u);
+    const char* alpha = nullptr;
+    const char* beta  = nullptr;
+    for (const auto& v : views) {
+        const char*& first = (v == "alpha") ? alpha : beta;
+        if (!first) first = v.data();
+        EXPECT_EQ(v.data(), first);
+    }
+    ASSERT_NE(alpha, nullptr);
+    ASSERT_NE(beta, nullptr);
+    EXPECT_EQ(beta, alpha + 5);
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_load_file_splits_whitespace) {
+    const std::string path = ::testing::TempDir() + "sim_tokens_arena.txt";
+    {
+        std::ofstream out(path);
+        out << "  crash\tpanic \n\n rally   surge\n";
+    }
+    TokenStreamSimulator sim(make_config(100));
+    sim.load_tokens_from_file(path);
+
+    std::mutex mu;
+    std::vector<std::string> received;
+    sim.set_token_callback([&](const Token& tok) {
+        std::lock_guard<std::mutex> lk(mu);
+        received.emplace_back(tok.text);
+    });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sim.stop();
+    std::remove(path.c_str());
+
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_GE(received.size(), 4u);
+    EXPECT_EQ(received[0], "crash");
+    EXPECT_EQ(received[1], "panic");
+    EXPECT_EQ(received[2], "rally");
+    EXPECT_EQ(received[3], "surge");
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_stream_file_emits_in_order_and_wraps) {
+    const std::string path = ::testing::TempDir() + "sim_tokens_stream.txt";
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 100; ++i) out << "tok" << i << (i % 7 ? " " : "\n  ");
+    }
+    auto cfg = make_config(10);
+    cfg.buffer_size = 16;   // far smaller than the file: forces lazy refills
+    TokenStreamSimulator sim(cfg);
+    sim.stream_tokens_from_file(path);
+
+    std::mutex mu;
+    std::vector<std::string> received;
+    sim.set_token_callback([&](const Token& tok) {
+        std::lock_guard<std::mutex> lk(mu);
+        received.emplace_back(tok.text);
+        EXPECT_EQ(sim.vocabulary()->text(tok.token_id), tok.text);
+    });
+    sim.start();
+    for (int i = 0; i < 200; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::lock_guard<std::mutex> lk(mu);
+        if (received.size() >= 150) break;
+    }
+    sim.stop();
+    std::remove(path.c_str());
+
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_GE(received.size(), 150u);
+    for (size_t i = 0; i < received.size(); ++i) {
+        EXPECT_EQ(received[i], "tok" + std::to_string(i % 100)) << "at emission " << i;
+    }
+    EXPECT_EQ(sim.vocabulary()->size(), 100u);
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_stream_missing_file_throws) {
+    TokenStreamSimulator sim(make_config());
+    EXPECT_THROW(sim.stream_tokens_from_file("/nonexistent/tokens.txt"), std::runtime_error);
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_reload_while_running_is_safe) {
+    TokenStreamSimulator sim(make_config(50));
+    sim.load_tokens_from_memory({"one", "two"});
+
+    std::atomic<size_t> bytes{0};
+    sim.set_token_callback([&](const Token& tok) { bytes += tok.text.size(); });
+    sim.start();
+    for (int i = 0; i < 5; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        sim.load_tokens_from_memory({"three", "four", "five"});
+    }
+    sim.stop();
+    EXPECT_GT(bytes.load(), 0u);
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_reload_while_running_never_replays_old_tokens) {
+    // Corpus k is "k.0" .. "k.4".  Tokens must come out cyclically in corpus
+    // order, and once corpus k has been emitted no earlier corpus may follow.
+    constexpr int kCorpusSize = 5;
+    auto corpus = [](int k) {
+        std::vector<std::string> tokens;
+        for (int i = 0; i < kCorpusSize; ++i) tokens.push_back(std::to_string(k) + "." + std::to_string(i));
+        return tokens;
+    };
+    TokenStreamSimulator sim(make_config(0));
+    sim.load_tokens_from_memory(corpus(0));
+
+    std::mutex mu;
+    std::vector<std::pair<int, int>> emitted;   // (corpus, index)
+    sim.set_token_callback([&](const Token& tok) {
+        const std::string text(tok.text);
+        const size_t dot = text.find('.');
+        std::lock_guard<std::mutex> lock(mu);
+        emitted.emplace_back(std::stoi(text.substr(0, dot)), std::stoi(text.substr(dot + 1)));
+    });
+    sim.start();
+    constexpr int kReloads = 2000;
+    for (int k = 1; k <= kReloads; ++k) {
+        if (k % 16 == 0) std::this_thread::yield();
+        sim.load_tokens_from_memory(corpus(k));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sim.stop();
+
+    std::lock_guard<std::mutex> lock(mu);
+    ASSERT_FALSE(emitted.empty());
+    for (size_t i = 1; i < emitted.size(); ++i) {
+        const auto [prev_k, prev_i] = emitted[i - 1];
+        const auto [k, idx] = emitted[i];
+        ASSERT_LE(prev_k, k) << "token of an earlier corpus replayed at " << i;
+        if (k == prev_k) {
+            ASSERT_EQ(idx, (prev_i + 1) % kCorpusSize) << "corpus order broken at " << i;
+        }
+    }
+    EXPECT_EQ(emitted.back().first, kReloads);   // the last load was picked up
+}
+
+TEST(TokenStreamSimulatorTest, test_parse_pacing) {
+    EXPECT_EQ(parse_pacing("sleep"), Pacing::Sleep);
+    EXPECT_EQ(parse_pacing("spin"), Pacing::Spin);
+    EXPECT_EQ(parse_pacing("hybrid"), Pacing::Hybrid);
+    EXPECT_THROW(parse_pacing("spinn"), std::invalid_argument);
+    EXPECT_THROW(parse_pacing(""), std::invalid_argument);
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_spin_pacing_holds_short_interval) {
+    auto cfg = make_config(20);   // 50k tokens/s: below what sleep-based pacing can hit
+    cfg.pacing = TokenStreamSimulator::Pacing::Spin;
+    TokenStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory({"alpha", "beta", "gamma"});
+    const auto started = std::chrono::steady_clock::now();
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    sim.stop();
+    const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    const auto& stats = sim.get_stats();
+    const uint64_t emitted = stats.tokens_emitted.load();
+    const uint64_t scheduled = static_cast<uint64_t>(elapsed_us / 20) + 1;
+    EXPECT_GE(emitted, scheduled * 2 / 3);
+    EXPECT_LE(emitted, scheduled);   // absolute deadlines never run ahead of schedule
+    EXPECT_GT(stats.achieved_rate_tps.load(), 30000u);
+    EXPECT_LE(stats.achieved_rate_tps.load(), 51000u);
+    EXPECT_GE(stats.pacing_error_max_ns.load(), stats.pacing_error_avg_ns.load());
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_hybrid_pacing_does_not_drift) {
+    auto cfg = make_config(1000);
+    cfg.pacing      = TokenStreamSimulator::Pacing::Hybrid;
+    cfg.spin_window = std::chrono::microseconds{300};
+    TokenStreamSimulator sim(cfg);
+    sim.load_tokens_from_memory({"alpha"});
+    const auto started = std::chrono::steady_clock::now();
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    sim.stop();
+    const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    // 1 ms deadlines: per-token overshoot must not accumulate into drift.
+    const uint64_t emitted   = sim.get_stats().tokens_emitted.load();
+    const uint64_t scheduled = static_cast<uint64_t>(elapsed_ms) + 1;
+    EXPECT_GE(emitted, scheduled * 9 / 10);
+    EXPECT_LE(emitted, scheduled);
+}
+
+TEST(TokenStreamSimulatorTest, test_token_stream_simulator_batch_callback_coalesces_due_tokens) {
+    TokenStreamSimulator sim(make_config(100));
+    sim.load_tokens_from_memory({"alpha", "beta", "gamma"});
+
+    std::mutex mu;
+    std::vector<size_t> sizes;
+    std::vector<uint64_t> sequences;
+    std::vector<uint64_t> emitted_at;
+    sim.set_batch_callback([&](std::span<const Token> tokens) {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            sizes.push_back(tokens.size());
+            for (const Token& t : tokens) {
+                sequences.push_back(t.sequence_id);
+                emitted_at.push_back(t.emit_ns);
+            }
+        }
+        // A slow consumer: ~20 tokens fall due during each call.
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    sim.stop();
+
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_FALSE(sizes.empty());
+    EXPECT_GT(*std::max_element(sizes.begin(), sizes.end()), 5u);
+    EXPECT_EQ(sequences.size(), sim.get_stats().tokens_emitted.load());
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        EXPECT_EQ(sequences[i], i);
+        EXPECT_GT(emitted_at[i], 0u);
+        if (i > 0) {
+            EXPECT_GE(emitted_at[i], emitted_at[i - 1]);   // per-token stamps kept
+        }
+    }
+}
+
 } // namespace
 } // namespace llmquant
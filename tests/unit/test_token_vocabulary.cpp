@@ -0,0 +1,195 @@
+#include "gtest/gtest.h"
+#include "TokenVocabulary.h"
+#include "LLMAdapter.h"
+#include "Deduplicator.h"
+#include "TokenStreamSimulator.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// TokenVocabulary
+// ---------------------------------------------------------------------------
+
+TEST(TokenVocabularyTest, test_vocabulary_assigns_dense_ids_in_first_seen_order) {
+    TokenVocabulary vocab;
+    EXPECT_EQ(vocab.intern("crash"), 0u);
+    EXPECT_EQ(vocab.intern("rally"), 1u);
+    EXPECT_EQ(vocab.intern("crash"), 0u);
+    EXPECT_EQ(vocab.size(), 2u);
+    EXPECT_EQ(vocab.text(1), "rally");
+}
+
+TEST(TokenVocabularyTest, test_vocabulary_normalises_before_interning) {
+    TokenVocabulary vocab;
+    TokenId id = vocab.intern(" Bullish\n");
+    EXPECT_EQ(vocab.intern("bullish"), id);
+    EXPECT_EQ(vocab.find("BULLISH"), id);
+    EXPECT_EQ(vocab.text(id), "bullish");
+}
+
+TEST(TokenVocabularyTest, test_vocabulary_find_does_not_insert) {
+    TokenVocabulary vocab;
+    EXPECT_EQ(vocab.find("absent"), kInvalidTokenId);
+    EXPECT_EQ(vocab.size(), 0u);
+}
+
+TEST(TokenVocabularyTest, test_vocabulary_text_views_survive_growth) {
+    TokenVocabulary vocab;
+    TokenId first = vocab.intern("first");
+    std::string_view view = vocab.text(first);
+    const size_t n = TokenIdTable<std::string>::kChunkSize * 2 + 7;
+    for (size_t i = 0; i < n; ++i) vocab.intern("tok" + std::to_string(i));
+    EXPECT_EQ(view.data(), vocab.text(first).data());
+    EXPECT_EQ(view, "first");
+    EXPECT_EQ(vocab.text(static_cast<TokenId>(n)), "tok" + std::to_string(n - 1));
+}
+
+TEST(TokenVocabularyTest, test_vocabulary_concurrent_intern_agrees_on_ids) {
+    TokenVocabulary vocab;
+    const size_t n_threads = 4, n_tokens = 2000;
+    std::vector<std::vector<TokenId>> seen(n_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < n_tokens; ++i) {
+                seen[t].push_back(vocab.intern("word" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(vocab.size(), n_tokens);
+    for (size_t t = 1; t < n_threads; ++t) EXPECT_EQ(seen[t], seen[0]);
+    for (size_t i = 0; i < n_tokens; ++i) {
+        EXPECT_EQ(vocab.text(seen[0][i]), "word" + std::to_string(i));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// LLMAdapter ID path
+// ---------------------------------------------------------------------------
+
+TEST(TokenVocabularyTest, test_llm_adapter_map_token_id_matches_text_lookup) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    for (const char* tok : {"crash", " Bullish", "unknown_word", "RALLY"}) {
+        SemanticWeight by_text = adapter.map_token_to_weight(tok);
+        SemanticWeight by_id   = adapter.map_token_id(vocab->intern(tok));
+        EXPECT_DOUBLE_EQ(by_id.sentiment_score,  by_text.sentiment_score)  << tok;
+        EXPECT_DOUBLE_EQ(by_id.confidence_score, by_text.confidence_score) << tok;
+        EXPECT_DOUBLE_EQ(by_id.volatility_score, by_text.volatility_score) << tok;
+        EXPECT_DOUBLE_EQ(by_id.directional_bias, by_text.directional_bias) << tok;
+    }
+}
+
+TEST(TokenVocabularyTest, test_llm_adapter_map_token_id_sees_dictionary_updates) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter adapter;
+    adapter.bind_vocabulary(vocab);
+    TokenId id = vocab->intern("moonshot");
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(id).directional_bias, 0.0);
+
+    adapter.add_token_mapping("moonshot", {0.9, 0.9, 0.5, 0.9});
+    EXPECT_DOUBLE_EQ(adapter.map_token_id(id).directional_bias, 0.9);
+}
+
+TEST(TokenVocabularyTest, test_llm_adapter_map_token_id_without_vocabulary_throws) {
+    LLMAdapter adapter;
+    EXPECT_THROW(adapter.map_token_id(0), std::logic_error);
+}
+
+// ---------------------------------------------------------------------------
+// Deduplicator ID path
+// ---------------------------------------------------------------------------
+
+TEST(TokenVocabularyTest, test_in_process_dedup_by_id_detects_duplicates) {
+    InProcessDeduplicator dedup;
+    const auto ttl = std::chrono::milliseconds{5000};
+    EXPECT_EQ(dedup.check_and_register_id(3, "x", ttl), DedupResult::Novel);
+    EXPECT_EQ(dedup.check_and_register_id(3, "x", ttl), DedupResult::Duplicate);
+    EXPECT_EQ(dedup.check_and_register_id(4, "y", ttl), DedupResult::Novel);
+    EXPECT_EQ(dedup.size(), 2u);
+
+    dedup.evict_id(3, "x");
+    EXPECT_EQ(dedup.size(), 1u);
+    EXPECT_EQ(dedup.check_and_register_id(3, "x", ttl), DedupResult::Novel);
+}
+
+TEST(TokenVocabularyTest, test_in_process_dedup_by_id_expires_and_purges) {
+    InProcessDeduplicator dedup;
+    EXPECT_EQ(dedup.check_and_register_id(0, "a", std::chrono::milliseconds{1}),
+              DedupResult::Novel);
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    dedup.purge_expired();
+    EXPECT_EQ(dedup.size(), 0u);
+    EXPECT_EQ(dedup.check_and_register_id(0, "a", std::chrono::milliseconds{5000}),
+              DedupResult::Novel);
+}
+
+TEST(TokenVocabularyTest, test_in_process_dedup_invalid_id_falls_back_to_text_key) {
+    InProcessDeduplicator dedup;
+    const auto ttl = std::chrono::milliseconds{5000};
+    // An un-interned token must not size the ID array from its ID.
+    EXPECT_EQ(dedup.check_and_register_id(kInvalidTokenId, "rally", ttl), DedupResult::Novel);
+    EXPECT_EQ(dedup.check_and_register_id(kInvalidTokenId, "rally", ttl), DedupResult::Duplicate);
+    EXPECT_EQ(dedup.check_and_register_id(kInvalidTokenId, "dump", ttl), DedupResult::Novel);
+    EXPECT_EQ(dedup.size(), 2u);
+    dedup.evict_id(kInvalidTokenId, "rally");
+    EXPECT_EQ(dedup.check_and_register_id(kInvalidTokenId, "rally", ttl), DedupResult::Novel);
+
+    // Large in-range IDs allocate one chunk, not everything below them.
+    const auto big = static_cast<TokenId>(TokenIdTable<int>::kCapacity - 1);
+    EXPECT_EQ(dedup.check_and_register_id(big, "rare", ttl), DedupResult::Novel);
+    EXPECT_EQ(dedup.check_and_register_id(big, "rare", ttl), DedupResult::Duplicate);
+    dedup.purge_expired();
+    EXPECT_EQ(dedup.size(), 3u);
+}
+
+TEST(TokenVocabularyTest, test_redis_dedup_by_id_falls_back_to_text_key) {
+    RedisDeduplicator dedup("redis://127.0.0.1:1");
+    const auto ttl = std::chrono::milliseconds{5000};
+    EXPECT_EQ(dedup.check_and_register_id(7, "bullish", ttl), DedupResult::Novel);
+    // Keyed on content: a different ID with the same text is a duplicate.
+    EXPECT_EQ(dedup.check_and_register_id(8, "bullish", ttl), DedupResult::Duplicate);
+}
+
+// ---------------------------------------------------------------------------
+// Simulator
+// ---------------------------------------------------------------------------
+
+TEST(TokenVocabularyTest, test_simulator_tokens_carry_shared_vocabulary_ids) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    TokenStreamSimulator sim({std::chrono::microseconds{100}, 64, true, ""});
+    sim.set_vocabulary(vocab);
+
+    std::mutex mu;
+    std::vector<std::pair<std::string, TokenId>> received;
+    sim.set_token_callback([&](const Token& tok) {
+        std::lock_guard<std::mutex> lk(mu);
+        received.emplace_back(tok.text, tok.token_id);
+    });
+    sim.load_tokens_from_memory({"Crash", "rally", "crash"});
+    sim.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds{30});
+    sim.stop();
+
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_FALSE(received.empty());
+    EXPECT_EQ(vocab->size(), 2u);
+    for (const auto& [text, id] : received) {
+        EXPECT_EQ(vocab->find(text), id) << text;
+    }
+}
+
+} // namespace
+} // namespace llmquant
@@ -1,10 +1,13 @@
 #include "gtest/gtest.h"
 #include "TradeSignalEngine.h"
 #include "LLMAdapter.h"
+#include "ExpDecay.h"
+#include "WeightFunnel.h"
 
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -198,5 +201,179 @@ TEST(TradeSignalEngineTest, test_trade_signal_engine_confidence_reflects_input_w
         << "signal.confidence must reflect the confidence_score of the processed weight";
 }
 
+// ---------------------------------------------------------------------------
+// Elapsed-time decay
+// ---------------------------------------------------------------------------
+
+TEST(TradeSignalEngineTest, test_exp_decay_table_matches_exp) {
+    const ExpDecay decay(std::chrono::milliseconds{250});
+    for (int64_t dt_ns = 1; dt_ns < 4'000'000'000; dt_ns = dt_ns * 3 + 7) {
+        const double expected = std::exp(-static_cast<double>(dt_ns) / 250e6);
+        EXPECT_NEAR(decay.factor(dt_ns), expected, expected * 1e-8) << "dt_ns=" << dt_ns;
+    }
+    EXPECT_DOUBLE_EQ(decay.factor(0), 1.0);
+    EXPECT_DOUBLE_EQ(decay.factor(-5), 1.0);
+    EXPECT_DOUBLE_EQ(decay.factor(std::chrono::seconds{5}), 0.0);   // 20 τ
+
+    const ExpDecay disabled;
+    EXPECT_FALSE(disabled.enabled());
+    EXPECT_DOUBLE_EQ(disabled.factor(1'000'000'000), 1.0);
+    EXPECT_FALSE(ExpDecay(std::chrono::nanoseconds{0}).enabled());
+}
+
+TEST(TradeSignalEngineTest, test_trade_signal_engine_time_decay_is_independent_of_token_rate) {
+    // The same burst of sentiment followed by one second of neutral tokens
+    // must decay to the same level at 30 tok/s and at 10,000 tok/s.
+    auto run = [](int tokens_per_second) {
+        auto clock = std::make_shared<ManualClock>();
+        TradeSignalEngine::Config cfg = make_config();
+        cfg.decay_time_constant = std::chrono::milliseconds{500};
+        TradeSignalEngine engine(cfg, clock);
+        engine.set_backtest_mode(true);
+        TradeSignal last;
+        engine.set_signal_callback([&last](const TradeSignal& s) { last = s; });
+
+        engine.process_semantic_weight(SemanticWeight{0.5, 0.8, 0.0, 0.5});   // bias 0.4
+        const int64_t step_ns = 1'000'000'000 / tokens_per_second;
+        for (int i = 0; i < tokens_per_second; ++i) {
+            clock->advance(std::chrono::nanoseconds{step_ns});
+            engine.process_semantic_weight(SemanticWeight{0.0, 0.5, 0.0, 0.0});
+        }
+        return last.delta_bias_shift;
+    };
+
+    const double expected = 0.4 * std::exp(-2.0);   // one second = 2 τ
+    EXPECT_NEAR(run(30), expected, 1e-6);
+    EXPECT_NEAR(run(10'000), expected, 1e-6);
+}
+
+TEST(TradeSignalEngineTest, test_trade_signal_engine_ewmas_track_three_horizons) {
+    auto clock = std::make_shared<ManualClock>();
+    TradeSignalEngine::Config cfg = make_config(1.0, 1.0, 1.0);
+    cfg.ewma_fast   = std::chrono::milliseconds{10};
+    cfg.ewma_medium = std::chrono::milliseconds{100};
+    cfg.ewma_slow   = std::chrono::milliseconds{1000};
+    TradeSignalEngine engine(cfg, clock);
+    engine.set_backtest_mode(true);
+    TradeSignal last;
+    engine.set_signal_callback([&last](const TradeSignal& s) { last = s; });
+
+    // 50 ms of steady bullish contribution (0.5) every millisecond.
+    for (int i = 0; i < 50; ++i) {
+        clock->advance(std::chrono::milliseconds{1});
+        engine.process_semantic_weight(SemanticWeight{0.5, 1.0, 0.0, 0.5});
+    }
+    EXPECT_NEAR(last.bias_ewma_fast, 0.5 * (1.0 - std::exp(-5.0)), 1e-3);
+    EXPECT_NEAR(last.bias_ewma_medium, 0.5 * (1.0 - std::exp(-0.5)), 1e-3);
+    EXPECT_NEAR(last.bias_ewma_slow, 0.5 * (1.0 - std::exp(-0.05)), 1e-3);
+    EXPECT_GT(last.bias_ewma_fast, last.bias_ewma_medium);
+    EXPECT_GT(last.bias_ewma_medium, last.bias_ewma_slow);
+}
+
+// ---------------------------------------------------------------------------
+// Single-writer state
+// ---------------------------------------------------------------------------
+
+TEST(TradeSignalEngineTest, test_trade_signal_engine_snapshot_reflects_latest_weight) {
+    auto clock = std::make_shared<ManualClock>();
+    TradeSignalEngine engine(make_config(1.0, 1.0, 1.0, 1000), clock);
+    EXPECT_EQ(engine.snapshot().weights_processed, 0u);
+
+    clock->advance(std::chrono::milliseconds{3});
+    engine.process_semantic_weight(SemanticWeight{0.2, 0.5, 0.4, 0.2});
+    const TradeSignalEngine::Snapshot s = engine.snapshot();
+    EXPECT_EQ(s.weights_processed, 1u);
+    EXPECT_DOUBLE_EQ(s.accumulated_bias, 0.1);
+    EXPECT_DOUBLE_EQ(s.accumulated_volatility, 0.2);
+    EXPECT_DOUBLE_EQ(s.last_confidence, 0.5);
+    EXPECT_EQ(s.timestamp_ns, 3'000'000u);
+}
+
+TEST(TradeSignalEngineTest, test_trade_signal_engine_monitor_reads_consistent_snapshots) {
+    // Volatility contribution is exactly twice the bias contribution, so any
+    // snapshot mixing two updates would break vol == 2 * bias.
+    TradeSignalEngine engine(make_config(1.0, 1.0, 1.0, 1'000'000));
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> inconsistent{0};
+    std::atomic<uint64_t> reads{0};
+
+    std::thread monitor([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            const TradeSignalEngine::Snapshot s = engine.snapshot();
+            const double expected_conf = (s.weights_processed % 2 == 1) ? 1.0 : 0.5;
+            if (s.accumulated_volatility != 2.0 * s.accumulated_bias ||
+                (s.weights_processed > 0 && s.last_confidence != expected_conf)) {
+                inconsistent.fetch_add(1);
+            }
+            reads.fetch_add(1);
+            std::this_thread::yield();
+        }
+    });
+
+    for (int i = 1; i <= 100'000; ++i) {
+        const double conf = (i % 2 == 1) ? 1.0 : 0.5;
+        engine.process_semantic_weight(SemanticWeight{0.0, conf, 0.00002, 0.00001});
+    }
+    done.store(true, std::memory_order_release);
+    monitor.join();
+
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(inconsistent.load(), 0u);
+    EXPECT_EQ(engine.snapshot().weights_processed, 100'000u);
+}
+
+TEST(TradeSignalEngineTest, test_weight_funnel_serialises_producers_without_losing_updates) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 2000;
+    // Decay 1.0 and a long cooldown: the accumulator is an exact running sum.
+    TradeSignalEngine engine(make_config(1.0, 1.0, 1.0, 10'000'000));
+    {
+        WeightFunnel funnel(engine, 256, OverflowPolicy::Block);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&funnel] {
+                for (int i = 0; i < kPerProducer; ++i) {
+                    EXPECT_TRUE(funnel.submit(SemanticWeight{0.0, 1.0, 0.0, 0.0001}));
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        funnel.close();
+        EXPECT_EQ(funnel.dropped(), 0u);
+        EXPECT_FALSE(funnel.submit(SemanticWeight{}));   // closed
+    }
+
+    const TradeSignalEngine::Snapshot s = engine.snapshot();
+    EXPECT_EQ(s.weights_processed, static_cast<uint64_t>(kProducers * kPerProducer));
+    EXPECT_NEAR(s.accumulated_bias, 0.0001 * kProducers * kPerProducer, 1e-9);
+}
+
+TEST(TradeSignalEngineTest, test_weight_funnel_processes_every_accepted_weight_when_closed_mid_stream) {
+    constexpr int kProducers = 4;
+    for (int round = 0; round < 20; ++round) {
+        TradeSignalEngine engine(make_config(1.0, 1.0, 1.0, 10'000'000));
+        std::atomic<uint64_t> accepted{0};
+        {
+            WeightFunnel funnel(engine, 64, OverflowPolicy::Block);
+            std::atomic<bool> go{false};
+            std::vector<std::thread> producers;
+            for (int p = 0; p < kProducers; ++p) {
+                producers.emplace_back([&] {
+                    while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                    while (funnel.submit(SemanticWeight{0.0, 1.0, 0.0, 0.0001})) {
+                        accepted.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+            }
+            go.store(true, std::memory_order_release);
+            std::this_thread::sleep_for(std::chrono::microseconds(200 * (round % 5)));
+            funnel.close();   // producers are still submitting
+            for (auto& t : producers) t.join();
+        }
+        // Every submit() that returned true reached the engine.
+        EXPECT_EQ(engine.snapshot().weights_processed, accepted.load()) << "round " << round;
+    }
+}
+
 } // namespace
 } // namespace llmquant
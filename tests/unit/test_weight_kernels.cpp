@@ -0,0 +1,181 @@
+#include "gtest/gtest.h"
+#include "WeightKernels.h"
+#include "LLMAdapter.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llmquant {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+struct Columns {
+    std::vector<double> sentiment, confidence, volatility, bias;
+
+    explicit Columns(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            sentiment.push_back(0.01 * static_cast<double>((i * 37) % 200) - 1.0);
+            confidence.push_back(0.1 + 0.01 * static_cast<double>((i * 13) % 90));
+            volatility.push_back(0.005 * static_cast<double>((i * 29) % 200));
+            bias.push_back(0.01 * static_cast<double>((i * 53) % 200) - 1.0);
+        }
+    }
+
+    WeightColumns view() const {
+        return {sentiment.data(), confidence.data(), volatility.data(), bias.data(),
+                sentiment.size()};
+    }
+};
+
+static WeightSums reference_sums(const WeightColumns& w) {
+    WeightSums r;
+    for (size_t i = 0; i < w.n; ++i) {
+        r.confidence += w.confidence[i];
+        r.sentiment  += w.sentiment[i]  * w.confidence[i];
+        r.volatility += w.volatility[i] * w.confidence[i];
+        r.bias       += w.bias[i]       * w.confidence[i];
+    }
+    return r;
+}
+
+static void expect_sums_near(const WeightSums& a, const WeightSums& b, size_t n) {
+    EXPECT_NEAR(a.confidence, b.confidence, 1e-9) << "n=" << n;
+    EXPECT_NEAR(a.sentiment,  b.sentiment,  1e-9) << "n=" << n;
+    EXPECT_NEAR(a.volatility, b.volatility, 1e-9) << "n=" << n;
+    EXPECT_NEAR(a.bias,       b.bias,       1e-9) << "n=" << n;
+}
+
+static std::vector<QuantizedWeight> quantize_columns(const Columns& cols) {
+    std::vector<QuantizedWeight> packed;
+    for (size_t i = 0; i < cols.sentiment.size(); ++i) {
+        packed.push_back(quantize_weight({cols.sentiment[i], cols.confidence[i],
+                                          cols.volatility[i], cols.bias[i]}));
+    }
+    return packed;
+}
+
+static void expect_sums_equal(const WeightSums& a, const WeightSums& b, size_t n) {
+    EXPECT_EQ(a.confidence, b.confidence) << "n=" << n;
+    EXPECT_EQ(a.sentiment,  b.sentiment)  << "n=" << n;
+    EXPECT_EQ(a.volatility, b.volatility) << "n=" << n;
+    EXPECT_EQ(a.bias,       b.bias)       << "n=" << n;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST(WeightKernelsTest, test_sse2_kernel_matches_scalar_across_lengths) {
+    for (size_t n = 0; n < 70; ++n) {
+        Columns cols(n);
+        expect_sums_near(accumulate_weights_sse2(cols.view()), reference_sums(cols.view()), n);
+    }
+}
+
+TEST(WeightKernelsTest, test_avx2_kernel_matches_scalar_across_lengths) {
+    if (detect_simd_level() != SimdLevel::AVX2_FMA) {
+        GTEST_SKIP() << "CPU lacks AVX2+FMA";
+    }
+    for (size_t n = 0; n < 70; ++n) {
+        Columns cols(n);
+        expect_sums_near(accumulate_weights_avx2(cols.view()), reference_sums(cols.view()), n);
+    }
+}
+
+TEST(WeightKernelsTest, test_dispatch_matches_scalar) {
+    Columns cols(1001);
+    expect_sums_near(accumulate_weights(cols.view()), reference_sums(cols.view()), 1001);
+}
+
+TEST(WeightKernelsTest, test_map_sequence_simd_spans_multiple_chunks) {
+    LLMAdapter adapter;
+    const std::vector<std::string> vocab{"crash", "Bullish ", "unknown_xyz", "rally", " panic"};
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < 203; ++i) tokens.push_back(vocab[(i * 3) % vocab.size()]);
+
+    SemanticWeight scalar = adapter.map_sequence_to_weight(tokens);
+    SemanticWeight simd   = adapter.map_sequence_simd(tokens);
+    EXPECT_NEAR(simd.sentiment_score,  scalar.sentiment_score,  1e-9);
+    EXPECT_NEAR(simd.confidence_score, scalar.confidence_score, 1e-9);
+    EXPECT_NEAR(simd.volatility_score, scalar.volatility_score, 1e-9);
+    EXPECT_NEAR(simd.directional_bias, scalar.directional_bias, 1e-9);
+}
+
+TEST(WeightKernelsTest, test_quantize_roundtrip_error_bounded) {
+    const double bound = 0.5 / kQuantScale + 1e-12;
+    for (int i = -1000; i <= 1000; ++i) {
+        const double x = i / 1000.0;
+        const SemanticWeight w = dequantize_weight(quantize_weight({x, -x, x / 3.0, x * x}));
+        EXPECT_NEAR(w.sentiment_score,  x,      bound);
+        EXPECT_NEAR(w.confidence_score, -x,     bound);
+        EXPECT_NEAR(w.volatility_score, x / 3.0, bound);
+        EXPECT_NEAR(w.directional_bias, x * x,  bound);
+    }
+    const QuantizedWeight clamped = quantize_weight({2.0, -7.5, 1.0, -1.0});
+    EXPECT_EQ(clamped.sentiment, 32767);
+    EXPECT_EQ(clamped.confidence, -32767);
+    EXPECT_EQ(clamped.volatility, 32767);
+    EXPECT_EQ(clamped.bias, -32767);
+}
+
+TEST(WeightKernelsTest, test_quantized_kernels_agree_exactly) {
+    for (size_t n = 0; n < 70; ++n) {
+        const auto packed = quantize_columns(Columns(n));
+        const WeightSums sse2 = accumulate_quantized_sse2(packed.data(), n);
+        expect_sums_equal(accumulate_quantized(packed.data(), n), sse2, n);
+        if (detect_simd_level() == SimdLevel::AVX2_FMA) {
+            expect_sums_equal(accumulate_quantized_avx2(packed.data(), n), sse2, n);
+        }
+    }
+}
+
+TEST(WeightKernelsTest, test_quantized_kernel_matches_full_precision) {
+    Columns cols(1001);
+    const auto packed = quantize_columns(cols);
+    const WeightSums q = accumulate_quantized(packed.data(), packed.size());
+    const WeightSums f = reference_sums(cols.view());
+    // Per-element error is below 2 * 0.5 / 32767 on each product.
+    const double tol = 1001 * 2.0 / kQuantScale;
+    EXPECT_NEAR(q.confidence, f.confidence, tol);
+    EXPECT_NEAR(q.sentiment,  f.sentiment,  tol);
+    EXPECT_NEAR(q.volatility, f.volatility, tol);
+    EXPECT_NEAR(q.bias,       f.bias,       tol);
+}
+
+TEST(WeightKernelsTest, test_map_id_sequence_int16_matches_full) {
+    auto vocab = std::make_shared<TokenVocabulary>();
+    LLMAdapter full;
+    LLMAdapter compact(LLMAdapter::WeightStorage::Int16);
+    full.bind_vocabulary(vocab);
+    compact.bind_vocabulary(vocab);
+    EXPECT_EQ(compact.weight_storage(), LLMAdapter::WeightStorage::Int16);
+
+    const std::vector<std::string> words{"crash", "bullish", "unknown_xyz", "rally", "panic"};
+    std::vector<TokenId> ids;
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < 203; ++i) {
+        texts.push_back(words[(i * 3) % words.size()]);
+        ids.push_back(vocab->intern(texts.back()));
+    }
+
+    const SemanticWeight by_text = full.map_sequence_simd(texts);
+    const SemanticWeight a = full.map_id_sequence(ids);
+    const SemanticWeight b = compact.map_id_sequence(ids);
+    EXPECT_NEAR(a.sentiment_score,  by_text.sentiment_score,  1e-9);
+    EXPECT_NEAR(a.confidence_score, by_text.confidence_score, 1e-9);
+    EXPECT_NEAR(b.sentiment_score,  a.sentiment_score,  1e-4);
+    EXPECT_NEAR(b.confidence_score, a.confidence_score, 1e-4);
+    EXPECT_NEAR(b.volatility_score, a.volatility_score, 1e-4);
+    EXPECT_NEAR(b.directional_bias, a.directional_bias, 1e-4);
+
+    const SemanticWeight one = compact.map_token_id(vocab->intern("crash"));
+    EXPECT_NEAR(one.sentiment_score, -0.9, 0.5 / kQuantScale + 1e-12);
+    EXPECT_EQ(full.map_id_sequence({}).confidence_score, 0.0);
+}
+
+} // namespace
+} // namespace llmquant
@@ -0,0 +1,41 @@
+// Offline compiler: text sentiment dictionary -> memory-mappable binary lexicon.
+//
+// Usage: lexicon_compiler <input.txt> <output.lexb>
+//
+// The output can be used anywhere a dictionary path is accepted
+// (semantic_weights.dictionary_path, LLMAdapter::reload_sentiment_dictionary).
+
+#include "LexiconFile.h"
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+
+using namespace llmquant;
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.lexb>\n";
+        return 2;
+    }
+
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        const DictionaryEntries entries = read_text_dictionary(argv[1]);
+        write_binary_lexicon(argv[2], entries);
+        // Re-open the output so a bad write is caught here, not at load time.
+        const BinaryLexicon check = open_binary_lexicon(argv[2]);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Compiled " << check.tokens.size() << " tokens and "
+                  << check.phrases.size() << " phrases into " << argv[2] << " ("
+                  << std::filesystem::file_size(argv[2]) << " bytes, format v"
+                  << kBinaryLexiconVersion << ") in " << ms << " ms\n";
+    } catch (const std::exception& e) {
+        std::cerr << "lexicon_compiler: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}